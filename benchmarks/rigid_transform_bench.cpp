@@ -0,0 +1,231 @@
+/**
+ * @file
+ * Benchmarks of operations on rigid transforms stored as a quaternion and translation
+ * (RigidTransformQd), as a 4x4 matrix (RigidTransformMd) or as a 3x4 matrix
+ * (RigidTransformM34d)
+ */
+
+#include <benchmark/benchmark.h>
+#include "wave/geometry/geometry.hpp"
+#include "bechmark_helpers.hpp"
+
+/** Return a vector of random rigid transforms or twists */
+template <typename T>
+std::vector<T, Eigen::aligned_allocator<T>> randomObjects(int N) {
+    std::vector<T, Eigen::aligned_allocator<T>> v;
+    v.reserve(N);
+    for (auto i = N; i--;) {
+        v.push_back(T::Random());
+    }
+    return v;
+}
+
+// Exp map of a twist into a quaternion transform, as it was evaluated before it could be
+// evaluated directly: into a matrix transform, then converted
+void BM_expMapToCompactViaMatrix(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto xi = randomObjects<wave::Twistd>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const wave::RigidTransformMd m{exp(xi[i])};
+            const wave::RigidTransformQd result{m};
+
+            benchmark::DoNotOptimize(result.value().data());
+        }
+    }
+}
+
+void BM_expMapToCompact(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto xi = randomObjects<wave::Twistd>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const wave::RigidTransformQd result{exp(xi[i])};
+
+            benchmark::DoNotOptimize(result.value().data());
+            DEBUG_ASSERT_APPROX(wave::RigidTransformMd{exp(xi[i])}.value(),
+                                wave::RigidTransformMd{result}.value());
+        }
+    }
+}
+
+void BM_expMapToMatrix(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto xi = randomObjects<wave::Twistd>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const wave::RigidTransformMd result{exp(xi[i])};
+
+            benchmark::DoNotOptimize(result.value().data());
+        }
+    }
+}
+
+// Box-plus of a quaternion transform, evaluating the exp map through a matrix
+void BM_boxPlusCompactViaMatrix(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto T = randomObjects<wave::RigidTransformQd>(N);
+    const auto xi = randomObjects<wave::Twistd>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const wave::RigidTransformMd m{exp(xi[i])};
+            const wave::RigidTransformQd result{wave::RigidTransformQd{m} * T[i]};
+
+            benchmark::DoNotOptimize(result.value().data());
+        }
+    }
+}
+
+void BM_boxPlusCompact(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto T = randomObjects<wave::RigidTransformQd>(N);
+    const auto xi = randomObjects<wave::Twistd>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const wave::RigidTransformQd result{T[i] + xi[i]};
+
+            benchmark::DoNotOptimize(result.value().data());
+        }
+    }
+}
+
+template <typename Leaf>
+void BM_compose(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomObjects<Leaf>(N);
+    const auto b = randomObjects<Leaf>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const Leaf result{a[i] * b[i]};
+
+            benchmark::DoNotOptimize(result.value().data());
+        }
+    }
+}
+
+template <typename Leaf>
+void BM_inverse(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomObjects<Leaf>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const Leaf result{inverse(a[i])};
+
+            benchmark::DoNotOptimize(result.value().data());
+        }
+    }
+}
+
+template <typename Leaf>
+void BM_transform(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomObjects<Leaf>(N);
+    const auto p = randomObjects<wave::Translationd>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const wave::Translationd result{a[i] * p[i]};
+
+            benchmark::DoNotOptimize(result.value().data());
+        }
+    }
+}
+
+template <typename Leaf>
+void BM_composeWithJacobians(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomObjects<Leaf>(N);
+    const auto b = randomObjects<Leaf>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto result = (a[i] * inverse(b[i])).evalWithJacobians(a[i], b[i]);
+
+            benchmark::DoNotOptimize(std::get<0>(result).value().data());
+            benchmark::DoNotOptimize(std::get<2>(result).data());
+        }
+    }
+}
+
+template <int I>
+struct FrameN;
+
+// Reverse-mode Jacobians of a chain of compositions, wrt each transform. The chain is
+// grouped from the right, so each step multiplies the adjoint of the result by the
+// adjoint of a transform. Each transform has distinct frames, for a tree of unique leaves.
+template <template <typename, typename> class LeafF>
+void BM_composeChainReverse(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto T0 = randomObjects<LeafF<FrameN<0>, FrameN<1>>>(N);
+    const auto T1 = randomObjects<LeafF<FrameN<1>, FrameN<2>>>(N);
+    const auto T2 = randomObjects<LeafF<FrameN<2>, FrameN<3>>>(N);
+    const auto T3 = randomObjects<LeafF<FrameN<3>, FrameN<4>>>(N);
+    const auto T4 = randomObjects<LeafF<FrameN<4>, FrameN<5>>>(N);
+    const auto T5 = randomObjects<LeafF<FrameN<5>, FrameN<6>>>(N);
+    const auto T6 = randomObjects<LeafF<FrameN<6>, FrameN<7>>>(N);
+    const auto T7 = randomObjects<LeafF<FrameN<7>, FrameN<8>>>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto expr =
+              T0[i] * (T1[i] * (T2[i] * (T3[i] * (T4[i] * (T5[i] * (T6[i] * T7[i]))))));
+            const auto result = wave::internal::evaluateWithJacobiansInMode<
+              wave::internal::JacobianMode::Reverse>(
+              expr, T0[i], T1[i], T2[i], T3[i], T4[i], T5[i], T6[i], T7[i]);
+
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+// Compose a trajectory buffer of poses with one transform, in place. This reports the
+// bytes per pose, which bound the throughput of large buffers.
+template <typename Leaf>
+void BM_composeTrajectory(benchmark::State &state) {
+    const auto N = state.range(0);
+    auto poses = randomObjects<Leaf>(N);
+    const auto T = Leaf::Random();
+
+    for (auto _ : state) {
+        for (auto &pose : poses) {
+            pose = T * pose;
+        }
+        benchmark::DoNotOptimize(poses.data());
+    }
+    state.counters["bytes_per_pose"] = sizeof(Leaf);
+    state.SetBytesProcessed(state.iterations() * N * 2 * sizeof(Leaf));
+}
+
+const int reps = 1000;
+
+BENCHMARK(BM_expMapToCompactViaMatrix)->Arg(reps);
+BENCHMARK(BM_expMapToCompact)->Arg(reps);
+BENCHMARK(BM_expMapToMatrix)->Arg(reps);
+BENCHMARK(BM_boxPlusCompactViaMatrix)->Arg(reps);
+BENCHMARK(BM_boxPlusCompact)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_compose, wave::RigidTransformQd)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_compose, wave::RigidTransformMd)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_compose, wave::RigidTransformM34d)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_inverse, wave::RigidTransformQd)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_inverse, wave::RigidTransformMd)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_inverse, wave::RigidTransformM34d)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_transform, wave::RigidTransformQd)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_transform, wave::RigidTransformMd)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_transform, wave::RigidTransformM34d)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_composeWithJacobians, wave::RigidTransformQd)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_composeWithJacobians, wave::RigidTransformMd)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_composeWithJacobians, wave::RigidTransformM34d)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_composeChainReverse, wave::RigidTransformQFd)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_composeChainReverse, wave::RigidTransformMFd)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_composeTrajectory, wave::RigidTransformQd)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_composeTrajectory, wave::RigidTransformMd)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_composeTrajectory, wave::RigidTransformM34d)->Arg(1 << 20);
+
+WAVE_BENCHMARK_MAIN()
@@ -44,8 +44,8 @@ BENCHMARK_F(Imu, waveTyped)(benchmark::State &state) {
               inverse(meas_Rij[i] * exp(wg[i])) * inverse(R_i[i]) * R_j[i];
             const auto &expr = log(expr1);
 
-            auto [r, J1, J2, J_phi_i, J_phi_j] =
-              expr.evalWithJacobians(meas_Rij[i], wg[i], R_i[i], R_j[i]);
+            auto [r, J1, J2, J_phi_i, J_phi_j] = wave::internal::evaluateWithTypedJacobians(
+              expr, meas_Rij[i], wg[i], R_i[i], R_j[i]);
             benchmark::DoNotOptimize(r);
             benchmark::DoNotOptimize(J1);
             benchmark::DoNotOptimize(J2);
@@ -74,6 +74,33 @@ BENCHMARK_F(Imu, waveReverse)(benchmark::State &state) {
     }
 }
 
+// Reverse mode, skipping rewriteExpr(), to measure the effect of the rewrite rules
+BENCHMARK_F(Imu, waveReverseNoRewrite)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto &expr1 =
+              inverse(meas_Rij[i] * exp(wg[i])) * inverse(R_i[i]) * R_j[i];
+            const auto &expr = log(expr1);
+            using Derived = std::decay_t<decltype(expr)>;
+
+            const auto &prepared = wave::internal::PrepareExpr<Derived>::run(expr);
+            using ExprType = std::decay_t<decltype(prepared)>;
+            const wave::internal::Evaluator<ExprType> v_eval{prepared};
+            auto [r, J1, J2, J_phi_i, J_phi_j] =
+              wave::internal::evaluateWithReverseJacobiansImpl<
+                wave::internal::eval_with_reverse_jacobians_t<ExprType>,
+                ExprType>(v_eval,
+                          wave::internal::identity_t<ExprType>{},
+                          wave::tmp::make_index_sequence<4>{});
+            benchmark::DoNotOptimize(r);
+            benchmark::DoNotOptimize(J1);
+            benchmark::DoNotOptimize(J2);
+            benchmark::DoNotOptimize(J_phi_i);
+            benchmark::DoNotOptimize(J_phi_j);
+        }
+    }
+}
+
 BENCHMARK_F(Imu, waveUntyped)(benchmark::State &state) {
     for (auto _ : state) {
         for (auto i = N; i--;) {
@@ -92,6 +119,65 @@ BENCHMARK_F(Imu, waveUntyped)(benchmark::State &state) {
     }
 }
 
+// Forward mode, carrying the Jacobians wrt all four targets up the tree together. This
+// is what evalWithJacobians() and evaluateWithJacobians() choose for leaf targets.
+BENCHMARK_F(Imu, waveStacked)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto &expr1 =
+              inverse(meas_Rij[i] * exp(wg[i])) * inverse(R_i[i]) * R_j[i];
+            const auto &expr = log(expr1);
+
+            auto [r, J1, J2, J_phi_i, J_phi_j] = wave::internal::evaluateWithStackedJacobians(
+              expr, meas_Rij[i], wg[i], R_i[i], R_j[i]);
+            benchmark::DoNotOptimize(r);
+            benchmark::DoNotOptimize(J1);
+            benchmark::DoNotOptimize(J2);
+            benchmark::DoNotOptimize(J_phi_i);
+            benchmark::DoNotOptimize(J_phi_j);
+        }
+    }
+}
+
+// Forward mode, walking the tree once per target
+BENCHMARK_F(Imu, wavePerTarget)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto &expr1 =
+              inverse(meas_Rij[i] * exp(wg[i])) * inverse(R_i[i]) * R_j[i];
+            const auto &expr = log(expr1);
+
+            auto [r, J1, J2, J_phi_i, J_phi_j] = wave::internal::evaluateWithJacobiansImpl(
+              std::false_type{},
+              wave::internal::prepareEvaluatorTo<wave::internal::plain_output_t<
+                std::decay_t<decltype(expr)>>>(expr),
+              meas_Rij[i],
+              wg[i],
+              R_i[i],
+              R_j[i]);
+            benchmark::DoNotOptimize(r);
+            benchmark::DoNotOptimize(J1);
+            benchmark::DoNotOptimize(J2);
+            benchmark::DoNotOptimize(J_phi_i);
+            benchmark::DoNotOptimize(J_phi_j);
+        }
+    }
+}
+
+BENCHMARK_F(Imu, waveBatch)(benchmark::State &state) {
+    const auto factory = [](const auto &meas_Rij,
+                            const auto &wg,
+                            const auto &R_i,
+                            const auto &R_j) {
+        return log(inverse(meas_Rij * exp(wg)) * inverse(R_i) * R_j);
+    };
+    auto out = wave::evaluateBatchWithJacobians(factory, meas_Rij, wg, R_i, R_j);
+    for (auto _ : state) {
+        wave::evaluateBatchWithJacobiansTo(out, factory, meas_Rij, wg, R_i, R_j);
+        benchmark::DoNotOptimize(out);
+    }
+}
+
 Eigen::Matrix3d expMap(const Eigen::Vector3d &phi) {
     return evalImpl(wave::internal::expr<ExpMap>{}, wave::RelativeRotationd{phi}).value();
 }
@@ -0,0 +1,156 @@
+// Compares forward mode, reverse mode and the mode evalWithJacobians() selects, for
+// expressions and targets where each mode should win
+
+#include <benchmark/benchmark.h>
+
+#include "wave/geometry/geometry.hpp"
+#include "../bechmark_helpers.hpp"
+
+using wave::internal::JacobianMode;
+
+template <int I>
+struct FrameN;
+
+template <int I, int J>
+using RMFd = wave::RotationMFd<FrameN<I>, FrameN<J>>;
+
+template <int I, int J, int K>
+using TFd = wave::TranslationFd<FrameN<I>, FrameN<J>, FrameN<K>>;
+
+template <typename T>
+using EigenVector = std::vector<T, Eigen::aligned_allocator<T>>;
+
+struct FrameW;
+struct FrameI;
+struct FrameJ;
+
+struct Forward {
+    template <typename Expr, typename... Targets>
+    static auto run(const Expr &expr, const Targets &... targets) {
+        return wave::internal::evaluateWithJacobiansInMode<JacobianMode::Forward>(
+          expr, targets...);
+    }
+};
+
+struct Reverse {
+    template <typename Expr, typename... Targets>
+    static auto run(const Expr &expr, const Targets &... targets) {
+        return wave::internal::evaluateWithJacobiansInMode<JacobianMode::Reverse>(
+          expr, targets...);
+    }
+};
+
+struct Auto {
+    template <typename Expr, typename... Targets>
+    static auto run(const Expr &expr, const Targets &... targets) {
+        return expr.evalWithJacobians(targets...);
+    }
+};
+
+const int N = 100;
+
+// v0 = R1 * R2 * ... * R8 * v8
+struct Chain {
+    const EigenVector<RMFd<0, 1>> R1 = randomMatrices<RMFd<0, 1>>(N);
+    const EigenVector<RMFd<1, 2>> R2 = randomMatrices<RMFd<1, 2>>(N);
+    const EigenVector<RMFd<2, 3>> R3 = randomMatrices<RMFd<2, 3>>(N);
+    const EigenVector<RMFd<3, 4>> R4 = randomMatrices<RMFd<3, 4>>(N);
+    const EigenVector<RMFd<4, 5>> R5 = randomMatrices<RMFd<4, 5>>(N);
+    const EigenVector<RMFd<5, 6>> R6 = randomMatrices<RMFd<5, 6>>(N);
+    const EigenVector<RMFd<6, 7>> R7 = randomMatrices<RMFd<6, 7>>(N);
+    const EigenVector<RMFd<7, 8>> R8 = randomMatrices<RMFd<7, 8>>(N);
+    const EigenVector<TFd<8, 0, 1>> v8 = randomMatrices<TFd<8, 0, 1>>(N);
+
+    auto expr(int i) const {
+        return R1[i] * R2[i] * R3[i] * R4[i] * R5[i] * R6[i] * R7[i] * R8[i] * v8[i];
+    }
+};
+
+// The IMU preintegration residual of imu_preint.cpp
+struct Imu {
+    const EigenVector<wave::RotationMFd<FrameI, FrameJ>> meas_Rij =
+      randomMatrices<wave::RotationMFd<FrameI, FrameJ>>(N);
+    const EigenVector<wave::RotationMFd<FrameW, FrameI>> R_i =
+      randomMatrices<wave::RotationMFd<FrameW, FrameI>>(N);
+    const EigenVector<wave::RotationMFd<FrameW, FrameJ>> R_j =
+      randomMatrices<wave::RotationMFd<FrameW, FrameJ>>(N);
+    const EigenVector<wave::RelativeRotationFd<FrameJ, FrameJ, FrameJ>> wg =
+      randomMatrices<wave::RelativeRotationFd<FrameJ, FrameJ, FrameJ>>(N);
+
+    auto expr(int i) const {
+        return log(inverse(meas_Rij[i] * exp(wg[i])) * inverse(R_i[i]) * R_j[i]);
+    }
+};
+
+const Chain chain{};
+const Imu imu{};
+
+// The vector, one edge from the root
+template <typename Mode>
+void chainWrtVector(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            benchmark::DoNotOptimize(Mode::run(chain.expr(i), chain.v8[i]));
+        }
+    }
+}
+
+// The first rotation, at the bottom of the tree
+template <typename Mode>
+void chainWrtFirst(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            benchmark::DoNotOptimize(Mode::run(chain.expr(i), chain.R1[i]));
+        }
+    }
+}
+
+template <typename Mode>
+void chainWrtAll(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            benchmark::DoNotOptimize(Mode::run(chain.expr(i),
+                                               chain.R1[i],
+                                               chain.R2[i],
+                                               chain.R3[i],
+                                               chain.R4[i],
+                                               chain.R5[i],
+                                               chain.R6[i],
+                                               chain.R7[i],
+                                               chain.R8[i],
+                                               chain.v8[i]));
+        }
+    }
+}
+
+template <typename Mode>
+void imuWrtRj(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            benchmark::DoNotOptimize(Mode::run(imu.expr(i), imu.R_j[i]));
+        }
+    }
+}
+
+template <typename Mode>
+void imuWrtAll(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            benchmark::DoNotOptimize(
+              Mode::run(imu.expr(i), imu.meas_Rij[i], imu.wg[i], imu.R_i[i], imu.R_j[i]));
+        }
+    }
+}
+
+#define BENCHMARK_EACH_MODE(Func)      \
+    BENCHMARK_TEMPLATE(Func, Forward); \
+    BENCHMARK_TEMPLATE(Func, Reverse); \
+    BENCHMARK_TEMPLATE(Func, Auto)
+
+BENCHMARK_EACH_MODE(chainWrtVector);
+BENCHMARK_EACH_MODE(chainWrtFirst);
+BENCHMARK_EACH_MODE(chainWrtAll);
+BENCHMARK_EACH_MODE(imuWrtRj);
+BENCHMARK_EACH_MODE(imuWrtAll);
+
+WAVE_BENCHMARK_MAIN()
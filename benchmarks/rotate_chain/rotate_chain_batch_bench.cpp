@@ -0,0 +1,121 @@
+/**
+ * @file
+ * Compares evaluation of v2 = C1*C2*...*C10*v1 over many elements, stored either as
+ * vectors of leaves (array-of-structures) or as batches (structure-of-arrays).
+ *
+ * Only values are computed, not Jacobians.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "wave/geometry/batch.hpp"
+#include "../bechmark_helpers.hpp"
+
+template <typename T>
+using EigenVector = std::vector<T, Eigen::aligned_allocator<T>>;
+
+template <typename Leaf>
+class RotateChainBatch : public benchmark::Fixture {
+ protected:
+    const int N = 1024;
+    static constexpr int L = 10;
+
+    void SetUp(const benchmark::State &) override {
+        for (auto &R : this->Rs) {
+            R = randomMatrices<Leaf>(N);
+        }
+        v = randomMatrices<wave::Translationd>(N);
+    }
+
+    template <typename Batch>
+    std::array<Batch, L> rotationBatches() const {
+        std::array<Batch, L> batches;
+        for (int k = 0; k < L; ++k) {
+            batches[k].resize(N);
+            for (int i = 0; i < N; ++i) {
+                batches[k].set(i, this->Rs[k][i]);
+            }
+        }
+        return batches;
+    }
+
+    wave::TranslationBatchd translationBatch() const {
+        wave::TranslationBatchd batch{N};
+        for (int i = 0; i < N; ++i) {
+            batch.set(i, this->v[i]);
+        }
+        return batch;
+    }
+
+    std::array<EigenVector<Leaf>, L> Rs;
+    EigenVector<wave::Translationd> v;
+};
+
+using RotateChainBatchM = RotateChainBatch<wave::RotationMd>;
+using RotateChainBatchQ = RotateChainBatch<wave::RotationQd>;
+
+BENCHMARK_F(RotateChainBatchM, perElement)(benchmark::State &state) {
+    EigenVector<wave::Translationd> out(N);
+    for (auto _ : state) {
+        for (int i = 0; i < N; ++i) {
+            out[i] = Rs[0][i] * Rs[1][i] * Rs[2][i] * Rs[3][i] * Rs[4][i] * Rs[5][i] *
+                     Rs[6][i] * Rs[7][i] * Rs[8][i] * Rs[9][i] * v[i];
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK_F(RotateChainBatchM, batch)(benchmark::State &state) {
+    const auto R = rotationBatches<wave::RotationBatchd>();
+    const auto vb = translationBatch();
+    for (auto _ : state) {
+        const wave::TranslationBatchd out =
+          R[0] * R[1] * R[2] * R[3] * R[4] * R[5] * R[6] * R[7] * R[8] * R[9] * vb;
+        benchmark::DoNotOptimize(out.value().data());
+        benchmark::ClobberMemory();
+
+        DEBUG_ASSERT_APPROX((Rs[0][0] * Rs[1][0] * Rs[2][0] * Rs[3][0] * Rs[4][0] *
+                             Rs[5][0] * Rs[6][0] * Rs[7][0] * Rs[8][0] * Rs[9][0] * v[0])
+                              .eval(),
+                            out.get(0));
+    }
+}
+
+BENCHMARK_F(RotateChainBatchM, batchRightToLeft)(benchmark::State &state) {
+    const auto R = rotationBatches<wave::RotationBatchd>();
+    const auto vb = translationBatch();
+    for (auto _ : state) {
+        wave::TranslationBatchd out = R[9] * vb;
+        for (int k = L - 1; k-- > 0;) {
+            out = R[k] * out;
+        }
+        benchmark::DoNotOptimize(out.value().data());
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK_F(RotateChainBatchQ, perElement)(benchmark::State &state) {
+    EigenVector<wave::Translationd> out(N);
+    for (auto _ : state) {
+        for (int i = 0; i < N; ++i) {
+            out[i] = Rs[0][i] * Rs[1][i] * Rs[2][i] * Rs[3][i] * Rs[4][i] * Rs[5][i] *
+                     Rs[6][i] * Rs[7][i] * Rs[8][i] * Rs[9][i] * v[i];
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK_F(RotateChainBatchQ, batch)(benchmark::State &state) {
+    const auto R = rotationBatches<wave::QuaternionBatchd>();
+    const auto vb = translationBatch();
+    for (auto _ : state) {
+        const wave::TranslationBatchd out =
+          R[0] * R[1] * R[2] * R[3] * R[4] * R[5] * R[6] * R[7] * R[8] * R[9] * vb;
+        benchmark::DoNotOptimize(out.value().data());
+        benchmark::ClobberMemory();
+    }
+}
+
+WAVE_BENCHMARK_MAIN()
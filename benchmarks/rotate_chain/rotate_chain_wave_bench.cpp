@@ -28,6 +28,27 @@ RMFd<I, J> randomRMFd() {
     return RMFd<I, J>::Random();
 };
 
+// Evaluates with forward-mode Jacobians, rewriting the expression as if only the value
+// were needed. The rotations are then applied to the vector one by one, right to left.
+template <typename Derived, typename... Targets>
+auto evalWithJacobiansRightToLeft(const Derived &expr, const Targets &... targets) {
+    using namespace wave::internal;
+    const auto &v_eval =
+      prepareEvaluatorTo<plain_output_t<Derived>, rewrite_for_value>(expr);
+    return std::make_tuple(prepareOutput(v_eval),
+                           evaluateOneJacobian(v_eval, getWrtTarget(adl{}, targets))...);
+}
+
+// Evaluates the value, skipping rewriteExpr(). The rotations are then composed before
+// rotating the vector.
+template <typename Derived>
+auto evalAsWritten(const Derived &expr) {
+    using namespace wave::internal;
+    const auto &prepared = PrepareExpr<Derived>::run(expr);
+    using ExprType = std::decay_t<decltype(prepared)>;
+    return prepareOutput(Evaluator<ExprType>{prepared});
+}
+
 class RotateChain : public benchmark::Fixture {
  protected:
     const int N = 1;
@@ -238,4 +259,371 @@ BENCHMARK_F(RotateChain, wave10)(benchmark::State &state) {
     }
 }
 
+BENCHMARK_F(RotateChain, waveRightToLeft1)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R10[i] * v10[i], R10[i], v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft2)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R9[i] * R10[i] * v10[i],
+                                           R9[i],
+                                           R10[i],
+                                           v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft3)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R8[i] * R9[i] * R10[i] * v10[i],
+                                           R8[i],
+                                           R9[i],
+                                           R10[i],
+                                           v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft4)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R7[i] * R8[i] * R9[i] * R10[i] * v10[i],
+                                           R7[i],
+                                           R8[i],
+                                           R9[i],
+                                           R10[i],
+                                           v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft5)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R6[i] * R7[i] * R8[i] * R9[i] * R10[i] *
+                                           v10[i],
+                                           R6[i],
+                                           R7[i],
+                                           R8[i],
+                                           R9[i],
+                                           R10[i],
+                                           v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft6)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R5[i] * R6[i] * R7[i] * R8[i] * R9[i] *
+                                           R10[i] * v10[i],
+                                           R5[i],
+                                           R6[i],
+                                           R7[i],
+                                           R8[i],
+                                           R9[i],
+                                           R10[i],
+                                           v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft7)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R4[i] * R5[i] * R6[i] * R7[i] * R8[i] * R9[i] *
+                                           R10[i] * v10[i],
+                                           R4[i],
+                                           R5[i],
+                                           R6[i],
+                                           R7[i],
+                                           R8[i],
+                                           R9[i],
+                                           R10[i],
+                                           v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft8)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R3[i] * R4[i] * R5[i] * R6[i] * R7[i] * R8[i] *
+                                           R9[i] * R10[i] * v10[i],
+                                           R3[i],
+                                           R4[i],
+                                           R5[i],
+                                           R6[i],
+                                           R7[i],
+                                           R8[i],
+                                           R9[i],
+                                           R10[i],
+                                           v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft9)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R2[i] * R3[i] * R4[i] * R5[i] * R6[i] * R7[i] *
+                                           R8[i] * R9[i] * R10[i] * v10[i],
+                                           R2[i],
+                                           R3[i],
+                                           R4[i],
+                                           R5[i],
+                                           R6[i],
+                                           R7[i],
+                                           R8[i],
+                                           R9[i],
+                                           R10[i],
+                                           v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft10)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R1[i] * R2[i] * R3[i] * R4[i] * R5[i] * R6[i] *
+                                           R7[i] * R8[i] * R9[i] * R10[i] * v10[i],
+                                           R1[i],
+                                           R2[i],
+                                           R3[i],
+                                           R4[i],
+                                           R5[i],
+                                           R6[i],
+                                           R7[i],
+                                           R8[i],
+                                           R9[i],
+                                           R10[i],
+                                           v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValue1)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result = (R10[i] * v10[i]).eval();
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValue2)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result = (R9[i] * R10[i] * v10[i]).eval();
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValue3)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result = (R8[i] * R9[i] * R10[i] * v10[i]).eval();
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValue4)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result = (R7[i] * R8[i] * R9[i] * R10[i] * v10[i]).eval();
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValue5)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result = (R6[i] * R7[i] * R8[i] * R9[i] * R10[i] * v10[i]).eval();
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValue6)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              (R5[i] * R6[i] * R7[i] * R8[i] * R9[i] * R10[i] * v10[i]).eval();
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValue7)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              (R4[i] * R5[i] * R6[i] * R7[i] * R8[i] * R9[i] * R10[i] * v10[i]).eval();
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValue8)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              (R3[i] * R4[i] * R5[i] * R6[i] * R7[i] * R8[i] * R9[i] * R10[i] *
+               v10[i]).eval();
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValue9)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              (R2[i] * R3[i] * R4[i] * R5[i] * R6[i] * R7[i] * R8[i] * R9[i] * R10[i] *
+               v10[i]).eval();
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValue10)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              (R1[i] * R2[i] * R3[i] * R4[i] * R5[i] * R6[i] * R7[i] * R8[i] * R9[i] *
+               R10[i] * v10[i]).eval();
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValueAsWritten1)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result = evalAsWritten(R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValueAsWritten2)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result = evalAsWritten(R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValueAsWritten3)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result = evalAsWritten(R8[i] * R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValueAsWritten4)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result = evalAsWritten(R7[i] * R8[i] * R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValueAsWritten5)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalAsWritten(R6[i] * R7[i] * R8[i] * R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValueAsWritten6)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalAsWritten(R5[i] * R6[i] * R7[i] * R8[i] * R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValueAsWritten7)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalAsWritten(R4[i] * R5[i] * R6[i] * R7[i] * R8[i] * R9[i] * R10[i] *
+                            v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValueAsWritten8)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalAsWritten(R3[i] * R4[i] * R5[i] * R6[i] * R7[i] * R8[i] * R9[i] *
+                            R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValueAsWritten9)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalAsWritten(R2[i] * R3[i] * R4[i] * R5[i] * R6[i] * R7[i] * R8[i] *
+                            R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValueAsWritten10)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalAsWritten(R1[i] * R2[i] * R3[i] * R4[i] * R5[i] * R6[i] * R7[i] *
+                            R8[i] * R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
 WAVE_BENCHMARK_MAIN()
@@ -3,6 +3,7 @@
 #include "../bechmark_helpers.hpp"
 #include "wave/geometry/dynamic.hpp"
 #include "wave/geometry/geometry.hpp"
+#include "wave/geometry/parallel.hpp"
 
 template <typename T>
 using EigenVector = std::vector<T, Eigen::aligned_allocator<T>>;
@@ -25,6 +26,182 @@ void BM_waveAll(benchmark::State &state) {
     }
 }
 
+void BM_waveTape(benchmark::State &state) {
+    const auto N = state.range(0);
+    state.SetComplexityN(N);
+    // Produce the expression tree, and flatten it once
+    auto expr = makeProxy(wave::Translationd::Random());
+    for (auto i = N; i > 0; --i) {
+        expr = makeProxy(makeProxy(wave::RotationMd::Random()) * expr);
+    }
+    auto tape = wave::compile(expr);
+
+    for (auto _ : state) {
+        auto [res, jac_map] = tape.evaluateWithJacobians();
+
+        benchmark::DoNotOptimize(res);
+        benchmark::DoNotOptimize(jac_map);
+    }
+}
+
+void BM_waveTapeForward(benchmark::State &state) {
+    const auto N = state.range(0);
+    state.SetComplexityN(N);
+    // Produce the expression tree, referencing leaves which will change
+    EigenVector<wave::RotationMd> rotations(N);
+    auto expr = makeProxy(wave::Translationd::Random());
+    for (auto &R : rotations) {
+        R = wave::RotationMd::Random();
+        expr = makeProxy(R * expr);
+    }
+    auto tape = wave::compile(expr);
+
+    for (auto _ : state) {
+        // Change the leaf nearest the root
+        rotations.back() = wave::RotationMd::Random();
+        auto res = tape.evaluate();
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+void BM_waveTapeUpdate(benchmark::State &state) {
+    const auto N = state.range(0);
+    state.SetComplexityN(N);
+    // Produce the expression tree, referencing leaves which will change
+    EigenVector<wave::RotationMd> rotations(N);
+    auto expr = makeProxy(wave::Translationd::Random());
+    for (auto &R : rotations) {
+        R = wave::RotationMd::Random();
+        expr = makeProxy(R * expr);
+    }
+    auto tape = wave::compile(expr);
+    tape.update();
+
+    for (auto _ : state) {
+        // Change the leaf nearest the root, and re-evaluate only what depends on it
+        rotations.back() = wave::RotationMd::Random();
+        tape.markChanged(rotations.back());
+        auto res = tape.update();
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+void BM_waveDiamond(benchmark::State &state) {
+    const auto N = state.range(0);
+    state.SetComplexityN(N);
+    // Produce a graph of N nodes, each of which uses the one below it twice. Visiting
+    // each use separately would take 2^N steps.
+    auto shared = makeProxy(wave::RotationMd::Random());
+    for (auto i = N; i > 0; --i) {
+        shared = makeProxy(shared * shared);
+    }
+    const auto expr = makeProxy(shared * wave::Translationd::Random());
+
+    for (auto _ : state) {
+        auto [res, jac_map] = wave::internal::evaluateWithDynamicReverseJacobians(expr);
+
+        benchmark::DoNotOptimize(res);
+        benchmark::DoNotOptimize(jac_map);
+    }
+}
+
+void BM_waveParallel(benchmark::State &state) {
+    const auto num_threads = state.range(0);
+    // Produce many short residuals, which share a few rotations
+    EigenVector<wave::Proxy<wave::RotationMd>> rotations;
+    for (auto i = 0; i < 16; ++i) {
+        rotations.push_back(makeProxy(makeProxy(wave::RotationMd::Random()) *
+                                      makeProxy(wave::RotationMd::Random())));
+    }
+    EigenVector<wave::Proxy<wave::Translationd>> residuals;
+    for (auto i = 0; i < 4096; ++i) {
+        auto expr = makeProxy(wave::Translationd::Random());
+        for (auto j = 0; j < 8; ++j) {
+            expr = makeProxy(rotations[(i + j) % rotations.size()] * expr);
+        }
+        residuals.push_back(expr);
+    }
+    wave::ThreadPool pool{static_cast<std::size_t>(num_threads)};
+
+    for (auto _ : state) {
+        auto results = wave::evaluateParallelWithJacobians(pool, residuals);
+        benchmark::DoNotOptimize(results);
+    }
+}
+
+template <int Rows>
+void BM_waveStackedAdjoint(benchmark::State &state) {
+    const auto N = state.range(0);
+    state.SetComplexityN(N);
+    // Produce the expression tree
+    auto expr = makeProxy(wave::Translationd::Random());
+    for (auto i = N; i > 0; --i) {
+        expr = makeProxy(makeProxy(wave::RotationMd::Random()) * expr);
+    }
+    // Propagate an adjoint of several stacked rows, as for a weighted stack of residuals
+    const auto leaves = wave::internal::getLeavesMap(expr);
+    auto jac_map =
+      wave::MatrixMap<const void *, double>{leaves.begin(), leaves.end(), Rows};
+    const auto adjoint = Eigen::Matrix<double, Rows, 3>::Random().eval();
+    const wave::internal::Evaluator<wave::Proxy<wave::Translationd>> v_eval{expr};
+
+    for (auto _ : state) {
+        jac_map.setZero();
+        wave::internal::evaluateDynamicReverseJacobiansImpl(jac_map, v_eval, adjoint);
+        benchmark::DoNotOptimize(jac_map);
+    }
+}
+
+void BM_waveAllArena(benchmark::State &state) {
+    const auto N = state.range(0);
+    state.SetComplexityN(N);
+    // Produce the expression tree, with nodes placed contiguously in an arena
+    wave::ProxyArena arena;
+    auto expr = makeProxy(arena, wave::Translationd::Random());
+    for (auto i = N; i > 0; --i) {
+        expr = makeProxy(arena, makeProxy(arena, wave::RotationMd::Random()) * expr);
+    }
+
+    for (auto _ : state) {
+        auto [res, jac_map] = wave::internal::evaluateWithDynamicReverseJacobians(expr);
+
+        benchmark::DoNotOptimize(res);
+        benchmark::DoNotOptimize(jac_map);
+    }
+}
+
+void BM_buildHeap(benchmark::State &state) {
+    const auto N = state.range(0);
+    state.SetComplexityN(N);
+    const auto R = wave::RotationMd::Random();
+    const auto v = wave::Translationd::Random();
+
+    for (auto _ : state) {
+        auto expr = makeProxy(wave::Translationd{v});
+        for (auto i = N; i > 0; --i) {
+            expr = makeProxy(makeProxy(wave::RotationMd{R}) * expr);
+        }
+        benchmark::DoNotOptimize(expr);
+    }
+}
+
+void BM_buildArena(benchmark::State &state) {
+    const auto N = state.range(0);
+    state.SetComplexityN(N);
+    const auto R = wave::RotationMd::Random();
+    const auto v = wave::Translationd::Random();
+    wave::ProxyArena arena;
+
+    for (auto _ : state) {
+        auto expr = makeProxy(arena, wave::Translationd{v});
+        for (auto i = N; i > 0; --i) {
+            expr = makeProxy(arena, makeProxy(arena, wave::RotationMd{R}) * expr);
+        }
+        benchmark::DoNotOptimize(expr);
+        arena.clear();
+    }
+}
+
 void BM_dynamicNoVirtual(benchmark::State &state) {
     auto v = wave::Translationd::Random();
     std::array<wave::RotationMd, 10> R{};
@@ -46,6 +223,7 @@ void BM_dynamicNoVirtual(benchmark::State &state) {
 
 void BM_waveDynamicLeaves(benchmark::State &state) {
     const auto N = state.range(0);
+    state.SetComplexityN(N);
     // Produce the expression tree
     EigenVector<wave::Proxy<wave::RotationMd>> proxies;
     auto expr = makeProxy(wave::Translationd::Random());
@@ -55,14 +233,26 @@ void BM_waveDynamicLeaves(benchmark::State &state) {
     }
 
     for (auto _ : state) {
-        auto map = wave::internal::getLeavesMap(expr);
+        // Collect the leaves and index them, as a reverse pass does before accumulating
+        const auto leaves = wave::internal::getLeavesMap(expr);
+        auto map = wave::MatrixMap<const void *, double>{leaves.begin(), leaves.end(), 3};
         benchmark::DoNotOptimize(map);
     }
 }
 
-// BENCHMARK(BM_waveDynamicLeaves)->Range(10, 200000)->Complexity();
+BENCHMARK(BM_waveDynamicLeaves)->RangeMultiplier(2)->Range(8, 1 << 14)->Complexity();
 // BENCHMARK(BM_waveDynamic)->Arg(10);
 BENCHMARK(BM_waveAll)->RangeMultiplier(2)->DenseRange(1, 1 << 14)->Complexity();
+BENCHMARK(BM_waveTape)->RangeMultiplier(2)->Range(1, 1 << 14)->Complexity();
+BENCHMARK(BM_waveTapeForward)->RangeMultiplier(2)->Range(1, 1 << 14)->Complexity();
+BENCHMARK(BM_waveTapeUpdate)->RangeMultiplier(2)->Range(1, 1 << 14)->Complexity();
+BENCHMARK(BM_waveDiamond)->DenseRange(2, 16, 2)->Complexity();
+BENCHMARK(BM_waveParallel)->DenseRange(0, 4)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_waveStackedAdjoint, 9)->RangeMultiplier(4)->Range(1, 1 << 12);
+BENCHMARK_TEMPLATE(BM_waveStackedAdjoint, 15)->RangeMultiplier(4)->Range(1, 1 << 12);
+BENCHMARK(BM_waveAllArena)->RangeMultiplier(2)->Range(1, 1 << 14)->Complexity();
+BENCHMARK(BM_buildHeap)->RangeMultiplier(2)->Range(1, 1 << 14)->Complexity();
+BENCHMARK(BM_buildArena)->RangeMultiplier(2)->Range(1, 1 << 14)->Complexity();
 // BENCHMARK(BM_dynamicNoVirtual);
 
 WAVE_BENCHMARK_MAIN()
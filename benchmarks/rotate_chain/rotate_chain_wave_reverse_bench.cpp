@@ -28,6 +28,19 @@ RMFd<I, J> randomRMFd() {
     return RMFd<I, J>::Random();
 };
 
+// Evaluates with reverse-mode Jacobians, rewriting the expression as if only the value
+// were needed. The rotations are then applied to the vector one by one, right to left.
+template <typename Derived>
+auto evalWithJacobiansRightToLeft(const Derived &expr) {
+    using namespace wave::internal;
+    const auto &v_eval =
+      prepareEvaluatorTo<plain_output_t<Derived>, rewrite_for_value>(expr);
+    constexpr auto NumLeaves =
+      std::tuple_size<eval_with_reverse_jacobians_t<Derived>>{} - 1;
+    return evaluateWithReverseJacobiansImpl<eval_with_reverse_jacobians_t<Derived>, Derived>(
+      v_eval, identity_t<Derived>{}, wave::tmp::make_index_sequence<NumLeaves>{});
+}
+
 class RotateChain : public benchmark::Fixture {
  protected:
     const int N = 1;
@@ -221,4 +234,108 @@ BENCHMARK_F(RotateChain, wave10)(benchmark::State &state) {
     }
 }
 
+BENCHMARK_F(RotateChain, waveRightToLeft1)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result = evalWithJacobiansRightToLeft(R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft2)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result = evalWithJacobiansRightToLeft(R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft3)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R8[i] * R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft4)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R7[i] * R8[i] * R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft5)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R6[i] * R7[i] * R8[i] * R9[i] * R10[i] *
+                                           v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft6)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R5[i] * R6[i] * R7[i] * R8[i] * R9[i] *
+                                           R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft7)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R4[i] * R5[i] * R6[i] * R7[i] * R8[i] * R9[i] *
+                                           R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft8)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R3[i] * R4[i] * R5[i] * R6[i] * R7[i] * R8[i] *
+                                           R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft9)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R2[i] * R3[i] * R4[i] * R5[i] * R6[i] * R7[i] *
+                                           R8[i] * R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveRightToLeft10)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto &result =
+              evalWithJacobiansRightToLeft(R1[i] * R2[i] * R3[i] * R4[i] * R5[i] * R6[i] *
+                                           R7[i] * R8[i] * R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
 WAVE_BENCHMARK_MAIN()
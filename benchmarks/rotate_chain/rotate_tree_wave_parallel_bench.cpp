@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+
+#include "../bechmark_helpers.hpp"
+#include "wave/geometry/dynamic.hpp"
+#include "wave/geometry/geometry.hpp"
+#include "wave/geometry/parallel.hpp"
+
+// The rotate_chain example, with the N rotations composed as a balanced tree rather than
+// a chain, so that the two halves of each product can be evaluated in parallel:
+// v2 = ((C1*C2)*(C3*C4))*...*v1
+
+/** Builds a balanced tree of products of n random rotations */
+wave::Proxy<wave::RotationMd> makeBalancedTree(int64_t n) {
+    if (n == 1) {
+        return makeProxy(wave::RotationMd::Random());
+    }
+    const auto half = n / 2;
+    return makeProxy(makeBalancedTree(half) * makeBalancedTree(n - half));
+}
+
+void BM_waveTreeTape(benchmark::State &state) {
+    const auto N = state.range(0);
+    state.SetComplexityN(N);
+    const auto expr = makeProxy(makeBalancedTree(N) * wave::Translationd::Random());
+    auto tape = wave::compile(expr);
+
+    for (auto _ : state) {
+        auto [res, jac_map] = tape.evaluateWithJacobians();
+
+        benchmark::DoNotOptimize(res);
+        benchmark::DoNotOptimize(jac_map);
+    }
+}
+
+void BM_waveTreeParallel(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto num_threads = state.range(1);
+    const auto expr = makeProxy(makeBalancedTree(N) * wave::Translationd::Random());
+    wave::ThreadPool pool{static_cast<std::size_t>(num_threads)};
+    auto tape = wave::compileParallel(pool, expr);
+    state.counters["tasks"] = tape.numTasks();
+
+    for (auto _ : state) {
+        auto [res, jac_map] = tape.evaluateWithJacobians();
+
+        benchmark::DoNotOptimize(res);
+        benchmark::DoNotOptimize(jac_map);
+    }
+}
+
+// Compare BM_waveTreeParallel with k threads against BM_waveTreeTape for the speedup on
+// k + 1 cores (the calling thread also runs tasks)
+BENCHMARK(BM_waveTreeTape)->RangeMultiplier(4)->Range(1 << 8, 1 << 16)->Complexity();
+BENCHMARK(BM_waveTreeParallel)
+  ->ArgsProduct({benchmark::CreateRange(1 << 8, 1 << 16, 4), {0, 1, 3, 7, 15}})
+  ->UseRealTime();
+
+WAVE_BENCHMARK_MAIN()
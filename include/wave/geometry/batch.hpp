@@ -0,0 +1,33 @@
+/**
+ * @file Definitions of structure-of-arrays batch containers
+ */
+
+#ifndef WAVE_GEOMETRY_BATCH_HPP
+#define WAVE_GEOMETRY_BATCH_HPP
+
+#include "geometry.hpp"
+
+namespace wave {
+
+template <typename Scalar>
+class TranslationBatch;
+
+template <typename Scalar>
+class RotationBatch;
+
+template <typename Scalar>
+class QuaternionBatch;
+
+template <typename Scalar>
+class CompactRigidTransformBatch;
+
+}  // namespace wave
+
+#include "src/batch/BatchStorage.hpp"
+#include "src/batch/BatchKernels.hpp"
+#include "src/batch/TranslationBatch.hpp"
+#include "src/batch/RotationBatch.hpp"
+#include "src/batch/QuaternionBatch.hpp"
+#include "src/batch/CompactRigidTransformBatch.hpp"
+
+#endif  // WAVE_GEOMETRY_BATCH_HPP
@@ -7,10 +7,10 @@
 
 // For shared_ptr, used by Proxy
 #include <memory>
+// For vector, used by BatchJacobians
+#include <vector>
 // For optional, used by JacobianEvaluator
 #include <boost/optional.hpp>
-// Used by DynamicReverseJacobianEvaluator
-#include <boost/container/flat_map.hpp>
 
 // Tick library for traits checking
 #include <tick/trait_check.h>
@@ -23,6 +23,7 @@
 #include "src/util/meta/type_list.hpp"
 #include "src/util/math/math.hpp"
 #include "src/util/math/IdentityMatrix.hpp"
+#include "src/util/math/LeafRegistry.hpp"
 #include "src/util/math/MatrixMap.hpp"
 
 // Forward declarations and standalone type traits
@@ -35,13 +36,18 @@
 #include "src/core/functions/IsSameType.hpp"
 #include "src/core/functions/AddConversions.hpp"
 #include "src/core/functions/PrepareExpr.hpp"
+#include "src/core/functions/RewriteExpr.hpp"
 #include "src/core/functions/Evaluator.hpp"
 #include "src/core/functions/PrepareOutput.hpp"
 #include "src/core/functions/DynamicJacobianEvaluator.hpp"
+#include "src/core/functions/StackedJacobianEvaluator.hpp"
 #include "src/core/functions/JacobianEvaluator.hpp"
+#include "src/core/functions/TangentEvaluator.hpp"
 #include "src/core/functions/TypedJacobianEvaluator.hpp"
 #include "src/core/functions/ReverseJacobianEvaluator.hpp"
+#include "src/core/functions/AutoJacobianEvaluator.hpp"
 #include "src/core/functions/DynamicReverseJacobianEvaluator.hpp"
+#include "src/core/functions/BatchJacobianEvaluator.hpp"
 #include "src/core/functions/NumericalJacobian.hpp"
 
 // Storage and traits bases
@@ -5,8 +5,22 @@
 #ifndef WAVE_GEOMETRY_DYNAMIC_HPP
 #define WAVE_GEOMETRY_DYNAMIC_HPP
 
+// For uint64_t and uintptr_t, used by EvaluationContext
+#include <cstdint>
+
 #include "core.hpp"
 
+#ifndef WAVE_GEOMETRY_REVERSE_ROWS
+/** Heights of the adjoints which reverse-mode AD propagates through Dynamic nodes as
+ * fixed-size matrices
+ *
+ * An adjoint of another height, such as a stack of several residuals, is propagated as a
+ * dynamic-size matrix, which allocates at each node. Each height adds code for every
+ * Dynamic type. To change the list, define this macro before including this header.
+ */
+#define WAVE_GEOMETRY_REVERSE_ROWS 1, 2, 3, 6, 9, 15
+#endif
+
 namespace wave {
 
 template <typename Leaf>
@@ -21,11 +35,27 @@ class Proxy;
 template <typename Leaf>
 class RefProxy;
 
+template <typename Leaf>
+class Tape;
+
+template <typename Leaf>
+class ParallelTape;
+
+namespace internal {
+template <typename Scalar>
+struct TapeBuilder;
+template <typename Scalar>
+class EvaluationContext;
+}  // namespace internal
+
 }  // namespace wave
 
 #include "src/dynamic/DynamicBase.hpp"
 #include "src/dynamic/Dynamic.hpp"
+#include "src/dynamic/ProxyArena.hpp"
 #include "src/dynamic/Proxy.hpp"
 #include "src/dynamic/RefProxy.hpp"
+#include "src/dynamic/Tape.hpp"
+#include "src/dynamic/EvaluationContext.hpp"
 
 #endif  // WAVE_GEOMETRY_DYNAMIC_HPP
@@ -10,6 +10,7 @@
 #include "core.hpp"
 
 #include "src/util/math/CrossMatrix.hpp"
+#include "src/util/math/AdjointMatrix.hpp"
 
 #include "src/geometry/forward_declarations.hpp"
 #include "src/geometry/type_traits.hpp"
@@ -53,5 +54,6 @@
 #include "src/geometry/op/Product.hpp"
 #include "src/geometry/op/Divide.hpp"
 #include "src/geometry/op/Inverse.hpp"
+#include "src/geometry/op/RewriteRules.hpp"
 
 #endif  // WAVE_GEOMETRY_GEOMETRY_HPP
@@ -0,0 +1,24 @@
+/**
+ * @file Definitions of multithreaded evaluation
+ */
+
+#ifndef WAVE_GEOMETRY_PARALLEL_HPP
+#define WAVE_GEOMETRY_PARALLEL_HPP
+
+// For threads and synchronization, used by ThreadPool
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "dynamic.hpp"
+
+#include "src/parallel/ThreadPool.hpp"
+#include "src/parallel/ParallelEvaluator.hpp"
+#include "src/parallel/ParallelTape.hpp"
+
+#endif  // WAVE_GEOMETRY_PARALLEL_HPP
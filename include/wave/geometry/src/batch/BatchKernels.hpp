@@ -0,0 +1,166 @@
+/**
+ * @file
+ * Coefficient-wise kernels for structure-of-arrays batches.
+ *
+ * Each kernel operates on N*K arrays (or column blocks of them) holding one element per
+ * row. Every statement is an Eigen array expression over whole columns, which Eigen
+ * vectorizes across elements.
+ */
+
+#ifndef WAVE_GEOMETRY_BATCHKERNELS_HPP
+#define WAVE_GEOMETRY_BATCHKERNELS_HPP
+
+namespace wave {
+namespace internal {
+
+/** Number of elements processed by each pass of a batch kernel
+ *
+ * Kernels make several passes over their columns. Processing the batch in chunks keeps
+ * the working set of the passes in L1 cache.
+ */
+constexpr Eigen::Index BatchChunkSize = 128;
+
+/** Calls f(start, length) for consecutive chunks of a batch of n elements */
+template <typename F>
+WAVE_STRONG_INLINE void forEachBatchChunk(Eigen::Index n, F &&f) {
+    for (Eigen::Index start = 0; start < n; start += BatchChunkSize) {
+        f(start, std::min(BatchChunkSize, n - start));
+    }
+}
+
+/** Composes batches of column-major 3x3 rotation matrices: out = a * b */
+template <typename A, typename B, typename Out>
+void batchMatrixComposeChunk(const Eigen::ArrayBase<A> &a,
+                             const Eigen::ArrayBase<B> &b,
+                             const Eigen::ArrayBase<Out> &out_) {
+    auto &out = out_.const_cast_derived();
+    for (int c = 0; c < 3; ++c) {
+        for (int r = 0; r < 3; ++r) {
+            out.col(r + 3 * c) = a.col(r) * b.col(3 * c) +
+                                 a.col(r + 3) * b.col(3 * c + 1) +
+                                 a.col(r + 6) * b.col(3 * c + 2);
+        }
+    }
+}
+
+/** Rotates a batch of vectors by a batch of column-major 3x3 matrices: out = a * v */
+template <typename A, typename V, typename Out>
+void batchMatrixRotateChunk(const Eigen::ArrayBase<A> &a,
+                            const Eigen::ArrayBase<V> &v,
+                            const Eigen::ArrayBase<Out> &out_) {
+    auto &out = out_.const_cast_derived();
+    for (int r = 0; r < 3; ++r) {
+        out.col(r) =
+          a.col(r) * v.col(0) + a.col(r + 3) * v.col(1) + a.col(r + 6) * v.col(2);
+    }
+}
+
+/** Transposes a batch of column-major 3x3 matrices: out = a^T */
+template <typename A, typename Out>
+void batchMatrixTransposeChunk(const Eigen::ArrayBase<A> &a,
+                               const Eigen::ArrayBase<Out> &out_) {
+    auto &out = out_.const_cast_derived();
+    for (int c = 0; c < 3; ++c) {
+        for (int r = 0; r < 3; ++r) {
+            out.col(r + 3 * c) = a.col(c + 3 * r);
+        }
+    }
+}
+
+/** Composes batches of unit quaternions in (x, y, z, w) order: out = a * b */
+template <typename A, typename B, typename Out>
+void batchQuaternionComposeChunk(const Eigen::ArrayBase<A> &a,
+                                 const Eigen::ArrayBase<B> &b,
+                                 const Eigen::ArrayBase<Out> &out_) {
+    auto &out = out_.const_cast_derived();
+    const auto &ax = a.col(0), &ay = a.col(1), &az = a.col(2), &aw = a.col(3);
+    const auto &bx = b.col(0), &by = b.col(1), &bz = b.col(2), &bw = b.col(3);
+    out.col(0) = aw * bx + ax * bw + ay * bz - az * by;
+    out.col(1) = aw * by + ay * bw + az * bx - ax * bz;
+    out.col(2) = aw * bz + az * bw + ax * by - ay * bx;
+    out.col(3) = aw * bw - ax * bx - ay * by - az * bz;
+}
+
+/** Rotates a batch of vectors by a batch of unit quaternions: out = q * v
+ *
+ * Uses the same formula as Eigen: t = 2 (q_v x v); out = v + w t + q_v x t
+ */
+template <typename Q, typename V, typename Out>
+void batchQuaternionRotateChunk(const Eigen::ArrayBase<Q> &q,
+                                const Eigen::ArrayBase<V> &v,
+                                const Eigen::ArrayBase<Out> &out_) {
+    using Scalar = typename Q::Scalar;
+    auto &out = out_.const_cast_derived();
+    const auto &qx = q.col(0), &qy = q.col(1), &qz = q.col(2), &qw = q.col(3);
+    Eigen::Array<Scalar, Eigen::Dynamic, 3, 0, BatchChunkSize, 3> t{q.rows(), 3};
+    t.col(0) = Scalar{2} * (qy * v.col(2) - qz * v.col(1));
+    t.col(1) = Scalar{2} * (qz * v.col(0) - qx * v.col(2));
+    t.col(2) = Scalar{2} * (qx * v.col(1) - qy * v.col(0));
+    out.col(0) = v.col(0) + qw * t.col(0) + qy * t.col(2) - qz * t.col(1);
+    out.col(1) = v.col(1) + qw * t.col(1) + qz * t.col(0) - qx * t.col(2);
+    out.col(2) = v.col(2) + qw * t.col(2) + qx * t.col(1) - qy * t.col(0);
+}
+
+/** Conjugates a batch of quaternions in (x, y, z, w) order */
+template <typename A, typename Out>
+void batchQuaternionConjugateChunk(const Eigen::ArrayBase<A> &a,
+                                   const Eigen::ArrayBase<Out> &out_) {
+    auto &out = out_.const_cast_derived();
+    out.template leftCols<3>() = -a.template leftCols<3>();
+    out.col(3) = a.col(3);
+}
+
+/** Fixed-capacity buffer holding one chunk of a batch kernel's output */
+template <typename Out>
+using batch_chunk_buffer_t = Eigen::Array<typename Out::Scalar,
+                                          Eigen::Dynamic,
+                                          Out::ColsAtCompileTime,
+                                          0,
+                                          BatchChunkSize,
+                                          Out::ColsAtCompileTime>;
+
+/** Generates a chunked batch kernel calling Name##Chunk on each chunk of its arguments
+ *
+ * Each chunk is computed into a buffer before being copied to the output, so the output
+ * may alias an input. The buffer is small enough to stay in L1 cache.
+ */
+#define WAVE_BATCH_KERNEL_2(Name)                                                    \
+    template <typename A, typename Out>                                              \
+    void Name(const Eigen::ArrayBase<A> &a, const Eigen::ArrayBase<Out> &out_) {     \
+        auto &out = out_.const_cast_derived();                                       \
+        batch_chunk_buffer_t<Out> buffer;                                            \
+        forEachBatchChunk(a.rows(), [&](Eigen::Index i, Eigen::Index n) {            \
+            buffer.resize(n, Eigen::NoChange);                                       \
+            Name##Chunk(a.middleRows(i, n), buffer);                                 \
+            out.middleRows(i, n) = buffer;                                           \
+        });                                                                          \
+    }
+
+#define WAVE_BATCH_KERNEL_3(Name)                                                    \
+    template <typename A, typename B, typename Out>                                  \
+    void Name(const Eigen::ArrayBase<A> &a,                                          \
+              const Eigen::ArrayBase<B> &b,                                          \
+              const Eigen::ArrayBase<Out> &out_) {                                   \
+        auto &out = out_.const_cast_derived();                                       \
+        batch_chunk_buffer_t<Out> buffer;                                            \
+        forEachBatchChunk(a.rows(), [&](Eigen::Index i, Eigen::Index n) {            \
+            buffer.resize(n, Eigen::NoChange);                                       \
+            Name##Chunk(a.middleRows(i, n), b.middleRows(i, n), buffer);             \
+            out.middleRows(i, n) = buffer;                                           \
+        });                                                                          \
+    }
+
+WAVE_BATCH_KERNEL_3(batchMatrixCompose)
+WAVE_BATCH_KERNEL_3(batchMatrixRotate)
+WAVE_BATCH_KERNEL_2(batchMatrixTranspose)
+WAVE_BATCH_KERNEL_3(batchQuaternionCompose)
+WAVE_BATCH_KERNEL_3(batchQuaternionRotate)
+WAVE_BATCH_KERNEL_2(batchQuaternionConjugate)
+
+#undef WAVE_BATCH_KERNEL_2
+#undef WAVE_BATCH_KERNEL_3
+
+}  // namespace internal
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_BATCHKERNELS_HPP
@@ -0,0 +1,83 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_BATCHSTORAGE_HPP
+#define WAVE_GEOMETRY_BATCHSTORAGE_HPP
+
+namespace wave {
+
+/** Mixin providing structure-of-arrays storage for a batch of fixed-size leaves
+ *
+ * A batch of N objects, each with K coefficients, is stored as an N*K column-major
+ * array. Coefficient k of every element is contiguous in column k, so the kernels
+ * operating on whole columns are vectorized by Eigen across elements, processing as
+ * many elements per instruction as fit in a SIMD register.
+ *
+ * @tparam Derived the batch type
+ * @tparam ScalarType the scalar type (e.g. double)
+ * @tparam K the number of coefficients of each element
+ */
+template <typename Derived, typename ScalarType, int K>
+class BatchStorage {
+ public:
+    using Scalar = ScalarType;
+    using StorageType = Eigen::Array<Scalar, Eigen::Dynamic, K>;
+
+    /** Number of coefficients of each element */
+    static constexpr int NumCoeffs = K;
+
+    /** Constructs an empty batch */
+    BatchStorage() = default;
+
+    /** Constructs a batch of n elements (Doesn't initialize. It holds garbage) */
+    explicit BatchStorage(Eigen::Index n) : storage(n, K) {}
+
+    /** Returns the number of elements in the batch */
+    Eigen::Index size() const noexcept {
+        return this->storage.rows();
+    }
+
+    /** Resizes the batch to hold n elements. Existing values are not preserved. */
+    void resize(Eigen::Index n) {
+        this->storage.resize(n, K);
+    }
+
+    /** Returns the array of coefficient k of every element */
+    auto coeffs(int k) noexcept {
+        return this->storage.col(k);
+    }
+
+    /** Returns the const array of coefficient k of every element */
+    auto coeffs(int k) const noexcept {
+        return this->storage.col(k);
+    }
+
+    /** Returns reference to the underlying N*K array */
+    StorageType &value() noexcept {
+        return this->storage;
+    }
+
+    /** Returns const reference to the underlying N*K array */
+    const StorageType &value() const noexcept {
+        return this->storage;
+    }
+
+ protected:
+    /** Returns the K coefficients of element i as a plain column vector */
+    Eigen::Matrix<Scalar, K, 1> elementCoeffs(Eigen::Index i) const {
+        return this->storage.row(i).transpose().matrix();
+    }
+
+    /** Sets the K coefficients of element i */
+    template <typename VDerived>
+    void setElementCoeffs(Eigen::Index i, const Eigen::MatrixBase<VDerived> &v) {
+        this->storage.row(i) = v.transpose().array();
+    }
+
+    StorageType storage;
+};
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_BATCHSTORAGE_HPP
@@ -0,0 +1,113 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_COMPACTRIGIDTRANSFORMBATCH_HPP
+#define WAVE_GEOMETRY_COMPACTRIGIDTRANSFORMBATCH_HPP
+
+namespace wave {
+
+/** A batch of rigid transformations in SE(3), stored as structure-of-arrays
+ *
+ * The seven coefficients of each element are the same as those of
+ * CompactRigidTransform: a quaternion in Eigen::Quaternion order, then a translation.
+ *
+ * @tparam Scalar the scalar type (e.g. double)
+ *
+ * The alias RigidTransformQBatchd is provided for the typical scalar type, double.
+ */
+template <typename Scalar>
+class CompactRigidTransformBatch
+    : public BatchStorage<CompactRigidTransformBatch<Scalar>, Scalar, 7> {
+    using Storage = BatchStorage<CompactRigidTransformBatch<Scalar>, Scalar, 7>;
+
+ public:
+    using ElementType = CompactRigidTransform<Eigen::Matrix<Scalar, 7, 1>>;
+
+    using Storage::Storage;
+
+    /** Constructs an empty batch */
+    CompactRigidTransformBatch() = default;
+
+    /** Returns a copy of element i */
+    ElementType get(Eigen::Index i) const {
+        return ElementType{this->elementCoeffs(i)};
+    }
+
+    /** Sets element i from a rigid transform expression */
+    template <typename TDerived>
+    void set(Eigen::Index i, const RigidTransformBase<TDerived> &T) {
+        this->setElementCoeffs(i, ElementType{T.derived()}.value());
+    }
+
+    /** Returns a block of the rotation coefficients of every element */
+    auto rotationCoeffs() noexcept {
+        return this->storage.template leftCols<4>();
+    }
+
+    /** Returns a const block of the rotation coefficients of every element */
+    auto rotationCoeffs() const noexcept {
+        return this->storage.template leftCols<4>();
+    }
+
+    /** Returns a block of the translation coefficients of every element */
+    auto translationCoeffs() noexcept {
+        return this->storage.template rightCols<3>();
+    }
+
+    /** Returns a const block of the translation coefficients of every element */
+    auto translationCoeffs() const noexcept {
+        return this->storage.template rightCols<3>();
+    }
+
+    /** Returns the batch of inverse transforms */
+    CompactRigidTransformBatch inverse() const {
+        CompactRigidTransformBatch out{this->size()};
+        internal::batchQuaternionConjugate(this->rotationCoeffs(), out.rotationCoeffs());
+        internal::batchQuaternionRotate(
+          out.rotationCoeffs(), this->translationCoeffs(), out.translationCoeffs());
+        out.translationCoeffs() = -out.translationCoeffs();
+        return out;
+    }
+};
+
+/** Composes two batches of rigid transforms elementwise */
+template <typename Scalar>
+CompactRigidTransformBatch<Scalar> operator*(
+  const CompactRigidTransformBatch<Scalar> &lhs,
+  const CompactRigidTransformBatch<Scalar> &rhs) {
+    assert(lhs.size() == rhs.size());
+    CompactRigidTransformBatch<Scalar> out{lhs.size()};
+    internal::batchQuaternionCompose(
+      lhs.rotationCoeffs(), rhs.rotationCoeffs(), out.rotationCoeffs());
+    internal::batchQuaternionRotate(
+      lhs.rotationCoeffs(), rhs.translationCoeffs(), out.translationCoeffs());
+    out.translationCoeffs() += lhs.translationCoeffs();
+    return out;
+}
+
+/** Transforms a batch of translations by a batch of rigid transforms elementwise */
+template <typename Scalar>
+TranslationBatch<Scalar> operator*(const CompactRigidTransformBatch<Scalar> &lhs,
+                                   const TranslationBatch<Scalar> &rhs) {
+    assert(lhs.size() == rhs.size());
+    TranslationBatch<Scalar> out{lhs.size()};
+    internal::batchQuaternionRotate(lhs.rotationCoeffs(), rhs.value(), out.value());
+    out.value() += lhs.translationCoeffs();
+    return out;
+}
+
+/** Returns the batch of inverse transforms */
+template <typename Scalar>
+CompactRigidTransformBatch<Scalar> inverse(
+  const CompactRigidTransformBatch<Scalar> &rhs) {
+    return rhs.inverse();
+}
+
+// Convenience typedefs
+
+using RigidTransformQBatchd = CompactRigidTransformBatch<double>;
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_COMPACTRIGIDTRANSFORMBATCH_HPP
@@ -0,0 +1,102 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_QUATERNIONBATCH_HPP
+#define WAVE_GEOMETRY_QUATERNIONBATCH_HPP
+
+namespace wave {
+
+/** A batch of rotations on SO(3) stored as unit quaternions, in structure-of-arrays
+ * layout
+ *
+ * The four coefficients of each element are in Eigen::Quaternion order (x, y, z, w).
+ *
+ * @tparam Scalar the scalar type (e.g. double)
+ *
+ * The alias QuaternionBatchd is provided for the typical scalar type, double.
+ */
+template <typename Scalar>
+class QuaternionBatch : public BatchStorage<QuaternionBatch<Scalar>, Scalar, 4> {
+    using Storage = BatchStorage<QuaternionBatch<Scalar>, Scalar, 4>;
+    using QuaternionType = Eigen::Quaternion<Scalar>;
+
+ public:
+    using ElementType = QuaternionRotation<QuaternionType>;
+
+    using Storage::Storage;
+
+    /** Constructs an empty batch */
+    QuaternionBatch() = default;
+
+    /** Returns a copy of element i */
+    ElementType get(Eigen::Index i) const {
+        return ElementType{QuaternionType{this->elementCoeffs(i)}};
+    }
+
+    /** Sets element i from a rotation expression */
+    template <typename RDerived>
+    void set(Eigen::Index i, const RotationBase<RDerived> &r) {
+        this->setElementCoeffs(i, ElementType{r.derived()}.value().coeffs());
+    }
+
+    /** Returns the batch of inverse rotations */
+    QuaternionBatch inverse() const {
+        QuaternionBatch out{this->size()};
+        internal::batchQuaternionConjugate(this->value(), out.value());
+        return out;
+    }
+};
+
+/** Composes two batches of quaternions elementwise */
+template <typename Scalar>
+QuaternionBatch<Scalar> operator*(const QuaternionBatch<Scalar> &lhs,
+                                  const QuaternionBatch<Scalar> &rhs) {
+    assert(lhs.size() == rhs.size());
+    QuaternionBatch<Scalar> out{lhs.size()};
+    internal::batchQuaternionCompose(lhs.value(), rhs.value(), out.value());
+    return out;
+}
+
+/** Rotates a batch of translations by a batch of quaternions elementwise */
+template <typename Scalar>
+TranslationBatch<Scalar> operator*(const QuaternionBatch<Scalar> &lhs,
+                                   const TranslationBatch<Scalar> &rhs) {
+    assert(lhs.size() == rhs.size());
+    TranslationBatch<Scalar> out{lhs.size()};
+    internal::batchQuaternionRotate(lhs.value(), rhs.value(), out.value());
+    return out;
+}
+
+/** Composes two batches of quaternions elementwise, reusing the storage of lhs */
+template <typename Scalar>
+QuaternionBatch<Scalar> operator*(QuaternionBatch<Scalar> &&lhs,
+                                  const QuaternionBatch<Scalar> &rhs) {
+    assert(lhs.size() == rhs.size());
+    internal::batchQuaternionCompose(lhs.value(), rhs.value(), lhs.value());
+    return std::move(lhs);
+}
+
+/** Rotates a batch of translations by a batch of quaternions elementwise, reusing the
+ * storage of rhs */
+template <typename Scalar>
+TranslationBatch<Scalar> operator*(const QuaternionBatch<Scalar> &lhs,
+                                   TranslationBatch<Scalar> &&rhs) {
+    assert(lhs.size() == rhs.size());
+    internal::batchQuaternionRotate(lhs.value(), rhs.value(), rhs.value());
+    return std::move(rhs);
+}
+
+/** Returns the batch of inverse rotations */
+template <typename Scalar>
+QuaternionBatch<Scalar> inverse(const QuaternionBatch<Scalar> &rhs) {
+    return rhs.inverse();
+}
+
+// Convenience typedefs
+
+using QuaternionBatchd = QuaternionBatch<double>;
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_QUATERNIONBATCH_HPP
@@ -0,0 +1,104 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_ROTATIONBATCH_HPP
+#define WAVE_GEOMETRY_ROTATIONBATCH_HPP
+
+namespace wave {
+
+/** A batch of rotations on SO(3) stored as rotation matrices, in structure-of-arrays
+ * layout
+ *
+ * Coefficient k of each element is coefficient k of its column-major 3x3 matrix.
+ *
+ * @tparam Scalar the scalar type (e.g. double)
+ *
+ * The alias RotationBatchd is provided for the typical scalar type, double.
+ */
+template <typename Scalar>
+class RotationBatch : public BatchStorage<RotationBatch<Scalar>, Scalar, 9> {
+    using Storage = BatchStorage<RotationBatch<Scalar>, Scalar, 9>;
+    using MatrixType = Eigen::Matrix<Scalar, 3, 3>;
+
+ public:
+    using ElementType = MatrixRotation<MatrixType>;
+
+    using Storage::Storage;
+
+    /** Constructs an empty batch */
+    RotationBatch() = default;
+
+    /** Returns a copy of element i */
+    ElementType get(Eigen::Index i) const {
+        return ElementType{Eigen::Map<const MatrixType>{this->elementCoeffs(i).data()}};
+    }
+
+    /** Sets element i from a rotation expression */
+    template <typename RDerived>
+    void set(Eigen::Index i, const RotationBase<RDerived> &r) {
+        const auto m = ElementType{r.derived()};
+        this->setElementCoeffs(
+          i, Eigen::Map<const Eigen::Matrix<Scalar, 9, 1>>{m.value().data()});
+    }
+
+    /** Returns the batch of inverse rotations */
+    RotationBatch inverse() const {
+        RotationBatch out{this->size()};
+        internal::batchMatrixTranspose(this->value(), out.value());
+        return out;
+    }
+};
+
+/** Composes two batches of rotation matrices elementwise */
+template <typename Scalar>
+RotationBatch<Scalar> operator*(const RotationBatch<Scalar> &lhs,
+                                const RotationBatch<Scalar> &rhs) {
+    assert(lhs.size() == rhs.size());
+    RotationBatch<Scalar> out{lhs.size()};
+    internal::batchMatrixCompose(lhs.value(), rhs.value(), out.value());
+    return out;
+}
+
+/** Rotates a batch of translations by a batch of rotation matrices elementwise */
+template <typename Scalar>
+TranslationBatch<Scalar> operator*(const RotationBatch<Scalar> &lhs,
+                                   const TranslationBatch<Scalar> &rhs) {
+    assert(lhs.size() == rhs.size());
+    TranslationBatch<Scalar> out{lhs.size()};
+    internal::batchMatrixRotate(lhs.value(), rhs.value(), out.value());
+    return out;
+}
+
+/** Composes two batches of rotation matrices elementwise, reusing the storage of lhs */
+template <typename Scalar>
+RotationBatch<Scalar> operator*(RotationBatch<Scalar> &&lhs,
+                                const RotationBatch<Scalar> &rhs) {
+    assert(lhs.size() == rhs.size());
+    internal::batchMatrixCompose(lhs.value(), rhs.value(), lhs.value());
+    return std::move(lhs);
+}
+
+/** Rotates a batch of translations by a batch of rotation matrices elementwise,
+ * reusing the storage of rhs */
+template <typename Scalar>
+TranslationBatch<Scalar> operator*(const RotationBatch<Scalar> &lhs,
+                                   TranslationBatch<Scalar> &&rhs) {
+    assert(lhs.size() == rhs.size());
+    internal::batchMatrixRotate(lhs.value(), rhs.value(), rhs.value());
+    return std::move(rhs);
+}
+
+/** Returns the batch of inverse rotations */
+template <typename Scalar>
+RotationBatch<Scalar> inverse(const RotationBatch<Scalar> &rhs) {
+    return rhs.inverse();
+}
+
+// Convenience typedefs
+
+using RotationBatchd = RotationBatch<double>;
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_ROTATIONBATCH_HPP
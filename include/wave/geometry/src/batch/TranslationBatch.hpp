@@ -0,0 +1,56 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_TRANSLATIONBATCH_HPP
+#define WAVE_GEOMETRY_TRANSLATIONBATCH_HPP
+
+namespace wave {
+
+/** A batch of translations in R^3, stored as structure-of-arrays
+ *
+ * @tparam Scalar the scalar type (e.g. double)
+ *
+ * The alias TranslationBatchd is provided for the typical scalar type, double.
+ */
+template <typename Scalar>
+class TranslationBatch : public BatchStorage<TranslationBatch<Scalar>, Scalar, 3> {
+    using Storage = BatchStorage<TranslationBatch<Scalar>, Scalar, 3>;
+
+ public:
+    using ElementType = Translation<Eigen::Matrix<Scalar, 3, 1>>;
+
+    using Storage::Storage;
+
+    /** Constructs an empty batch */
+    TranslationBatch() = default;
+
+    /** Returns a copy of element i */
+    ElementType get(Eigen::Index i) const {
+        return ElementType{this->elementCoeffs(i)};
+    }
+
+    /** Sets element i from a translation expression */
+    template <typename TDerived>
+    void set(Eigen::Index i, const TranslationBase<TDerived> &t) {
+        this->setElementCoeffs(i, ElementType{t.derived()}.value());
+    }
+};
+
+/** Adds two batches of translations elementwise */
+template <typename Scalar>
+TranslationBatch<Scalar> operator+(const TranslationBatch<Scalar> &lhs,
+                                   const TranslationBatch<Scalar> &rhs) {
+    assert(lhs.size() == rhs.size());
+    TranslationBatch<Scalar> out{lhs.size()};
+    out.value() = lhs.value() + rhs.value();
+    return out;
+}
+
+// Convenience typedefs
+
+using TranslationBatchd = TranslationBatch<double>;
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_TRANSLATIONBATCH_HPP
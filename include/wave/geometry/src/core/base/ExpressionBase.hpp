@@ -61,6 +61,39 @@ class ExpressionBase {
         return internal::evaluateWithReverseJacobians(this->derived());
     }
 
+    /** Evaluate the value and the products of an adjoint with the jacobians w.r.t. all
+     * leaves, in reverse mode.
+     *
+     * The adjoint (e.g., a weighting or square-root information matrix) has one column
+     * per tangent dimension of the expression. This requires that the expression is a
+     * tree with unique types.
+     */
+    template <typename AdjointDerived>
+    auto evalWithAdjointJacobians(const Eigen::MatrixBase<AdjointDerived> &adjoint) const
+      -> internal::eval_with_adjoint_jacobians_t<Derived,
+                                                 AdjointDerived::RowsAtCompileTime> {
+        static_assert(internal::unique_leaves_t<Derived>{},
+                      "Calling evalWithAdjointJacobians() is only possible for "
+                      "expression trees with unique types");
+        return internal::evaluateWithReverseJacobians(this->derived(), adjoint);
+    }
+
+
+    /** Evaluate the value and the directional derivative along tangent vectors of some
+     * leaves, in forward mode.
+     *
+     * @param perturbations leaves paired with tangent vectors by perturb()
+     * @return the value and J_1 * delta_1 + J_2 * delta_2 + ...
+     */
+    template <typename... Leaves>
+    auto evalWithDirectionalDerivative(const Perturbation<Leaves> &... perturbations) const
+      -> std::pair<OutputType,
+                   Eigen::Matrix<internal::scalar_t<Derived>,
+                                 internal::eval_traits<Derived>::TangentSize,
+                                 1>> {
+        return internal::evaluateWithDirectionalDerivative(this->derived(),
+                                                           perturbations...);
+    }
 
     /** Evaluate the value and jacobians w.r.t. some targets */
     template <typename... Targets>
@@ -8,166 +8,361 @@
 namespace wave {
 namespace internal {
 
-/** Choose the first directly evaluable leaf type, using either the given candidate or the
- * core leaf types for its operand.
- * For a `Derived` expression of the form `Unary<Rhs>`, the order checked is:
+/** The estimated cost of an evalImpl() overload, in floating-point operations
  *
- * 1. `Unary<RhsFolded>` (no conversion)
- * 2. For each type T in the type list `Derived::ConvertTo`:
- *      `Unary<Convert<T, RhsFolded>>`
+ * Costs are given by declaring a function `evalCost()` taking the same arguments as
+ * the evalImpl() overload, and returning `flops<N>`. For example:
  *
- * Currently, the fist acceptable conversion is used; in future, the lowest-cost
- * conversion might be used.
+ *     template <typename Lhs, typename Rhs>
+ *     auto evalCost(expr<Compose>,
+ *                   const MatrixRotation<Lhs> &,
+ *                   const MatrixRotation<Rhs> &) -> flops<45>;
+ *
+ * The estimates only need to be good enough to choose between conversions.
  */
-template <typename Derived,
-          typename Tag,
-          template <typename>
-          class Rebind,
-          typename Rhs,
-          typename... ConvertTo>
-struct first_directly_evaluable_conversion_unary;
+template <int N>
+using flops = std::integral_constant<int, N>;
+
+/** The cost assumed for an evalImpl() overload with no evalCost() */
+constexpr int DefaultEvalCost = 10;
+
+namespace impl {
+template <typename... Args>
+inline auto evalCostOrDefault(Args &&...) -> decltype(evalCost(std::declval<Args>()...));
+
+inline auto evalCostOrDefault(...) -> flops<DefaultEvalCost>;
+}  // namespace impl
+
+/** The estimated cost of calling evalImpl() with the given tag and arguments */
+template <typename Tag, typename... Args>
+using eval_cost_t = decltype(impl::evalCostOrDefault(Tag{}, std::declval<Args>()...));
+
+/** One way of preparing an expression for evaluation
+ *
+ * @tparam Type the prepared expression type, as given by PreparedType
+ * @tparam Eval the type it evaluates to
+ * @tparam Cost the estimated cost of evaluating it, including its operands
+ * @tparam OperandPlans the plans used for its operands, if they were chosen by cost
+ */
+template <typename Type, typename Eval, int Cost, typename... OperandPlans>
+struct prepared_plan {
+    using type = Type;
+    using eval_type = Eval;
+    static constexpr int cost = Cost;
+};
+
+/** The plans available for preparing an expression, as a type_list of prepared_plan.
+ *
+ * The first plan is always the expression's PreparedType. Other plans, if any, evaluate
+ * to different types. Expressions whose traits do not define PreparedPlans have one
+ * plan, with a cost of zero.
+ */
+template <typename Derived, typename = void>
+struct prepared_plans {
+    using type = tmp::type_list<
+      prepared_plan<typename traits<Derived>::PreparedType, eval_t<Derived>, 0>>;
+};
+
+template <typename Derived>
+struct prepared_plans<Derived, tmp::void_t<typename traits<Derived>::PreparedPlans>> {
+    using type = typename traits<Derived>::PreparedPlans;
+};
+
+template <typename Derived>
+using prepared_plans_t = typename prepared_plans<tmp::remove_cr_t<Derived>>::type;
+
+/** The estimated cost of evaluating an expression, as prepared */
+template <typename Derived>
+using prepared_cost =
+  std::integral_constant<int, tmp::front_t<prepared_plans_t<Derived>>::cost>;
+
+/** The plan for an operand prepared by Plan, then converted to `To` */
+template <typename Plan, typename To>
+struct converted_plan
+    : prepared_plan<Convert<To, typename Plan::type> &&,
+                    eval_t_unary<expr<Convert, To>, typename Plan::eval_type>,
+                    Plan::cost +
+                      eval_cost_t<expr<Convert, To>, typename Plan::eval_type>{}> {};
+
+/** Gives a list holding the plan for converting an operand to `To`, or an empty list if
+ * no such conversion is directly evaluable.
+ */
+template <typename Plan, typename To, typename = void>
+struct conversion_plan {
+    using type = tmp::type_list<>;
+};
 
+template <typename Plan, typename To>
+struct conversion_plan<
+  Plan,
+  To,
+  std::enable_if_t<is_directly_evaluable_unary<expr<Convert, To>,
+                                               typename Plan::eval_type>{}>> {
+    using type = tmp::type_list<converted_plan<Plan, To>>;
+};
+
+/** The plans for the operand of an expression: each plan of the operand, either as-is or
+ * converted to one of the types in its ConvertTo list
+ */
+template <typename Plan,
+          typename ConvertTo =
+            typename traits<tmp::remove_cr_t<typename Plan::eval_type>>::ConvertTo>
+struct operand_plans_for;
+
+template <typename Plan, template <typename...> class List, typename... ConvertTo>
+struct operand_plans_for<Plan, List<ConvertTo...>> {
+    using type = tmp::concat_t<tmp::type_list<Plan>,
+                               typename conversion_plan<Plan, ConvertTo>::type...>;
+};
+
+template <typename Plans>
+struct operand_plans;
 
-/** Choose the first directly evaluable leaf type, using either the given candidate or the
- * tuple-like list of core leaf types for its operand. This partial specialization is
- * here to expand the list of ConvertTo.
+template <typename... Plans>
+struct operand_plans<tmp::type_list<Plans...>> {
+    using type =
+      tmp::concat_t<tmp::type_list<>, typename operand_plans_for<Plans>::type...>;
+};
+
+template <typename Derived>
+using operand_plans_t = typename operand_plans<prepared_plans_t<Derived>>::type;
+
+/** Gives a list holding the plan for a unary expression with the given operand, or an
+ * empty list if it is not directly evaluable
  */
-template <typename Derived,
-          typename Tag,
-          template <typename>
+template <typename Tag, template <typename> class Rebind, typename Rhs, typename = void>
+struct unary_plan {
+    using type = tmp::type_list<>;
+};
+
+template <typename Tag, template <typename> class Rebind, typename Rhs>
+struct unary_plan<
+  Tag,
+  Rebind,
+  Rhs,
+  std::enable_if_t<is_directly_evaluable_unary<Tag, typename Rhs::eval_type>{}>> {
+    using type = tmp::type_list<
+      prepared_plan<Rebind<typename Rhs::type> &&,
+                    eval_t_unary<Tag, typename Rhs::eval_type>,
+                    Rhs::cost + eval_cost_t<Tag, typename Rhs::eval_type>{},
+                    Rhs>>;
+};
+
+/** Gives a list holding the plan for a binary expression with the given operands, or an
+ * empty list if it is not directly evaluable
+ */
+template <typename Tag,
+          template <typename, typename>
           class Rebind,
+          typename Lhs,
           typename Rhs,
-          template <typename...>
-          class List,
-          typename... ConvertTo>
-struct first_directly_evaluable_conversion_unary<Derived,
-                                                 Tag,
-                                                 Rebind,
-                                                 Rhs,
-                                                 List<ConvertTo...>> {
-    // todo: factor out to short-circuit in this most common case
-    struct is_evaluable_test : is_directly_evaluable_unary<Tag, eval_t<Rhs>> {
-        using type = Derived;
-    };
-
-    template <typename ToRhs>
-    struct is_evaluable_after_conversion_test
-        : tmp::conjunction<is_directly_evaluable_unary<expr<Convert, ToRhs>, eval_t<Rhs>>,
-                           is_directly_evaluable_unary<Tag, ToRhs>> {
-        using type = Rebind<Convert<ToRhs, Rhs> &&>;
-    };
-
-    template <typename T>
-    struct nothing_matches {
-        using FailedLookup = decltype(evalImpl(Tag{}, std::declval<eval_t<Rhs>>()));
-        static_assert(tmp::alwaysFalse<T>(),
-                      "Could not find conversions to an applicable evalImpl() function");
-    };
+          typename = void>
+struct binary_plan {
+    using type = tmp::type_list<>;
+};
 
-    using type =
-      typename tmp::disjunction<is_evaluable_test,
-                                is_evaluable_after_conversion_test<ConvertTo>...,
-                                nothing_matches<void>>::type;
+template <typename Tag,
+          template <typename, typename>
+          class Rebind,
+          typename Lhs,
+          typename Rhs>
+struct binary_plan<
+  Tag,
+  Rebind,
+  Lhs,
+  Rhs,
+  std::enable_if_t<is_directly_evaluable_binary<Tag,
+                                                typename Lhs::eval_type,
+                                                typename Rhs::eval_type>{}>> {
+    using LhsEval = typename Lhs::eval_type;
+    using RhsEval = typename Rhs::eval_type;
+    using type = tmp::type_list<
+      prepared_plan<Rebind<typename Lhs::type, typename Rhs::type> &&,
+                    eval_t_binary<Tag, LhsEval, RhsEval>,
+                    Lhs::cost + Rhs::cost + eval_cost_t<Tag, LhsEval, RhsEval>{},
+                    Lhs,
+                    Rhs>>;
+};
+
+/** Gives the first plan of lowest cost in a non-empty list */
+template <typename Plans>
+struct cheapest_plan;
+
+template <typename Plan>
+struct cheapest_plan<tmp::type_list<Plan>> {
+    using type = Plan;
+};
+
+template <typename Plan, typename Next, typename... Plans>
+struct cheapest_plan<tmp::type_list<Plan, Next, Plans...>> {
+ private:
+    using Rest = typename cheapest_plan<tmp::type_list<Next, Plans...>>::type;
+
+ public:
+    using type = std::conditional_t<(Rest::cost < Plan::cost), Rest, Plan>;
+};
+
+/** Gives the list of Plans without the plans evaluating to the same type as `Plan` */
+template <typename Plans, typename Plan>
+struct remove_same_eval_plans;
+
+template <typename... Plans, typename Plan>
+struct remove_same_eval_plans<tmp::type_list<Plans...>, Plan> {
+    using type = tmp::concat_t<
+      tmp::type_list<>,
+      std::conditional_t<std::is_same<tmp::remove_cr_t<typename Plans::eval_type>,
+                                      tmp::remove_cr_t<typename Plan::eval_type>>{},
+                         tmp::type_list<>,
+                         tmp::type_list<Plans>>...>;
+};
+
+/** Gives the cheapest plan for each type the plans evaluate to, in order of appearance */
+template <typename Plans>
+struct cheapest_plan_per_eval {
+    using type = tmp::type_list<>;
 };
 
+template <typename Plan, typename... Plans>
+struct cheapest_plan_per_eval<tmp::type_list<Plan, Plans...>> {
+ private:
+    using SameEval = tmp::concat_t<
+      tmp::type_list<Plan>,
+      std::conditional_t<std::is_same<tmp::remove_cr_t<typename Plans::eval_type>,
+                                      tmp::remove_cr_t<typename Plan::eval_type>>{},
+                         tmp::type_list<Plans>,
+                         tmp::type_list<>>...>;
+    using Others =
+      typename remove_same_eval_plans<tmp::type_list<Plans...>, Plan>::type;
 
-/** Choose the first directly evaluable converted type, using either the given
- * binary expression or the tuple-like list of core leaf types for its operands.
+ public:
+    using type =
+      tmp::concat_t<tmp::type_list<typename cheapest_plan<SameEval>::type>,
+                    typename cheapest_plan_per_eval<Others>::type>;
+};
+
+/** Chooses how to prepare an expression, given all of its directly evaluable plans
+ *
+ * The cheapest candidate is used, with ties going to the earliest. The candidate with
+ * unconverted operands, if evaluable, comes first, so it is kept unless a conversion is
+ * estimated to be cheaper. An expression which is already prepared is thus unchanged.
  *
- * For a `Derived` expression of the form `Binary<Lhs, Rhs>`, the order checked is:
+ * `type` is the chosen prepared type, and `plans` the list of plans offered to the
+ * parent expression: the chosen plan first, then the cheapest plan evaluating to each
+ * other type. A parent can thus choose a plan for its operand which is not the cheapest
+ * on its own, if it avoids a more expensive conversion later.
  *
- * 1. `Binary<Lhs, Rhs>` (no conversion)
- * 2. For each type R in RhsConvertTo:
- *      `Binary<Lhs, Convert<R, Rhs>>`
- * 3. For each type L in LhsConvertTo:
- *      `Binary<Convert<L, Lhs>, Rhs>`
- * 4. For the Cartesian product of the two ConvertTo lists:
- *      `Binary<Convert<L, Lhs>, Convert<R, Rhs>>`
+ * @tparam Error a type to instantiate if there are no candidates
  */
-template <typename Derived,
-          typename Tag,
+template <typename Candidates, typename Error>
+struct choose_plan {
+ private:
+    using Chosen = typename cheapest_plan<Candidates>::type;
+    using Others = typename remove_same_eval_plans<Candidates, Chosen>::type;
+
+ public:
+    using type = typename Chosen::type;
+    using plans = tmp::concat_t<tmp::type_list<Chosen>,
+                                typename cheapest_plan_per_eval<Others>::type>;
+};
+
+template <typename Error>
+struct choose_plan<tmp::type_list<>, Error> : Error {};
+
+template <typename Tag, typename... Operands>
+struct no_evaluable_plan {
+    using FailedLookup = decltype(evalImpl(Tag{}, std::declval<Operands>()...));
+    static_assert(tmp::alwaysFalse<Tag>(),
+                  "Could not find conversions to an applicable evalImpl() function");
+};
+
+template <typename Tag, template <typename> class Rebind, typename RhsPlans>
+struct unary_candidates;
+
+template <typename Tag, template <typename> class Rebind, typename... RhsPlans>
+struct unary_candidates<Tag, Rebind, tmp::type_list<RhsPlans...>> {
+    using type =
+      tmp::concat_t<tmp::type_list<>, typename unary_plan<Tag, Rebind, RhsPlans>::type...>;
+};
+
+template <typename Tag,
           template <typename, typename>
           class Rebind,
           typename Lhs,
-          typename Rhs,
-          typename LhsConvertTo,
-          typename RhsConvertTo>
-struct first_directly_evaluable_conversion_binary;
+          typename RhsPlans>
+struct binary_candidates_for;
 
-/** Choose the first directly evaluable converted type, using either the given binary
- * expression or the tuple-like list of core leaf types for its operands. This partial
- * specialization is here to expand the list of ConvertTo.
- */
-template <typename Derived,
-          typename Tag,
+template <typename Tag,
           template <typename, typename>
           class Rebind,
           typename Lhs,
-          typename Rhs,
-          template <typename...>
-          class List,
-          typename... LhsConvertTo,
-          typename... RhsConvertTo>
-struct first_directly_evaluable_conversion_binary<Derived,
-                                                  Tag,
-                                                  Rebind,
-                                                  Lhs,
-                                                  Rhs,
-                                                  List<LhsConvertTo...>,
-                                                  List<RhsConvertTo...>> {
-    // Helper 1-argument templates
-    template <typename ToLhs>
-    using replace_left = Rebind<ToLhs, Rhs>;
-
-    template <typename ToRhs>
-    using replace_right = Rebind<Lhs, ToRhs>;
-
-    // todo: factor out to short-circuit in this most common case
-    struct is_evaluable_test
-        : is_directly_evaluable_binary<Tag, eval_t<Lhs>, eval_t<Rhs>> {
-        using type = Derived;
-    };
-
-    template <typename ToLhs>
-    struct convert_left_test
-        : tmp::conjunction<is_directly_evaluable_unary<expr<Convert, ToLhs>, eval_t<Lhs>>,
-                           is_directly_evaluable_binary<Tag, ToLhs, eval_t<Rhs>>> {
-        using type = Rebind<Convert<ToLhs, Lhs> &&, Rhs>;
-    };
-
-    template <typename ToRhs>
-    struct convert_right_test
-        : tmp::conjunction<is_directly_evaluable_unary<expr<Convert, ToRhs>, eval_t<Rhs>>,
-                           is_directly_evaluable_binary<Tag, eval_t<Lhs>, ToRhs>> {
-        using type = Rebind<Lhs, Convert<ToRhs, Rhs> &&>;
-    };
-
-    template <typename ToLhs, typename ToRhs>
-    struct convert_both_test
-        : tmp::conjunction<is_directly_evaluable_unary<expr<Convert, ToLhs>, eval_t<Lhs>>,
-                           is_directly_evaluable_unary<expr<Convert, ToRhs>, eval_t<Rhs>>,
-                           is_directly_evaluable_binary<Tag, ToLhs, ToRhs>> {
-        using type = Rebind<Convert<ToLhs, Lhs> &&, Convert<ToRhs, Rhs> &&>;
-    };
-
-    template <typename T>
-    struct nothing_matches {
-        using FailedLookup = decltype(
-          evalImpl(Tag{}, std::declval<eval_t<Lhs>>(), std::declval<eval_t<Rhs>>()));
-        static_assert(tmp::alwaysFalse<T>(),
-                      "Could not find conversions to an applicable evalImpl() function");
-    };
-
-    using type = typename tmp::expanding_disjunction<
-      is_evaluable_test,
-      convert_right_test<RhsConvertTo>...,
-      convert_left_test<LhsConvertTo>...,
-      tmp::apply_cartesian_t<convert_both_test,
-                             tmp::type_list<LhsConvertTo...>,
-                             tmp::type_list<RhsConvertTo...>>,
-      nothing_matches<void>>::type;
+          typename... RhsPlans>
+struct binary_candidates_for<Tag, Rebind, Lhs, tmp::type_list<RhsPlans...>> {
+    using type = tmp::concat_t<tmp::type_list<>,
+                               typename binary_plan<Tag, Rebind, Lhs, RhsPlans>::type...>;
+};
+
+template <typename Tag,
+          template <typename, typename>
+          class Rebind,
+          typename LhsPlans,
+          typename RhsPlans>
+struct binary_candidates;
+
+template <typename Tag,
+          template <typename, typename>
+          class Rebind,
+          typename... LhsPlans,
+          typename RhsPlans>
+struct binary_candidates<Tag, Rebind, tmp::type_list<LhsPlans...>, RhsPlans> {
+    using type = tmp::concat_t<
+      tmp::type_list<>,
+      typename binary_candidates_for<Tag, Rebind, LhsPlans, RhsPlans>::type...>;
 };
 
+/** Chooses a prepared type for a unary expression, and gives its plans.
+ *
+ * For an expression of the form `Unary<Rhs>`, the candidates are, for each plan P of
+ * Rhs (see prepared_plans):
+ *
+ * 1. `Unary<P>` (no conversion)
+ * 2. For each type T in the type list `traits<eval of P>::ConvertTo`:
+ *      `Unary<Convert<T, P>>`
+ *
+ * The candidate with the lowest estimated cost is used (see evalCost()), preferring
+ * `Unary<Rhs>` with Rhs as prepared on a tie.
+ */
+template <typename Tag, template <typename> class Rebind, typename RhsDerived>
+struct cheapest_conversion_unary
+    : choose_plan<
+        typename unary_candidates<Tag, Rebind, operand_plans_t<RhsDerived>>::type,
+        no_evaluable_plan<Tag, eval_t<RhsDerived>>> {};
+
+/** Chooses a prepared type for a binary expression, and gives its plans.
+ *
+ * For an expression of the form `Binary<Lhs, Rhs>`, the candidates are, for each plan
+ * PL of Lhs and PR of Rhs (see prepared_plans), and for each of their conversions as in
+ * cheapest_conversion_unary:
+ *
+ * 1. `Binary<PL, PR>` (no conversion)
+ * 2. For each type R in the ConvertTo list of PR: `Binary<PL, Convert<R, PR>>`
+ * 3. For each type L in the ConvertTo list of PL: `Binary<Convert<L, PL>, PR>`, then
+ *    `Binary<Convert<L, PL>, Convert<R, PR>>` for each R
+ *
+ * The candidate with the lowest estimated cost is used, preferring `Binary<Lhs, Rhs>`
+ * with Lhs and Rhs as prepared on a tie.
+ */
+template <typename Tag,
+          template <typename, typename>
+          class Rebind,
+          typename LhsDerived,
+          typename RhsDerived>
+struct cheapest_conversion_binary
+    : choose_plan<typename binary_candidates<Tag,
+                                             Rebind,
+                                             operand_plans_t<LhsDerived>,
+                                             operand_plans_t<RhsDerived>>::type,
+                  no_evaluable_plan<Tag, eval_t<LhsDerived>, eval_t<RhsDerived>>> {};
+
 }  // namespace internal
 }  // namespace wave
 
@@ -0,0 +1,391 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_AUTOJACOBIANEVALUATOR_HPP
+#define WAVE_GEOMETRY_AUTOJACOBIANEVALUATOR_HPP
+
+namespace wave {
+namespace internal {
+
+/** Ways evaluateWithJacobiansAuto() can find the Jacobians wrt given targets */
+enum class JacobianMode {
+    Forward,  ///< JacobianEvaluator, stacked when possible
+    Typed,    ///< TypedJacobianEvaluator, one per target
+    Reverse   ///< ReverseJacobianEvaluator, one pass from the root
+};
+
+template <JacobianMode Mode>
+using jacobian_mode_t = std::integral_constant<JacobianMode, Mode>;
+
+/** Whether a local Jacobian is the identity, which costs nothing to apply */
+template <typename Jacobian>
+struct is_identity_jacobian : std::false_type {};
+
+template <typename Scalar, int N>
+struct is_identity_jacobian<IdentityMatrix<Scalar, N>> : std::true_type {};
+
+/** Estimated multiply-adds to compute a Rows x Cols local Jacobian and apply it to a
+ * matrix with `other` columns (in forward mode) or rows (in reverse mode)
+ */
+template <typename Jacobian>
+constexpr int localJacobianCost(int rows, int cols, int other) {
+    return is_identity_jacobian<tmp::remove_cr_t<Jacobian>>{} ? 0
+                                                               : rows * cols * (1 + other);
+}
+
+/** The total tangent size of the targets an expression may contain (by type) */
+template <typename Derived, typename... Targets>
+constexpr int containedTangentSize() {
+    const int sizes[] = {
+      (contains_same_type<Derived, Targets>{} ? eval_traits<Targets>::TangentSize : 0)...,
+      0};
+    int total = 0;
+    for (const int size : sizes) {
+        total += size;
+    }
+    return total;
+}
+
+/** Compile-time estimates of the cost of finding Jacobians in forward and reverse mode
+ *
+ * Forward mode applies each node's local Jacobians to the Jacobians wrt the targets its
+ * children may contain, so its cost grows with the tangent sizes of the targets. Reverse
+ * mode applies them to the adjoint of every node, so its cost grows with OutputSize,
+ * the tangent size of the root. Both grow with the depth of the tree and the shapes of
+ * the local Jacobians; identity Jacobians are free. `Nodes` is the size of the tree.
+ *
+ * @tparam TargetList a tmp::type_list of the targets
+ */
+template <typename Derived, int OutputSize, typename TargetList, typename = void>
+struct jacobian_cost;
+
+/** Specialization for leaf expression */
+template <typename Derived, int OutputSize, typename... Targets>
+struct jacobian_cost<Derived,
+                     OutputSize,
+                     tmp::type_list<Targets...>,
+                     enable_if_leaf_or_scalar_t<Derived>> {
+    enum : int { Forward = 0, Reverse = 0, Nodes = 1 };
+};
+
+/** Specialization for unary expression */
+template <typename Derived, int OutputSize, typename... Targets>
+struct jacobian_cost<Derived,
+                     OutputSize,
+                     tmp::type_list<Targets...>,
+                     enable_if_unary_t<Derived>> {
+ private:
+    using RhsDerived = typename traits<Derived>::RhsDerived;
+    using RhsCost = jacobian_cost<RhsDerived, OutputSize, tmp::type_list<Targets...>>;
+    using SelfJacobian =
+      decltype(jacobianImpl(get_expr_tag_t<Derived>{},
+                            std::declval<eval_t<Derived>>(),
+                            std::declval<eval_t<RhsDerived>>()));
+
+    enum : int {
+        Size = eval_traits<Derived>::TangentSize,
+        RhsSize = eval_traits<RhsDerived>::TangentSize,
+        RhsWidth = containedTangentSize<RhsDerived, Targets...>()
+    };
+
+ public:
+    enum : int {
+        Forward = (RhsWidth > 0
+                     ? localJacobianCost<SelfJacobian>(Size, RhsSize, RhsWidth)
+                     : 0) +
+                  RhsCost::Forward,
+        Reverse = localJacobianCost<SelfJacobian>(Size, RhsSize, OutputSize) +
+                  RhsCost::Reverse,
+        Nodes = 1 + RhsCost::Nodes
+    };
+};
+
+/** Specialization for binary expression */
+template <typename Derived, int OutputSize, typename... Targets>
+struct jacobian_cost<Derived,
+                     OutputSize,
+                     tmp::type_list<Targets...>,
+                     enable_if_binary_t<Derived>> {
+ private:
+    using LhsDerived = typename traits<Derived>::LhsDerived;
+    using RhsDerived = typename traits<Derived>::RhsDerived;
+    using LhsCost = jacobian_cost<LhsDerived, OutputSize, tmp::type_list<Targets...>>;
+    using RhsCost = jacobian_cost<RhsDerived, OutputSize, tmp::type_list<Targets...>>;
+    using LhsJacobian = decltype(leftJacobianImpl(get_expr_tag_t<Derived>{},
+                                                  std::declval<eval_t<Derived>>(),
+                                                  std::declval<eval_t<LhsDerived>>(),
+                                                  std::declval<eval_t<RhsDerived>>()));
+    using RhsJacobian = decltype(rightJacobianImpl(get_expr_tag_t<Derived>{},
+                                                   std::declval<eval_t<Derived>>(),
+                                                   std::declval<eval_t<LhsDerived>>(),
+                                                   std::declval<eval_t<RhsDerived>>()));
+
+    enum : int {
+        Size = eval_traits<Derived>::TangentSize,
+        LhsSize = eval_traits<LhsDerived>::TangentSize,
+        RhsSize = eval_traits<RhsDerived>::TangentSize,
+        LhsWidth = containedTangentSize<LhsDerived, Targets...>(),
+        RhsWidth = containedTangentSize<RhsDerived, Targets...>()
+    };
+
+ public:
+    enum : int {
+        Forward = (LhsWidth > 0
+                     ? localJacobianCost<LhsJacobian>(Size, LhsSize, LhsWidth)
+                     : 0) +
+                  (RhsWidth > 0
+                     ? localJacobianCost<RhsJacobian>(Size, RhsSize, RhsWidth)
+                     : 0) +
+                  LhsCost::Forward + RhsCost::Forward,
+        Reverse = localJacobianCost<LhsJacobian>(Size, LhsSize, OutputSize) +
+                  localJacobianCost<RhsJacobian>(Size, RhsSize, OutputSize) +
+                  LhsCost::Reverse + RhsCost::Reverse,
+        Nodes = 1 + LhsCost::Nodes + RhsCost::Nodes
+    };
+};
+
+/** Whether an expression tree is made only of static leaf, unary and binary expressions
+ * (and not, e.g., of dynamic expressions)
+ */
+template <typename Derived, typename = void>
+struct is_static_tree : std::false_type {};
+
+template <typename Derived>
+struct is_static_tree<Derived, enable_if_leaf_or_scalar_t<Derived>> : std::true_type {};
+
+template <typename Derived>
+struct is_static_tree<Derived, enable_if_unary_t<Derived>>
+    : is_static_tree<typename traits<Derived>::RhsDerived> {};
+
+template <typename Derived>
+struct is_static_tree<Derived, enable_if_binary_t<Derived>>
+    : tmp::conjunction<is_static_tree<typename traits<Derived>::LhsDerived>,
+                       is_static_tree<typename traits<Derived>::RhsDerived>> {};
+
+/** Whether reverse mode can find the Jacobians wrt the given targets
+ *
+ * It requires a static tree with unique types, from which the Jacobian wrt a leaf target
+ * is picked by type.
+ */
+template <typename Derived, typename... Targets>
+struct is_reverse_applicable
+    : tmp::conjunction<unique_leaves_t<Derived>,
+                       is_static_tree<Derived>,
+                       is_leaf_expression<Targets>...> {};
+
+/** Whether the estimated cost of reverse mode is lower than that of forward mode */
+template <typename Derived,
+          typename TargetList,
+          typename Cost =
+            jacobian_cost<Derived, eval_traits<Derived>::TangentSize, TargetList>>
+struct is_reverse_cheaper : tmp::bool_constant<(Cost::Reverse < Cost::Forward)> {};
+
+/** The estimated cost of finding the Jacobian wrt each target in a separate forward pass
+ */
+template <typename Derived, typename... Targets>
+constexpr int separateForwardCost() {
+    const int costs[] = {
+      jacobian_cost<Derived, eval_traits<Derived>::TangentSize, tmp::type_list<Targets>>::
+        Forward...,
+      0};
+    int total = 0;
+    for (const int cost : costs) {
+        total += cost;
+    }
+    return total;
+}
+
+/** The estimated cost of finding the Jacobians wrt the targets with JacobianEvaluator
+ *
+ * Targets which can all be stacked are found together, in one pass. Otherwise, each is
+ * found in a separate pass which matches every node of the tree at run time.
+ */
+template <typename Derived, typename... Targets>
+constexpr int forwardModeCost() {
+    using Cost = jacobian_cost<Derived,
+                               eval_traits<Derived>::TangentSize,
+                               tmp::type_list<Targets...>>;
+    return tmp::conjunction<is_stackable_target<Targets>...>{}
+             ? Cost::Forward
+             : separateForwardCost<Derived, Targets...>() +
+                 Cost::Nodes * static_cast<int>(sizeof...(Targets));
+}
+
+/** Whether the estimated cost of TypedJacobianEvaluator is lower than that of forward
+ * mode
+ *
+ * The typed evaluator applies the same local Jacobians as a separate forward pass per
+ * target, but finds the path to each target at compile time.
+ *
+ * A tree which is not static, such as a dynamic expression, has no structure known at
+ * compile time, so the typed evaluator does not apply.
+ */
+template <typename Derived, typename TargetList, bool = is_static_tree<Derived>{}>
+struct is_typed_cheaper;
+
+template <typename Derived, typename... Targets>
+struct is_typed_cheaper<Derived, tmp::type_list<Targets...>, false> : std::false_type {};
+
+template <typename Derived, typename... Targets>
+struct is_typed_cheaper<Derived, tmp::type_list<Targets...>, true>
+    : tmp::bool_constant<(separateForwardCost<Derived, Targets...>() <
+                          forwardModeCost<Derived, Targets...>())> {};
+
+/** Chooses the JacobianMode for an expression and targets
+ *
+ * Reverse mode is used when it applies and is estimated to be cheaper, or when
+ * WAVE_GEOMETRY_AD_MODE asks for it. Otherwise, TypedJacobianEvaluator is used in a tree
+ * with unique types when it is estimated to be cheaper than forward mode (in practice,
+ * for targets matched by structure), and JacobianEvaluator for the rest.
+ */
+template <typename Derived, typename... Targets>
+struct select_jacobian_mode {
+ private:
+    using UseReverse = tmp::conjunction<
+      is_reverse_applicable<Derived, Targets...>,
+      tmp::bool_constant<WAVE_GEOMETRY_AD_MODE != WAVE_GEOMETRY_AD_FORWARD>,
+      tmp::disjunction<tmp::bool_constant<WAVE_GEOMETRY_AD_MODE == WAVE_GEOMETRY_AD_REVERSE>,
+                       is_reverse_cheaper<Derived, tmp::type_list<Targets...>>>>;
+    using UseTyped =
+      tmp::conjunction<unique_leaves_t<Derived>,
+                       is_typed_cheaper<Derived, tmp::type_list<Targets...>>>;
+
+ public:
+    static constexpr JacobianMode value =
+      UseReverse{} ? JacobianMode::Reverse
+                   : (UseTyped{} ? JacobianMode::Typed : JacobianMode::Forward);
+};
+
+template <typename Derived, typename... Targets>
+constexpr JacobianMode select_jacobian_mode<Derived, Targets...>::value;
+
+/** Whether an evaluated tree with unique types contains a leaf (by address) */
+template <typename Target,
+          typename Derived,
+          std::enable_if_t<is_leaf_or_scalar<Derived>{}, int> = 0>
+WAVE_STRONG_INLINE bool containsTarget(const Evaluator<Derived> &evaluator,
+                                       const void *target) {
+    return std::is_same<Derived, Target>{} && isSame(evaluator.expr, target);
+}
+
+template <typename Target, typename Derived, enable_if_unary_t<Derived, int> = 0>
+WAVE_STRONG_INLINE bool containsTarget(const Evaluator<Derived> &evaluator,
+                                       const void *target) {
+    return contains_same_type<Derived, Target>{} &&
+           containsTarget<Target>(evaluator.rhs_eval, target);
+}
+
+template <typename Target, typename Derived, enable_if_binary_t<Derived, int> = 0>
+WAVE_STRONG_INLINE bool containsTarget(const Evaluator<Derived> &evaluator,
+                                       const void *target) {
+    return contains_same_type<Derived, Target>{} &&
+           (containsTarget<Target>(evaluator.lhs_eval, target) ||
+            containsTarget<Target>(evaluator.rhs_eval, target));
+}
+
+/** Gets the Jacobian wrt a leaf target from the result of a ReverseJacobianEvaluator
+ *
+ * A leaf of the same type which is not the target gives a zero Jacobian.
+ */
+template <typename Derived, typename Target, typename JacobianTuple>
+WAVE_STRONG_INLINE auto getReverseJacobianWrt(std::true_type,
+                                              const JacobianTuple &jacobians,
+                                              const Evaluator<Derived> &v_eval,
+                                              const Target &target)
+  -> jacobian_t<Derived, Target> {
+    constexpr int I = tmp::find<typename unique_leaves_t<Derived>::type, Target>::value;
+    if (containsTarget<Target>(v_eval, &getWrtTarget(adl{}, target))) {
+        return std::get<I>(jacobians);
+    }
+    return jacobian_t<Derived, Target>::Zero();
+}
+
+// Version for a target the expression cannot contain
+template <typename Derived, typename Target, typename JacobianTuple>
+WAVE_STRONG_INLINE auto getReverseJacobianWrt(std::false_type,
+                                              const JacobianTuple &,
+                                              const Evaluator<Derived> &,
+                                              const Target &)
+  -> jacobian_t<Derived, Target> {
+    return jacobian_t<Derived, Target>::Zero();
+}
+
+template <typename Derived, typename... Targets>
+auto evaluateWithJacobiansIn(jacobian_mode_t<JacobianMode::Forward>,
+                             const Evaluator<Derived> &v_eval,
+                             const Targets &... targets)
+  -> std::tuple<plain_output_t<Derived>, jacobian_t<Derived, Targets>...> {
+    return evaluateWithJacobiansImpl(
+      tmp::conjunction<is_stackable_target<Targets>...>{}, v_eval, targets...);
+}
+
+template <typename Derived, typename... Targets>
+auto evaluateWithJacobiansIn(jacobian_mode_t<JacobianMode::Typed>,
+                             const Evaluator<Derived> &v_eval,
+                             const Targets &... targets)
+  -> std::tuple<plain_output_t<Derived>, jacobian_t<Derived, Targets>...> {
+    return std::make_tuple(prepareOutput(v_eval),
+                           TypedJacobianEvaluator<Derived, Targets>{v_eval, targets}
+                             .jacobian()...);
+}
+
+template <typename Derived, typename... Targets>
+auto evaluateWithJacobiansIn(jacobian_mode_t<JacobianMode::Reverse>,
+                             const Evaluator<Derived> &v_eval,
+                             const Targets &... targets)
+  -> std::tuple<plain_output_t<Derived>, jacobian_t<Derived, Targets>...> {
+    const auto init_adjoint = identity_t<Derived>{};
+    const auto j_eval =
+      ReverseJacobianEvaluator<Derived, identity_t<Derived>>{v_eval, init_adjoint};
+    const auto &jacobians = j_eval.jacobian();
+
+    return std::make_tuple(
+      prepareOutput(v_eval),
+      getReverseJacobianWrt(contains_same_type<Derived, Targets>{}, jacobians, v_eval,
+                            targets)...);
+}
+
+/** Evaluate the result of an expression tree and any number of jacobians, in a given
+ * mode rather than the one select_jacobian_mode would choose
+ *
+ * Reverse mode falls back to forward mode where it does not apply. Typed mode requires a
+ * tree with unique types.
+ */
+template <JacobianMode Mode, typename Derived, typename... Targets>
+auto evaluateWithJacobiansInMode(const ExpressionBase<Derived> &expr,
+                                 const Targets &... targets)
+  -> std::tuple<plain_output_t<Derived>, jacobian_t<Derived, Targets>...> {
+    const auto &v_eval = prepareEvaluatorTo<plain_output_t<Derived>>(expr.derived());
+    using ExprType = tmp::remove_cr_t<decltype(v_eval.expr)>;
+    constexpr auto mode =
+      (Mode == JacobianMode::Reverse && !is_reverse_applicable<ExprType, Targets...>{})
+        ? JacobianMode::Forward
+        : Mode;
+
+    return evaluateWithJacobiansIn(jacobian_mode_t<mode>{}, v_eval, targets...);
+}
+
+/** Evaluate the result of an expression tree and any number of jacobians
+ *
+ * The mode of automatic differentiation is chosen at compile time by
+ * select_jacobian_mode, from estimates of the cost of each mode for the expression and
+ * targets. The WAVE_GEOMETRY_AD_MODE macro can force forward or reverse mode.
+ */
+template <typename Derived, typename... Targets>
+auto evaluateWithJacobiansAuto(const ExpressionBase<Derived> &expr,
+                               const Targets &... targets)
+  -> std::tuple<plain_output_t<Derived>, jacobian_t<Derived, Targets>...> {
+    const auto &v_eval = prepareEvaluatorTo<plain_output_t<Derived>>(expr.derived());
+    using ExprType = tmp::remove_cr_t<decltype(v_eval.expr)>;
+
+    return evaluateWithJacobiansIn(
+      jacobian_mode_t<select_jacobian_mode<ExprType, Targets...>::value>{},
+      v_eval,
+      targets...);
+}
+
+}  // namespace internal
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_AUTOJACOBIANEVALUATOR_HPP
@@ -0,0 +1,248 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_BATCHJACOBIANEVALUATOR_HPP
+#define WAVE_GEOMETRY_BATCHJACOBIANEVALUATOR_HPP
+
+namespace wave {
+
+/** Holds the values and Jacobians of one expression shape evaluated over many inputs
+ *
+ * The Jacobians with respect to target k are stored contiguously, as one matrix of
+ * height Rows_k and width N*Cols_k. The storage is only reallocated if the number of
+ * elements changes, so a BatchJacobians object can be reused across calls to
+ * evaluateBatchWithJacobiansTo().
+ *
+ * @tparam ValueType the plain output type of the expression
+ * @tparam Jacobians the fixed-size Jacobian type for each target
+ */
+template <typename ValueType, typename... Jacobians>
+class BatchJacobians {
+    template <int K>
+    using jacobian_type = tmp::remove_cr_t<decltype(
+      std::get<K>(std::declval<std::tuple<Jacobians...>>()))>;
+
+    template <typename J>
+    using storage_type = Eigen::Matrix<typename J::Scalar,
+                                       J::RowsAtCompileTime,
+                                       Eigen::Dynamic>;
+
+ public:
+    /** Constructs an empty batch */
+    BatchJacobians() = default;
+
+    /** Constructs a batch of n elements (Doesn't initialize. It holds garbage) */
+    explicit BatchJacobians(Eigen::Index n) {
+        this->resize(n);
+    }
+
+    /** Returns the number of elements */
+    Eigen::Index size() const noexcept {
+        return static_cast<Eigen::Index>(this->values.size());
+    }
+
+    /** Resizes storage for n elements, reallocating only if the size changes */
+    void resize(Eigen::Index n) {
+        if (n != this->size()) {
+            this->values.resize(n);
+            this->resizeJacobians(n, tmp::make_index_sequence<sizeof...(Jacobians)>{});
+        }
+    }
+
+    /** Returns the value of element i */
+    ValueType &value(Eigen::Index i) {
+        return this->values[i];
+    }
+
+    /** Returns the value of element i */
+    const ValueType &value(Eigen::Index i) const {
+        return this->values[i];
+    }
+
+    /** Returns a block holding the Jacobian of element i with respect to target K */
+    template <int K>
+    auto jacobian(Eigen::Index i) {
+        constexpr int Cols = jacobian_type<K>::ColsAtCompileTime;
+        return std::get<K>(this->jacobian_storage).template middleCols<Cols>(i * Cols);
+    }
+
+    /** Returns a const block holding the Jacobian of element i with respect to target K
+     */
+    template <int K>
+    auto jacobian(Eigen::Index i) const {
+        constexpr int Cols = jacobian_type<K>::ColsAtCompileTime;
+        return std::get<K>(this->jacobian_storage).template middleCols<Cols>(i * Cols);
+    }
+
+    /** Returns the contiguous matrix of all Jacobians with respect to target K */
+    template <int K>
+    const storage_type<jacobian_type<K>> &jacobians() const noexcept {
+        return std::get<K>(this->jacobian_storage);
+    }
+
+ private:
+    template <int... I>
+    void resizeJacobians(Eigen::Index n, tmp::index_sequence<I...>) {
+        auto dummy = {
+          (std::get<I>(this->jacobian_storage)
+             .resize(Eigen::NoChange, n * jacobian_type<I>::ColsAtCompileTime),
+           0)...};
+        (void) dummy;
+    }
+
+    std::vector<ValueType, Eigen::aligned_allocator<ValueType>> values;
+    std::tuple<storage_type<Jacobians>...> jacobian_storage;
+};
+
+namespace internal {
+
+/** The expression type produced by calling factory with one element of each input */
+template <typename Factory, typename... Inputs>
+using batch_expr_t = tmp::remove_cr_t<decltype(std::declval<const Factory &>()(
+  std::declval<const typename Inputs::value_type &>()...))>;
+
+/** The BatchJacobians type produced by evaluateBatchWithJacobians() */
+template <typename Factory, typename... Inputs>
+using batch_jacobians_t =
+  BatchJacobians<plain_output_t<batch_expr_t<Factory, Inputs...>>,
+                 jacobian_t<batch_expr_t<Factory, Inputs...>,
+                            typename Inputs::value_type>...>;
+
+/** Tags for the method used to evaluate each element of a batch */
+struct batch_forward {};
+struct batch_forward_typed {};
+struct batch_reverse {};
+
+/** Chooses how to evaluate the Jacobians of Derived with respect to Targets
+ *
+ * If the targets are exactly the unique leaves of the tree, in order, one reverse-mode
+ * sweep produces all Jacobians. Otherwise, forward mode is used as in
+ * evaluateWithJacobiansAuto().
+ */
+template <typename Derived, typename TargetList, typename = void>
+struct batch_method {
+    using type = batch_forward;
+};
+
+template <typename Derived, typename TargetList>
+struct batch_method<Derived, TargetList, std::enable_if_t<unique_leaves_t<Derived>{}>> {
+    using type = std::conditional_t<
+      std::is_same<typename unique_leaves_t<Derived>::type, TargetList>{},
+      batch_reverse,
+      batch_forward_typed>;
+};
+
+template <typename Derived, typename... Targets>
+using batch_method_t = typename batch_method<Derived, tmp::type_list<Targets...>>::type;
+
+/** Writes the value and Jacobians of one element, using ReverseJacobianEvaluator */
+template <typename Derived, typename Out, int... I, typename... Targets>
+WAVE_STRONG_INLINE void evaluateBatchElement(batch_reverse,
+                                             const Derived &expr,
+                                             Out &out,
+                                             Eigen::Index i,
+                                             tmp::index_sequence<I...>,
+                                             const Targets &...) {
+    using OutputType = plain_output_t<Derived>;
+    const auto &v_eval = prepareEvaluatorTo<OutputType>(expr);
+    using ExprType = tmp::remove_cr_t<decltype(v_eval.expr)>;
+
+    out.value(i) = prepareOutput(v_eval);
+    const ReverseJacobianEvaluator<ExprType, identity_t<ExprType>> j_eval{
+      v_eval, identity_t<ExprType>{}};
+    const auto &jacobians = j_eval.jacobian();
+    auto dummy = {
+      (out.template jacobian<I>(i) = getReverseJacobian<Derived, ExprType, I>(jacobians),
+       0)...};
+    (void) dummy;
+}
+
+/** Writes the value and Jacobians of one element, using TypedJacobianEvaluator */
+template <typename Derived, typename Out, int... I, typename... Targets>
+WAVE_STRONG_INLINE void evaluateBatchElement(batch_forward_typed,
+                                             const Derived &expr,
+                                             Out &out,
+                                             Eigen::Index i,
+                                             tmp::index_sequence<I...>,
+                                             const Targets &... targets) {
+    using OutputType = plain_output_t<Derived>;
+    const auto &v_eval = prepareEvaluatorTo<OutputType>(expr);
+    using ExprType = tmp::remove_cr_t<decltype(v_eval.expr)>;
+
+    out.value(i) = prepareOutput(v_eval);
+    auto dummy = {
+      (out.template jacobian<I>(i) =
+         TypedJacobianEvaluator<ExprType, Targets>{v_eval, targets}.jacobian(),
+       0)...};
+    (void) dummy;
+}
+
+/** Writes the value and Jacobians of one element, using JacobianEvaluator */
+template <typename Derived, typename Out, int... I, typename... Targets>
+WAVE_STRONG_INLINE void evaluateBatchElement(batch_forward,
+                                             const Derived &expr,
+                                             Out &out,
+                                             Eigen::Index i,
+                                             tmp::index_sequence<I...>,
+                                             const Targets &... targets) {
+    using OutputType = plain_output_t<Derived>;
+    const auto &v_eval = prepareEvaluatorTo<OutputType>(expr);
+
+    out.value(i) = prepareOutput(v_eval);
+    auto dummy = {(out.template jacobian<I>(i) =
+                     evaluateOneJacobian(v_eval, getWrtTarget(adl{}, targets)),
+                   0)...};
+    (void) dummy;
+}
+
+}  // namespace internal
+
+/** Evaluates one expression shape, and its Jacobians, over many inputs
+ *
+ * For each i, `factory(inputs[i]...)` must return an expression of the leaves it is
+ * given. The value is written to `out.value(i)` and the Jacobian with respect to the
+ * k-th argument to `out.jacobian<k>(i)`.
+ *
+ * The expression and evaluator types, and the differentiation method, are resolved once
+ * for the whole batch. Results are written directly to the preallocated output instead of
+ * being returned in a tuple. If the arguments to `factory` are exactly the unique leaves
+ * of the expression, in order, all Jacobians are found in one reverse-mode sweep.
+ *
+ * @param out the output, resized if necessary
+ * @param factory a callable taking one element of each input
+ * @param inputs containers of leaves, all of the same size
+ */
+template <typename Factory, typename... Inputs>
+void evaluateBatchWithJacobiansTo(internal::batch_jacobians_t<Factory, Inputs...> &out,
+                                  const Factory &factory,
+                                  const Inputs &... inputs) {
+    using Derived = internal::batch_expr_t<Factory, Inputs...>;
+    using Method =
+      internal::batch_method_t<Derived, typename Inputs::value_type...>;
+    const auto &indices = tmp::make_index_sequence<sizeof...(Inputs)>{};
+
+    const auto n = static_cast<Eigen::Index>(std::get<0>(std::tie(inputs...)).size());
+    out.resize(n);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        internal::evaluateBatchElement(
+          Method{}, factory(inputs[i]...), out, i, indices, inputs[i]...);
+    }
+}
+
+/** Evaluates one expression shape, and its Jacobians, over many inputs
+ *
+ * @see evaluateBatchWithJacobiansTo()
+ * @returns a BatchJacobians object holding the values and Jacobians
+ */
+template <typename Factory, typename... Inputs>
+auto evaluateBatchWithJacobians(const Factory &factory, const Inputs &... inputs)
+  -> internal::batch_jacobians_t<Factory, Inputs...> {
+    internal::batch_jacobians_t<Factory, Inputs...> out;
+    evaluateBatchWithJacobiansTo(out, factory, inputs...);
+    return out;
+}
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_BATCHJACOBIANEVALUATOR_HPP
@@ -14,9 +14,25 @@ namespace internal {
 template <typename Derived, typename = void>
 struct DynamicJacobianEvaluator;
 
-// Convenience typedef for dynamic-size matrix
+// Convenience typedef for dynamic-size matrix. Its size is bounded, so it is stored
+// inline and never allocates.
 template <typename ScalarType>
-using DynamicMatrix = Eigen::Matrix<ScalarType, Eigen::Dynamic, Eigen::Dynamic>;
+using DynamicMatrix = Eigen::Matrix<ScalarType,
+                                    Eigen::Dynamic,
+                                    Eigen::Dynamic,
+                                    Eigen::ColMajor,
+                                    WAVE_GEOMETRY_MAX_TANGENT_SIZE,
+                                    WAVE_GEOMETRY_MAX_TANGENT_SIZE>;
+
+/** Checks at compile time that Jacobians of a tangent size fit in a DynamicMatrix */
+template <int TangentSize>
+struct check_dynamic_jacobian_size {
+    static_assert(TangentSize != Eigen::Dynamic &&
+                    TangentSize <= WAVE_GEOMETRY_MAX_TANGENT_SIZE,
+                  "Tangent size is too large for a dynamic Jacobian. Define "
+                  "WAVE_GEOMETRY_MAX_TANGENT_SIZE to a larger value.");
+    using type = void;
+};
 
 /** Specialization for leaf expression */
 template <typename Derived>
@@ -25,6 +41,7 @@ struct DynamicJacobianEvaluator<Derived, enable_if_leaf_or_scalar_t<Derived>> {
 
  private:
     static constexpr int JSize = traits<Derived>::TangentSize;
+    using CheckSize = typename check_dynamic_jacobian_size<JSize>::type;
 
  public:
     WAVE_STRONG_INLINE DynamicJacobianEvaluator(const Evaluator<Derived> &evaluator,
@@ -56,6 +73,7 @@ template <typename Derived>
 struct DynamicJacobianEvaluator<Derived, enable_if_unary_t<Derived>> {
     using DynamicJacobian = DynamicMatrix<scalar_t<Derived>>;
     enum : int { TangentSize = eval_traits<Derived>::TangentSize };
+    using CheckSize = typename check_dynamic_jacobian_size<TangentSize>::type;
     using RhsEval = DynamicJacobianEvaluator<typename traits<Derived>::RhsDerived>;
 
  private:
@@ -101,6 +119,7 @@ template <typename Derived>
 struct DynamicJacobianEvaluator<Derived, enable_if_binary_t<Derived>> {
     using DynamicJacobian = DynamicMatrix<scalar_t<Derived>>;
     enum : int { TangentSize = eval_traits<Derived>::TangentSize };
+    using CheckSize = typename check_dynamic_jacobian_size<TangentSize>::type;
     using LhsEval = DynamicJacobianEvaluator<typename traits<Derived>::LhsDerived>;
     using RhsEval = DynamicJacobianEvaluator<typename traits<Derived>::RhsDerived>;
 
@@ -55,18 +55,21 @@ auto getLeavesMap(const Derived &expr, std::size_t expected_size = 0)
 
     // Sort the vector
     std::sort(vec.begin(), vec.end(), [](auto &a, auto &b) { return a.first < b.first; });
-    // Don't remove duplicates; the flat_map will do it on insert
+    // Don't remove duplicates; the LeafRegistry will do it on insert
 
     return vec;
 }
 
-/** Either initialize a matrix in the map, or add to an existing matrix
- * Insert a new element into the map if it's not there */
+/** Add to the matrix for a leaf in the map
+ *
+ * The leaf's ID is taken from the map's expected order of visits if the leaf comes next
+ * in it, and looked up otherwise.
+ */
 template <typename Scalar, typename Adjoint>
 void updateJacobianMap(DynamicReverseResult<Scalar> &jac_map,
                        const void *target,
                        const Adjoint &adjoint) {
-    jac_map[target] += adjoint;
+    jac_map.block(jac_map.visit(target)) += adjoint;
 }
 
 /** Specialization for leaf expression */
@@ -221,21 +224,49 @@ auto evaluateDynamicReverseJacobiansHelper(
     }
 }
 
+/** Evaluate all leaf Jacobians in reverse mode using an existing Evaluator tree, into an
+ * existing map
+ *
+ * The map is zeroed in place. Its registry of leaves is rebuilt only if the leaves differ
+ * from those it last held, so a map reused for the same expression does not allocate.
+ *
+ * @param[out] jac_map map of leaf address to Jacobians as dynamic matrices
+ * @param init_adjoint the adjoint of the root, with one column per tangent dimension.
+ * Each leaf's block is its product with the leaf's Jacobian.
+ */
+template <typename Derived, typename Adjoint>
+WAVE_STRONG_INLINE void evaluateDynamicReverseJacobiansTo(
+  DynamicReverseResult<scalar_t<Derived>> &jac_map,
+  const Evaluator<Derived> &v_eval,
+  const Adjoint &init_adjoint) {
+    // Collect leaves in the order the reverse pass visits them, so each is given its ID
+    // by position rather than looked up. The vector is kept to reuse its storage.
+    static thread_local DynamicLeavesVec leaves;
+    leaves.clear();
+    getLeaves(adl{}, leaves, v_eval.expr);
+    jac_map.assign(leaves.begin(), leaves.end(), init_adjoint.rows());
+
+    evaluateDynamicReverseJacobiansImpl(jac_map, v_eval, init_adjoint);
+}
+
+/** Evaluate all leaf Jacobians in reverse mode using an existing Evaluator tree, into an
+ * existing map
+ */
+template <typename Derived>
+WAVE_STRONG_INLINE void evaluateDynamicReverseJacobiansTo(
+  DynamicReverseResult<scalar_t<Derived>> &jac_map, const Evaluator<Derived> &v_eval) {
+    evaluateDynamicReverseJacobiansTo(jac_map, v_eval, identity_t<Derived>{});
+}
+
 /** Evaluate all leaf Jacobians in reverse mode using an existing Evaluator tree.
  *
- * @param expected_leaves number of leaves to preallocate (a few bytes) for
- * @return result and map of leaf address to Jacobians as dynamic matrices
+ * @return map of leaf address to Jacobians as dynamic matrices
  */
 template <typename Derived>
-WAVE_STRONG_INLINE auto evaluateDynamicReverseJacobians(const Evaluator<Derived> &v_eval,
-                                                        std::size_t expected_leaves = 256)
+WAVE_STRONG_INLINE auto evaluateDynamicReverseJacobians(const Evaluator<Derived> &v_eval)
   -> DynamicReverseResult<scalar_t<Derived>> {
-    const auto leaves = getLeavesMap(v_eval.expr, expected_leaves);
-    auto jac_map = MatrixMap<const void *, scalar_t<Derived>>{
-      leaves.begin(), leaves.end(), eval_traits<Derived>::TangentSize};
-    jac_map.setZero();
-
-    evaluateDynamicReverseJacobiansImpl(jac_map, v_eval, identity_t<Derived>{});
+    auto jac_map = DynamicReverseResult<scalar_t<Derived>>{};
+    evaluateDynamicReverseJacobiansTo(jac_map, v_eval);
     return jac_map;
 }
 
@@ -257,6 +288,47 @@ WAVE_STRONG_INLINE auto evaluateWithDynamicReverseJacobians(
     return {prepareOutput(v_eval), evaluateDynamicReverseJacobians(v_eval)};
 }
 
+/** Evaluate result, and the products of an adjoint with all Jacobians, in reverse mode
+ *
+ * The reverse pass starts from the given adjoint instead of the identity, so a weight
+ * such as a square-root information matrix is applied as the adjoint propagates.
+ *
+ * @param adjoint a k*m matrix, where m is the tangent size of the expression
+ * @return result and map of leaf address to k*n products of the adjoint and Jacobians
+ */
+template <typename Derived, typename AdjointDerived>
+WAVE_STRONG_INLINE auto evaluateWithDynamicReverseJacobians(
+  const ExpressionBase<Derived> &expr, const Eigen::MatrixBase<AdjointDerived> &adjoint)
+  -> std::pair<plain_output_t<Derived>, DynamicReverseResult<scalar_t<Derived>>> {
+    static_assert(static_cast<int>(AdjointDerived::ColsAtCompileTime) ==
+                    static_cast<int>(eval_traits<Derived>::TangentSize),
+                  "The adjoint must have one column per tangent dimension of the "
+                  "expression");
+    using OutputType = plain_output_t<Derived>;
+    const auto &v_eval = prepareEvaluatorTo<OutputType>(expr.derived());
+    const eigen_plain_t<AdjointDerived> &init_adjoint = adjoint.derived();
+    auto jac_map = DynamicReverseResult<scalar_t<Derived>>{};
+    evaluateDynamicReverseJacobiansTo(jac_map, v_eval, init_adjoint);
+    return {prepareOutput(v_eval), std::move(jac_map)};
+}
+
+/** Evaluate result and all Jacobians in reverse mode, writing the Jacobians to an
+ * existing map
+ *
+ * @see evaluateDynamicReverseJacobiansTo()
+ * @param[out] jac_map map of leaf address to Jacobians, reused across calls
+ * @return result
+ */
+template <typename Derived>
+WAVE_STRONG_INLINE auto evaluateWithDynamicReverseJacobiansTo(
+  DynamicReverseResult<scalar_t<Derived>> &jac_map, const ExpressionBase<Derived> &expr)
+  -> plain_output_t<Derived> {
+    using OutputType = plain_output_t<Derived>;
+    const auto &v_eval = prepareEvaluatorTo<OutputType>(expr.derived());
+    evaluateDynamicReverseJacobiansTo(jac_map, v_eval);
+    return prepareOutput(v_eval);
+}
+
 }  // namespace internal
 }  // namespace wave
 
@@ -10,9 +10,8 @@ namespace internal {
 
 /** Functor to evaluate an expression tree
  *
- * For now, the expression is evaluated as-is
- * In future, optimizations could go here. For example,
- * q1.inverse() * q2.inverse() -> (q2 * q1).inverse()
+ * The expression is evaluated as-is. Simplifications such as
+ * q1.inverse() * q2.inverse() -> (q2 * q1).inverse() are done before, by rewriteExpr().
  *
  */
 template <typename Derived, typename = void>
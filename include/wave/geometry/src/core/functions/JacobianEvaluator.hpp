@@ -275,7 +275,30 @@ auto evaluateJacobian(const ExpressionBase<Derived> &expr, const Target &target)
     return evaluateOneJacobian(v_eval, getWrtTarget(adl{}, target));
 }
 
+/** Finds Jacobians one target at a time, for targets matched by structure */
+template <typename Derived, typename... Targets>
+auto evaluateWithJacobiansImpl(std::false_type,
+                               const Evaluator<Derived> &v_eval,
+                               const Targets &... targets)
+  -> std::tuple<plain_output_t<Derived>, jacobian_t<Derived, Targets>...> {
+    return std::make_tuple(prepareOutput(v_eval),
+                           evaluateOneJacobian(v_eval, getWrtTarget(adl{}, targets))...);
+}
+
+/** Finds Jacobians wrt leaves, scalars or proxies together, in one stacked pass */
+template <typename Derived, typename... Targets>
+auto evaluateWithJacobiansImpl(std::true_type,
+                               const Evaluator<Derived> &v_eval,
+                               const Targets &... targets)
+  -> std::tuple<plain_output_t<Derived>, jacobian_t<Derived, Targets>...> {
+    return evaluateWithStackedJacobiansImpl(
+      v_eval, tmp::make_index_sequence<sizeof...(Targets)>{}, targets...);
+}
+
 /** Evaluate the result of an expression tree and any number of jacobians
+ *
+ * If all targets are leaves, scalars or proxies, their Jacobians are found together in
+ * one pass (see evaluateWithStackedJacobians()). Otherwise, each is found separately.
  *
  * @return the value of the expression
  * @param targets N dependent leaf expressions
@@ -288,8 +311,8 @@ auto evaluateWithJacobians(const ExpressionBase<Derived> &expr,
     // Get the value once
     const auto &v_eval = prepareEvaluatorTo<plain_output_t<Derived>>(expr.derived());
 
-    return std::make_tuple(prepareOutput(v_eval),
-                           evaluateOneJacobian(v_eval, getWrtTarget(adl{}, targets))...);
+    return evaluateWithJacobiansImpl(
+      tmp::conjunction<is_stackable_target<Targets>...>{}, v_eval, targets...);
 }
 
 }  // namespace internal
@@ -8,6 +8,14 @@
 namespace wave {
 namespace internal {
 
+/** Builds the prepared expression given by a plan (see prepared_plans)
+ *
+ * The plan for an operand may not be the operand's own PreparedType, if the parent
+ * expression found a cheaper combination of conversions.
+ */
+template <typename Plan, typename Derived, typename = void>
+struct PreparePlan;
+
 /**
  * Transforms the expression tree: keeps leaves intact, but converts unary and binary
  * expressions to their traits::PreparedType
@@ -23,17 +31,46 @@ struct PrepareExpr<Derived, enable_if_leaf_or_scalar_t<tmp::remove_cr_t<Derived>
 
 template <typename Derived>
 struct PrepareExpr<Derived, enable_if_unary_t<tmp::remove_cr_t<Derived>>> {
-    using OutType = tmp::remove_cr_t<typename traits<Derived>::PreparedType>;
-    using Rhs = typename traits<Derived>::RhsDerived;
+    using Plan = tmp::front_t<prepared_plans_t<Derived>>;
 
     static auto run(const Derived &unary) {
-        return OutType{PrepareExpr<Rhs>::run(unary.derived().rhs())};
+        return PreparePlan<Plan, tmp::remove_cr_t<Derived>>::run(unary);
     }
 };
 
 template <typename Derived>
 struct PrepareExpr<Derived, enable_if_binary_t<tmp::remove_cr_t<Derived>>> {
-    using OutType = tmp::remove_cr_t<typename traits<Derived>::PreparedType>;
+    using Plan = tmp::front_t<prepared_plans_t<Derived>>;
+
+    static auto run(const Derived &binary) {
+        return PreparePlan<Plan, tmp::remove_cr_t<Derived>>::run(binary);
+    }
+};
+
+/** A plan with no recorded operands is the expression's PreparedType */
+template <typename Type, typename Eval, int Cost, typename Derived>
+struct PreparePlan<prepared_plan<Type, Eval, Cost>,
+                   Derived,
+                   std::enable_if_t<!is_unary_expression<Derived>{} &&
+                                    !is_binary_expression<Derived>{}>> {
+    static decltype(auto) run(const Derived &leaf) {
+        return PrepareExpr<Derived>::run(leaf);
+    }
+};
+
+template <typename Type, typename Eval, int Cost, typename Derived>
+struct PreparePlan<prepared_plan<Type, Eval, Cost>, Derived, enable_if_unary_t<Derived>> {
+    using OutType = tmp::remove_cr_t<Type>;
+    using Rhs = typename traits<Derived>::RhsDerived;
+
+    static auto run(const Derived &unary) {
+        return OutType{PrepareExpr<Rhs>::run(unary.derived().rhs())};
+    }
+};
+
+template <typename Type, typename Eval, int Cost, typename Derived>
+struct PreparePlan<prepared_plan<Type, Eval, Cost>, Derived, enable_if_binary_t<Derived>> {
+    using OutType = tmp::remove_cr_t<Type>;
     using Lhs = typename traits<Derived>::LhsDerived;
     using Rhs = typename traits<Derived>::RhsDerived;
 
@@ -43,6 +80,45 @@ struct PrepareExpr<Derived, enable_if_binary_t<tmp::remove_cr_t<Derived>>> {
     }
 };
 
+/** A plan with one operand plan prepares the rhs with it */
+template <typename Type, typename Eval, int Cost, typename RhsPlan, typename Derived>
+struct PreparePlan<prepared_plan<Type, Eval, Cost, RhsPlan>, Derived> {
+    using OutType = tmp::remove_cr_t<Type>;
+    using Rhs = typename traits<Derived>::RhsDerived;
+
+    static auto run(const Derived &unary) {
+        return OutType{PreparePlan<RhsPlan, Rhs>::run(unary.derived().rhs())};
+    }
+};
+
+/** A plan with two operand plans prepares the lhs and rhs with them */
+template <typename Type,
+          typename Eval,
+          int Cost,
+          typename LhsPlan,
+          typename RhsPlan,
+          typename Derived>
+struct PreparePlan<prepared_plan<Type, Eval, Cost, LhsPlan, RhsPlan>, Derived> {
+    using OutType = tmp::remove_cr_t<Type>;
+    using Lhs = typename traits<Derived>::LhsDerived;
+    using Rhs = typename traits<Derived>::RhsDerived;
+
+    static auto run(const Derived &binary) {
+        return OutType{PreparePlan<LhsPlan, Lhs>::run(binary.derived().lhs()),
+                       PreparePlan<RhsPlan, Rhs>::run(binary.derived().rhs())};
+    }
+};
+
+/** A conversion plan prepares the expression itself, then wraps it in a Convert */
+template <typename Plan, typename To, typename Derived>
+struct PreparePlan<converted_plan<Plan, To>, Derived> {
+    using OutType = Convert<To, typename Plan::type>;
+
+    static auto run(const Derived &expr) {
+        return OutType{PreparePlan<Plan, Derived>::run(expr)};
+    }
+};
+
 /** Functor which returns the given argument
  * To be used an OutputFunctor */
 struct IdentityFunctor {
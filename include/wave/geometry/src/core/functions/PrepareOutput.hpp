@@ -11,19 +11,25 @@ namespace internal {
 
 /** Prepare an expression tree with the given Target, and initialize an Evaluator
  * Internal implementation - does not check whether root needs conversion.
+ *
+ * The expression is first rewritten by rewriteExpr(), then transformed by PrepareExpr.
+ *
+ * @tparam Goal rewrite_for_value or rewrite_for_jacobians
  */
-template <typename Derived>
+template <typename Goal, typename Derived>
 WAVE_STRONG_INLINE auto prepareEvaluator(Derived &&expr) {
-    // First, transform the expression
-    const auto &evaluable_expr =
-      PrepareExpr<tmp::remove_cr_t<Derived>>::run(std::forward<Derived>(expr));
+    // First, rewrite and transform the expression
+    using Rewritten = rewrite_t<Derived, Goal>;
+    const auto &rewritten_expr = rewriteExpr<Goal>(expr);
+    const auto &evaluable_expr = PrepareExpr<Rewritten>::run(rewritten_expr);
     using ExprType = tmp::remove_cr_t<decltype(evaluable_expr)>;
 
     // Construct Evaluator tree
     return Evaluator<ExprType>{evaluable_expr};
 
     static_assert(
-      std::is_same<ExprType, tmp::remove_cr_t<typename traits<Derived>::PreparedType>>{},
+      std::is_same<ExprType,
+                   tmp::remove_cr_t<typename traits<Rewritten>::PreparedType>>{},
       "Internal sanity check");
 }
 
@@ -31,18 +37,20 @@ WAVE_STRONG_INLINE auto prepareEvaluator(Derived &&expr) {
  *
  * This function is enabled when the Destination type is already produced by the
  * expression, so no additional Convert is applied to the root. However, the expression is
- * modified according to the PreparedType of each node.
+ * rewritten, and modified according to the PreparedType of each node.
  *
+ * @tparam Goal rewrite_for_jacobians, unless only the value will be evaluated
  * @returns an Evaluator of the expression's PreparedType
  * @note The expression stored in `prepareEvaluatorTo<T>(expr).expr`) is *not*
  * necessarily the same as the input `expr`.
  */
 template <
   typename Destination,
+  typename Goal = rewrite_for_jacobians,
   typename Derived,
   std::enable_if_t<std::is_same<eval_t<Destination>, eval_t<arg_t<Derived>>>{}, int> = 0>
 WAVE_STRONG_INLINE auto prepareEvaluatorTo(Derived &&expr) {
-    return prepareEvaluator(std::forward<Derived>(expr));
+    return prepareEvaluator<Goal>(std::forward<Derived>(expr));
 }
 
 /** Prepare an expression tree with the given Target, and initialize an Evaluator.
@@ -50,12 +58,14 @@ WAVE_STRONG_INLINE auto prepareEvaluatorTo(Derived &&expr) {
  * Applies a conversion to the root of the tree to produce the desired Destination type,
  * then modifies it according to the PreparedType of each node.
  *
+ * @tparam Goal rewrite_for_jacobians, unless only the value will be evaluated
  * @returns an Evaluator of the expression's PreparedType
  * @note The expression stored in `prepareEvaluatorTo<T>(expr).expr`) is *not*
  * necessarily the same as the input `expr`.
  */
 template <
   typename Destination,
+  typename Goal = rewrite_for_jacobians,
   typename Derived,
   std::enable_if_t<!std::is_same<eval_t<Destination>, eval_t<arg_t<Derived>>>{}, int> = 0>
 WAVE_STRONG_INLINE auto prepareEvaluatorTo(Derived &&expr) {
@@ -68,7 +78,7 @@ WAVE_STRONG_INLINE auto prepareEvaluatorTo(Derived &&expr) {
     static_assert(std::is_same<eval_t<Destination>, eval_t<ConvertedType>>{},
                   "Internal sanity check");
 
-    return prepareEvaluatorTo<Destination>(std::move(converted_expr));
+    return prepareEvaluatorTo<Destination, Goal>(std::move(converted_expr));
 }
 
 /** Applies output functor to the result of an evaluator tree
@@ -92,8 +102,9 @@ decltype(auto) prepareOutput(const Evaluator<Derived> &evaluator) {
  */
 template <typename Destination, typename Derived>
 auto evaluateTo(Derived &&expr) -> Destination {
-    // Construct Evaluator tree
-    const auto &evaluator = prepareEvaluatorTo<Destination>(std::forward<Derived>(expr));
+    // Construct Evaluator tree. Only the value is needed, so it can be rewritten for that
+    const auto &evaluator =
+      prepareEvaluatorTo<Destination, rewrite_for_value>(std::forward<Derived>(expr));
 
     // Evaluate and apply output functor (e.g. wrap in Framed)
     return prepareOutput(evaluator);
@@ -144,28 +144,22 @@ struct ReverseJacobianEvaluator<Derived, Adjoint, enable_if_binary_t<Derived>> {
     }
 };
 
-/** Helper to make a tuple of values from a tuple of references.
+/** Gets the Jacobian with respect to the K-th unique leaf of Derived
  *
- * This is needed because in the case `size == 1`, calling tuple's constructor
- * tuple<Matrix>(tuple<const Matrix&>) will try to construct a Matrix from a tuple
- * (because of the changes to tuple.cnstr in https://cplusplus.github.io/LWG/issue2549,
- * combined with Eigen::Matrix's overly greedy templated constructor).
+ * Rewriting can reorder the leaves of an expression, so the leaf is found by type.
+ *
+ * @param jacobians the JacobianTuple of a ReverseJacobianEvaluator<ExprType, ...>, where
+ * ExprType is the type Derived was rewritten and prepared to
  */
-template <typename Target, typename T>
-Target makeTupleFromTuple(T &&t) {
-    return Target{std::forward<T>(t)};
-};
-
-// case for size == 1
-template <typename Target, typename T>
-Target makeTupleFromTuple(const std::tuple<T> &t) {
-    return Target{std::get<0>(t)};
-};
-
-template <typename Target, typename T>
-Target makeTupleFromTuple(std::tuple<T> &&t) {
-    return Target{std::get<0>(std::move(t))};
-};
+template <typename Derived, typename ExprType, int K, typename JacobianTuple>
+WAVE_STRONG_INLINE decltype(auto) getReverseJacobian(const JacobianTuple &jacobians) {
+    using Leaf = std::tuple_element_t<
+      K,
+      tmp::apply_t<std::tuple, typename unique_leaves_t<Derived>::type>>;
+    constexpr int I = tmp::find<typename unique_leaves_t<ExprType>::type, Leaf>::value;
+    static_assert(I >= 0, "Internal error: a rewrite rule removed a leaf");
+    return std::get<I>(jacobians);
+}
 
 template <typename Derived, typename = void>
 struct eval_with_reverse_jacobians_impl {
@@ -197,24 +191,59 @@ template <typename Derived>
 using eval_with_reverse_jacobians_t =
   typename eval_with_reverse_jacobians_impl<Derived>::type;
 
+template <typename Derived, int Rows, typename = void>
+struct eval_with_adjoint_jacobians_impl {
+    using type = NotAllowed;
+};
+
+template <typename Derived, int Rows>
+struct eval_with_adjoint_jacobians_impl<Derived,
+                                        Rows,
+                                        std::enable_if_t<unique_leaves_t<Derived>{}>> {
+    template <typename Leaf>
+    using adjoint_jacobian_t =
+      Eigen::Matrix<scalar_t<Derived>, Rows, eval_traits<Leaf>::TangentSize>;
+
+    using type = tmp::apply_t<
+      std::tuple,
+      plain_output_t<Derived>,
+      tmp::apply_each_t<adjoint_jacobian_t, typename unique_leaves_t<Derived>::type>>;
+};
+
+/** The expected return type of evaluateWithReverseJacobians() given an adjoint with Rows
+ * rows: the value, then the product of the adjoint and each leaf's Jacobian.
+ *
+ * @warning this alias gives NotAllowed if unique_leaves_t<Derived>::value is false.
+ */
+template <typename Derived, int Rows>
+using eval_with_adjoint_jacobians_t =
+  typename eval_with_adjoint_jacobians_impl<Derived, Rows>::type;
+
 
 /** Evaluate the result of an expression tree and all jacobians
  *
- * @return a tuple of the value of the expression and all jacobians
+ * @tparam ReturnType a tuple of the value and one Jacobian per unique leaf of Derived
+ * @tparam Derived the original expression type
+ * @param v_eval an evaluator of the tree Derived was rewritten and prepared to
+ * @param init_adjoint the adjoint of the root, with one column per tangent dimension
+ * @return a tuple of the value of the expression and the products of init_adjoint and
+ * the jacobians with respect to the unique leaves of Derived, in order
  */
-template <
-  typename Derived,
-  typename ExprJacobianTuple =
-    typename ReverseJacobianEvaluator<Derived, identity_t<Derived>>::JacobianTuple,
-  typename JacobianTuple = tmp::apply_each_t<eigen_plain_t, ExprJacobianTuple>>
-WAVE_STRONG_INLINE auto evaluateWithReverseJacobiansImpl(const Evaluator<Derived> &v_eval)
-  -> tmp::concat_t<std::tuple<plain_output_t<Derived>>, JacobianTuple> {
+template <typename ReturnType,
+          typename Derived,
+          typename ExprType,
+          typename Adjoint,
+          int... K>
+WAVE_STRONG_INLINE auto evaluateWithReverseJacobiansImpl(
+  const Evaluator<ExprType> &v_eval,
+  const Adjoint &init_adjoint,
+  tmp::index_sequence<K...>) -> ReturnType {
     // Make the ReverseJacobianEvaluator tree
-    internal::ReverseJacobianEvaluator<Derived, identity_t<Derived>> j_eval{
-      v_eval, identity_t<Derived>{}};
+    internal::ReverseJacobianEvaluator<ExprType, Adjoint> j_eval{v_eval, init_adjoint};
+    const auto &jacobians = j_eval.jacobian();
 
-    return std::tuple_cat(std::forward_as_tuple(prepareOutput(v_eval)),
-                          makeTupleFromTuple<JacobianTuple>(j_eval.jacobian()));
+    return ReturnType{prepareOutput(v_eval),
+                      getReverseJacobian<Derived, ExprType, K>(jacobians)...};
 }
 
 /** Evaluate the result of an expression tree and all jacobians
@@ -232,13 +261,46 @@ WAVE_STRONG_INLINE auto evaluateWithReverseJacobians(const ExpressionBase<Derive
     using OutputType = plain_output_t<Derived>;
     const auto &v_eval = prepareEvaluatorTo<OutputType>(expr.derived());
 
-    // Make the ReverseJacobianEvaluator tree
-    return evaluateWithReverseJacobiansImpl(v_eval);
+    // Make the ReverseJacobianEvaluator tree. The returned tuple holds the value, then
+    // one Jacobian per leaf
+    using ReturnType = eval_with_reverse_jacobians_t<Derived>;
+    const auto &leaf_indices =
+      tmp::make_index_sequence<std::tuple_size<ReturnType>{} - 1>{};
+    return evaluateWithReverseJacobiansImpl<ReturnType, Derived>(
+      v_eval, identity_t<Derived>{}, leaf_indices);
+}
+
+/** Evaluate the result of an expression tree, and the products of an adjoint with the
+ * jacobians with respect to all leaves
+ *
+ * The reverse pass starts from the given adjoint instead of the identity, so a weight
+ * such as a square-root information matrix is applied as the adjoint propagates, and the
+ * full jacobians are never formed.
+ *
+ * @param adjoint a k*m matrix, where m is the tangent size of the expression
+ * @return a tuple of the value of the expression and, for each unique leaf in order, the
+ * k*n product of the adjoint and the jacobian with respect to that leaf
+ */
+template <typename Derived,
+          typename AdjointDerived,
+          TICK_REQUIRES(unique_leaves_t<Derived>{})>
+WAVE_STRONG_INLINE auto evaluateWithReverseJacobians(
+  const ExpressionBase<Derived> &expr, const Eigen::MatrixBase<AdjointDerived> &adjoint)
+  -> eval_with_adjoint_jacobians_t<Derived, AdjointDerived::RowsAtCompileTime> {
+    static_assert(static_cast<int>(AdjointDerived::ColsAtCompileTime) ==
+                    static_cast<int>(eval_traits<Derived>::TangentSize),
+                  "The adjoint must have one column per tangent dimension of the "
+                  "expression");
+    using OutputType = plain_output_t<Derived>;
+    const auto &v_eval = prepareEvaluatorTo<OutputType>(expr.derived());
 
-    using RetType = tmp::remove_cr_t<decltype(evaluateWithReverseJacobiansImpl(v_eval))>;
-    static_assert(
-      std::is_constructible<eval_with_reverse_jacobians_t<Derived>, RetType>{},
-      "Internal sanity check: expected reverse evaluator return type");
+    using ReturnType =
+      eval_with_adjoint_jacobians_t<Derived, AdjointDerived::RowsAtCompileTime>;
+    const auto &leaf_indices =
+      tmp::make_index_sequence<std::tuple_size<ReturnType>{} - 1>{};
+    const eigen_plain_t<AdjointDerived> &init_adjoint = adjoint.derived();
+    return evaluateWithReverseJacobiansImpl<ReturnType, Derived>(
+      v_eval, init_adjoint, leaf_indices);
 }
 
 }  // namespace internal
@@ -0,0 +1,158 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_REWRITEEXPR_HPP
+#define WAVE_GEOMETRY_REWRITEEXPR_HPP
+
+namespace wave {
+namespace internal {
+
+/** Transforms the expression tree into an equivalent one which is cheaper to evaluate
+ *
+ * This step runs before PrepareExpr. The tree is rewritten bottom-up: once the children
+ * of a node are rewritten, a rule for the node is looked up by calling
+ * `rewriteImpl(adl{}, node, Goal{})`. If a rule matches, its result is rewritten again,
+ * until no rule applies.
+ *
+ * The Goal tag is rewrite_for_value if only the value will be evaluated, or
+ * rewrite_for_jacobians if Jacobians will be evaluated too. A tree that is cheapest to
+ * evaluate may not be cheapest to differentiate, so a rule can apply to only one goal.
+ *
+ * Stable expressions (such as leaves) are held by reference, so the rewritten tree refers
+ * to the same objects as the input, and Jacobians with respect to them can still be found
+ * by address. Other nodes are held by value.
+ *
+ * A rule must give an expression with the same plain output type as the node it replaces,
+ * and must not duplicate or remove leaves.
+ */
+template <typename Derived, typename Goal, typename Enable = void>
+struct RewriteExpr;
+
+/** Rewrite goal tag: only the value of the expression will be evaluated */
+struct rewrite_for_value {};
+
+/** Rewrite goal tag: the value and Jacobians of the expression will be evaluated */
+struct rewrite_for_jacobians {};
+
+/** Template argument used to hold an expression in a rewritten tree
+ *
+ * Scalars and stable expressions are held by reference, others by value.
+ */
+template <typename T>
+using rewrite_arg_t =
+  std::conditional_t<is_scalar<tmp::remove_cr_t<T>>{} ||
+                       is_stable_expression<tmp::remove_cr_t<T>>{},
+                     tmp::remove_cr_t<T> &,
+                     tmp::remove_cr_t<T>>;
+
+/** Checks whether a rewrite rule exists for the expression and goal */
+TICK_TRAIT(has_rewrite_rule) {
+    template <class T, class Goal>
+    auto require(const T &x, const Goal &goal)
+      ->valid<decltype(rewriteImpl(adl{}, x, goal))>;
+};
+
+/** Returns a node unchanged if no rewrite rule matches it */
+template <typename Goal,
+          typename Derived,
+          std::enable_if_t<!has_rewrite_rule<Derived, Goal>{}, int> = 0>
+WAVE_STRONG_INLINE auto applyRewriteRules(Derived &&node) -> Derived {
+    return std::move(node);
+}
+
+/** Applies the matching rewrite rule to a node, then rewrites the result */
+template <typename Goal,
+          typename Derived,
+          std::enable_if_t<has_rewrite_rule<Derived, Goal>{}, int> = 0>
+WAVE_STRONG_INLINE decltype(auto) applyRewriteRules(Derived &&node) {
+    using RuleResult = decltype(rewriteImpl(adl{}, node, Goal{}));
+    using Result = tmp::remove_cr_t<RuleResult>;
+    static_assert(std::is_same<plain_output_t<Result>, plain_output_t<Derived>>{},
+                  "A rewrite rule must not change the output type");
+    static_assert(!is_stable_expression<Result>{} ||
+                    std::is_lvalue_reference<RuleResult>{},
+                  "A rewrite rule must return stable expressions by reference");
+
+    return RewriteExpr<Result, Goal>::run(rewriteImpl(adl{}, node, Goal{}));
+}
+
+/** Leaves, scalars, and other stable expressions are not changed */
+template <typename Derived, typename Goal>
+struct RewriteExpr<
+  Derived,
+  Goal,
+  std::enable_if_t<is_scalar<Derived>{} || is_stable_expression<Derived>{}>> {
+    static auto run(const Derived &leaf) -> const Derived & {
+        return leaf;
+    }
+};
+
+template <typename Derived, typename Goal>
+struct RewriteExpr<Derived, Goal, enable_if_unary_t<Derived>> {
+    using Rhs = typename traits<Derived>::RhsDerived;
+    using NewRhs = decltype(RewriteExpr<Rhs, Goal>::run(std::declval<const Rhs &>()));
+    using OutType = typename traits<Derived>::template rebind<rewrite_arg_t<NewRhs>>;
+
+    static decltype(auto) run(const Derived &unary) {
+        return applyRewriteRules<Goal>(OutType{RewriteExpr<Rhs, Goal>::run(unary.rhs())});
+    }
+};
+
+template <typename Derived, typename Goal>
+struct RewriteExpr<Derived, Goal, enable_if_binary_t<Derived>> {
+    using Lhs = typename traits<Derived>::LhsDerived;
+    using Rhs = typename traits<Derived>::RhsDerived;
+    using NewLhs = decltype(RewriteExpr<Lhs, Goal>::run(std::declval<const Lhs &>()));
+    using NewRhs = decltype(RewriteExpr<Rhs, Goal>::run(std::declval<const Rhs &>()));
+    using OutType = typename traits<Derived>::template rebind<rewrite_arg_t<NewLhs>,
+                                                              rewrite_arg_t<NewRhs>>;
+
+    static decltype(auto) run(const Derived &binary) {
+        return applyRewriteRules<Goal>(
+          OutType{RewriteExpr<Lhs, Goal>::run(binary.lhs()),
+                  RewriteExpr<Rhs, Goal>::run(binary.rhs())});
+    }
+};
+
+/** Rewrites an expression tree whose root keeps its evaluated type
+ *
+ * Rules preserve the plain output type of each node, but may change its evaluated type
+ * (for example, to a lazy transpose of a matrix). Callers of Evaluator expect the same
+ * result type at the root, so if it changed, a Convert is added.
+ *
+ * @tparam Goal rewrite_for_value or rewrite_for_jacobians
+ */
+template <typename Goal, typename Derived>
+using rewritten_root_t =
+  decltype(RewriteExpr<Derived, Goal>::run(std::declval<const Derived &>()));
+
+template <typename Goal,
+          typename Derived,
+          std::enable_if_t<std::is_same<clean_eval_t<Derived>,
+                                        clean_eval_t<rewritten_root_t<Goal, Derived>>>{},
+                           int> = 0>
+decltype(auto) rewriteExpr(const Derived &expr) {
+    return RewriteExpr<Derived, Goal>::run(expr);
+}
+
+template <typename Goal,
+          typename Derived,
+          std::enable_if_t<!std::is_same<clean_eval_t<Derived>,
+                                         clean_eval_t<rewritten_root_t<Goal, Derived>>>{},
+                           int> = 0>
+auto rewriteExpr(const Derived &expr) {
+    using NewRoot = rewritten_root_t<Goal, Derived>;
+    return Convert<clean_eval_t<Derived>, rewrite_arg_t<NewRoot>>{
+      RewriteExpr<Derived, Goal>::run(expr)};
+}
+
+/** The type of the tree produced by rewriteExpr() */
+template <typename Derived, typename Goal>
+using rewrite_t = tmp::remove_cr_t<decltype(
+  rewriteExpr<Goal>(std::declval<const tmp::remove_cr_t<Derived> &>()))>;
+
+}  // namespace internal
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_REWRITEEXPR_HPP
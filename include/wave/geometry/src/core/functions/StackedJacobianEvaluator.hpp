@@ -0,0 +1,356 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_STACKEDJACOBIANEVALUATOR_HPP
+#define WAVE_GEOMETRY_STACKEDJACOBIANEVALUATOR_HPP
+
+namespace wave {
+namespace internal {
+
+/** Evaluates an expression's Jacobians with respect to several targets in forward mode,
+ * in one pass
+ *
+ * Each node holds the Jacobians wrt all targets side by side, as blocks of one stacked
+ * matrix. A node's local Jacobians are computed once, and applied to the block of each
+ * target its children may contain. Blocks of targets a node cannot contain (by type) are
+ * never computed, nor read.
+ *
+ * @tparam TargetList a tmp::type_list of the targets, which are matched by address
+ */
+template <typename Derived, typename TargetList, typename = void>
+struct StackedJacobianEvaluator;
+
+/** The column at which the Jacobian wrt the K'th target starts in a stacked Jacobian
+ *
+ * With K equal to the number of targets, the total number of columns.
+ */
+template <typename... Targets>
+constexpr int stackedJacobianOffset(int k) {
+    const int sizes[] = {eval_traits<Targets>::TangentSize..., 0};
+    int offset = 0;
+    for (int i = 0; i < k; ++i) {
+        offset += sizes[i];
+    }
+    return offset;
+}
+
+/** Whether forward-mode Jacobians wrt a target can be found in one stacked pass
+ *
+ * Stacked targets are matched by address, which requires a leaf, scalar or proxy. Other
+ * expressions are matched by structure, in JacobianEvaluator.
+ */
+template <typename Target, typename = void>
+struct is_stackable_target : tmp::bool_constant<is_leaf_or_scalar<Target>{}> {};
+
+/** Base with the stacked Jacobian matrix and helpers to access its blocks */
+template <typename Derived, typename... Targets>
+struct StackedJacobianBase {
+    enum : int {
+        TangentSize = eval_traits<Derived>::TangentSize,
+        Cols = stackedJacobianOffset<Targets...>(sizeof...(Targets))
+    };
+    using Stack = Eigen::Matrix<scalar_t<Derived>, TangentSize, Cols>;
+    using Indices = tmp::make_index_sequence<sizeof...(Targets)>;
+
+    template <int K>
+    using target_t = std::tuple_element_t<K, std::tuple<Targets...>>;
+
+    /** @returns the stacked Jacobians. Only the blocks of targets this expression may
+     * contain are set. */
+    WAVE_STRONG_INLINE const Stack &jacobian() const {
+        return this->jac;
+    }
+
+    /** @returns the block of the Jacobian wrt the K'th target */
+    template <int K>
+    WAVE_STRONG_INLINE auto block() const {
+        return this->jac.template middleCols<eval_traits<target_t<K>>::TangentSize>(
+          stackedJacobianOffset<Targets...>(K));
+    }
+
+ protected:
+    template <int K>
+    WAVE_STRONG_INLINE auto block() {
+        return this->jac.template middleCols<eval_traits<target_t<K>>::TangentSize>(
+          stackedJacobianOffset<Targets...>(K));
+    }
+
+    Stack jac;
+};
+
+/** Specialization for leaf expression */
+template <typename Derived, typename... Targets>
+struct StackedJacobianEvaluator<Derived,
+                                tmp::type_list<Targets...>,
+                                enable_if_leaf_or_scalar_t<Derived>>
+    : StackedJacobianBase<Derived, Targets...> {
+    using Base = StackedJacobianBase<Derived, Targets...>;
+
+    WAVE_STRONG_INLINE StackedJacobianEvaluator(const Evaluator<Derived> &evaluator,
+                                                const void *const *targets) {
+        this->setBlocks(evaluator, targets, typename Base::Indices{});
+    }
+
+ private:
+    template <int... K>
+    WAVE_STRONG_INLINE void setBlocks(const Evaluator<Derived> &evaluator,
+                                      const void *const *targets,
+                                      tmp::index_sequence<K...>) {
+        int foreach[] = {
+          0,
+          (this->template setBlock<K>(std::is_same<Derived, Targets>{}, evaluator, targets),
+           0)...};
+        (void) foreach;
+    }
+
+    /** Sets the (trivial) jacobian wrt a target of the same type
+     *
+     * It is identity if this leaf is the target, and zero otherwise.
+     */
+    template <int K>
+    WAVE_STRONG_INLINE void setBlock(std::true_type,
+                                     const Evaluator<Derived> &evaluator,
+                                     const void *const *targets) {
+        if (isSame(evaluator.expr, targets[K])) {
+            this->template block<K>().setIdentity();
+        } else {
+            this->template block<K>().setZero();
+        }
+    }
+
+    template <int K>
+    WAVE_STRONG_INLINE void setBlock(std::false_type,
+                                     const Evaluator<Derived> &,
+                                     const void *const *) {}
+};
+
+/** Specialization for unary expression */
+template <typename Derived, typename... Targets>
+struct StackedJacobianEvaluator<Derived,
+                                tmp::type_list<Targets...>,
+                                enable_if_unary_t<Derived>>
+    : StackedJacobianBase<Derived, Targets...> {
+    using Base = StackedJacobianBase<Derived, Targets...>;
+    using RhsDerived = typename traits<Derived>::RhsDerived;
+
+ private:
+    // Nested jacobian-evaluator
+    const StackedJacobianEvaluator<RhsDerived, tmp::type_list<Targets...>> rhs_eval;
+
+ public:
+    WAVE_STRONG_INLINE StackedJacobianEvaluator(const Evaluator<Derived> &evaluator,
+                                                const void *const *targets)
+        : rhs_eval{evaluator.rhs_eval, targets} {
+        this->setBlocks(tmp::disjunction<contains_same_type<RhsDerived, Targets>...>{},
+                        evaluator,
+                        typename Base::Indices{});
+    }
+
+ private:
+    template <int... K>
+    WAVE_STRONG_INLINE void setBlocks(std::true_type,
+                                      const Evaluator<Derived> &evaluator,
+                                      tmp::index_sequence<K...>) {
+        const auto &self_jac =
+          jacobianImpl(get_expr_tag_t<Derived>{}, evaluator(), evaluator.rhs_eval());
+        int foreach[] = {
+          0,
+          (this->template setBlock<K>(contains_same_type<RhsDerived, Targets>{}, self_jac),
+           0)...};
+        (void) foreach;
+    }
+
+    template <int... K>
+    WAVE_STRONG_INLINE void setBlocks(std::false_type,
+                                      const Evaluator<Derived> &,
+                                      tmp::index_sequence<K...>) {}
+
+    template <int K, typename SelfJacobian>
+    WAVE_STRONG_INLINE void setBlock(std::true_type, const SelfJacobian &self_jac) {
+        this->template block<K>().noalias() = self_jac * this->rhs_eval.template block<K>();
+    }
+
+    template <int K, typename SelfJacobian>
+    WAVE_STRONG_INLINE void setBlock(std::false_type, const SelfJacobian &) {}
+};
+
+/** Specialization for binary expression */
+template <typename Derived, typename... Targets>
+struct StackedJacobianEvaluator<Derived,
+                                tmp::type_list<Targets...>,
+                                enable_if_binary_t<Derived>>
+    : StackedJacobianBase<Derived, Targets...> {
+    using Base = StackedJacobianBase<Derived, Targets...>;
+    using LhsDerived = typename traits<Derived>::LhsDerived;
+    using RhsDerived = typename traits<Derived>::RhsDerived;
+
+ private:
+    // Nested jacobian-evaluators
+    const StackedJacobianEvaluator<LhsDerived, tmp::type_list<Targets...>> lhs_eval;
+    const StackedJacobianEvaluator<RhsDerived, tmp::type_list<Targets...>> rhs_eval;
+
+ public:
+    WAVE_STRONG_INLINE StackedJacobianEvaluator(const Evaluator<Derived> &evaluator,
+                                                const void *const *targets)
+        : lhs_eval{evaluator.lhs_eval, targets}, rhs_eval{evaluator.rhs_eval, targets} {
+        this->setBlocks(tmp::disjunction<contains_same_type<LhsDerived, Targets>...>{},
+                        tmp::disjunction<contains_same_type<RhsDerived, Targets>...>{},
+                        evaluator,
+                        typename Base::Indices{});
+    }
+
+ private:
+    // Each local Jacobian is computed only if some target may be on its side
+    template <int... K>
+    WAVE_STRONG_INLINE void setBlocks(std::true_type,
+                                      std::true_type,
+                                      const Evaluator<Derived> &evaluator,
+                                      tmp::index_sequence<K...>) {
+        const auto &lhs_jac = leftJacobianImpl(get_expr_tag_t<Derived>{},
+                                               evaluator(),
+                                               evaluator.lhs_eval(),
+                                               evaluator.rhs_eval());
+        const auto &rhs_jac = rightJacobianImpl(get_expr_tag_t<Derived>{},
+                                                evaluator(),
+                                                evaluator.lhs_eval(),
+                                                evaluator.rhs_eval());
+        int foreach[] = {0,
+                         (this->template setBlock<K>(contains_same_type<LhsDerived, Targets>{},
+                                                     contains_same_type<RhsDerived, Targets>{},
+                                                     lhs_jac,
+                                                     rhs_jac),
+                          0)...};
+        (void) foreach;
+    }
+
+    template <int... K>
+    WAVE_STRONG_INLINE void setBlocks(std::true_type,
+                                      std::false_type,
+                                      const Evaluator<Derived> &evaluator,
+                                      tmp::index_sequence<K...>) {
+        const auto &lhs_jac = leftJacobianImpl(get_expr_tag_t<Derived>{},
+                                               evaluator(),
+                                               evaluator.lhs_eval(),
+                                               evaluator.rhs_eval());
+        int foreach[] = {0,
+                         (this->template setBlock<K>(contains_same_type<LhsDerived, Targets>{},
+                                                     std::false_type{},
+                                                     lhs_jac,
+                                                     lhs_jac),
+                          0)...};
+        (void) foreach;
+    }
+
+    template <int... K>
+    WAVE_STRONG_INLINE void setBlocks(std::false_type,
+                                      std::true_type,
+                                      const Evaluator<Derived> &evaluator,
+                                      tmp::index_sequence<K...>) {
+        const auto &rhs_jac = rightJacobianImpl(get_expr_tag_t<Derived>{},
+                                                evaluator(),
+                                                evaluator.lhs_eval(),
+                                                evaluator.rhs_eval());
+        int foreach[] = {0,
+                         (this->template setBlock<K>(std::false_type{},
+                                                     contains_same_type<RhsDerived, Targets>{},
+                                                     rhs_jac,
+                                                     rhs_jac),
+                          0)...};
+        (void) foreach;
+    }
+
+    template <int... K>
+    WAVE_STRONG_INLINE void setBlocks(std::false_type,
+                                      std::false_type,
+                                      const Evaluator<Derived> &,
+                                      tmp::index_sequence<K...>) {}
+
+    template <int K, typename LhsJacobian, typename RhsJacobian>
+    WAVE_STRONG_INLINE void setBlock(std::true_type,
+                                     std::true_type,
+                                     const LhsJacobian &lhs_jac,
+                                     const RhsJacobian &rhs_jac) {
+        auto block = this->template block<K>();
+        block.noalias() = lhs_jac * this->lhs_eval.template block<K>();
+        block.noalias() += rhs_jac * this->rhs_eval.template block<K>();
+    }
+
+    template <int K, typename LhsJacobian, typename RhsJacobian>
+    WAVE_STRONG_INLINE void setBlock(std::true_type,
+                                     std::false_type,
+                                     const LhsJacobian &lhs_jac,
+                                     const RhsJacobian &) {
+        this->template block<K>().noalias() = lhs_jac * this->lhs_eval.template block<K>();
+    }
+
+    template <int K, typename LhsJacobian, typename RhsJacobian>
+    WAVE_STRONG_INLINE void setBlock(std::false_type,
+                                     std::true_type,
+                                     const LhsJacobian &,
+                                     const RhsJacobian &rhs_jac) {
+        this->template block<K>().noalias() = rhs_jac * this->rhs_eval.template block<K>();
+    }
+
+    template <int K, typename LhsJacobian, typename RhsJacobian>
+    WAVE_STRONG_INLINE void setBlock(std::false_type,
+                                     std::false_type,
+                                     const LhsJacobian &,
+                                     const RhsJacobian &) {}
+};
+
+/** Gets the Jacobian wrt the K'th target from a stacked Jacobian */
+template <int K, typename Derived, typename Target, typename... Targets, typename Stack>
+WAVE_STRONG_INLINE auto getStackedJacobian(std::true_type, const Stack &stack)
+  -> jacobian_t<Derived, Target> {
+    return stack.template middleCols<eval_traits<Target>::TangentSize>(
+      stackedJacobianOffset<Targets...>(K));
+}
+
+// Version for a target the expression cannot contain, whose block was never set
+template <int K, typename Derived, typename Target, typename... Targets, typename Stack>
+WAVE_STRONG_INLINE auto getStackedJacobian(std::false_type, const Stack &)
+  -> jacobian_t<Derived, Target> {
+    return jacobian_t<Derived, Target>::Zero();
+}
+
+template <typename Derived, typename... Targets, int... K>
+auto evaluateWithStackedJacobiansImpl(const Evaluator<Derived> &v_eval,
+                                      tmp::index_sequence<K...>,
+                                      const Targets &... targets)
+  -> std::tuple<plain_output_t<Derived>, jacobian_t<Derived, Targets>...> {
+    // The last address is only there so the array is never empty
+    const void *const addresses[] = {&getWrtTarget(adl{}, targets)..., nullptr};
+    const auto j_eval =
+      StackedJacobianEvaluator<Derived, tmp::type_list<Targets...>>{v_eval, addresses};
+
+    return std::make_tuple(
+      prepareOutput(v_eval),
+      getStackedJacobian<K, Derived, Targets, Targets...>(
+        contains_same_type<Derived, Targets>{}, j_eval.jacobian())...);
+}
+
+/** Evaluate the result of an expression tree and its Jacobians wrt several targets, in
+ * one forward pass
+ *
+ * Unlike finding each Jacobian with its own JacobianEvaluator, which walks the tree once
+ * per target, the Jacobians wrt all targets are carried up the tree together, and each
+ * node's local Jacobians are computed once.
+ *
+ * @param targets N leaf expressions, scalars or proxies
+ */
+template <typename Derived, typename... Targets>
+auto evaluateWithStackedJacobians(const ExpressionBase<Derived> &expr,
+                                  const Targets &... targets)
+  -> std::tuple<plain_output_t<Derived>, jacobian_t<Derived, Targets>...> {
+    static_assert(tmp::conjunction<is_stackable_target<Targets>...>{},
+                  "Stacked Jacobians can only be found wrt leaves, scalars or proxies");
+    const auto &v_eval = prepareEvaluatorTo<plain_output_t<Derived>>(expr.derived());
+    return evaluateWithStackedJacobiansImpl(
+      v_eval, tmp::make_index_sequence<sizeof...(Targets)>{}, targets...);
+}
+
+}  // namespace internal
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_STACKEDJACOBIANEVALUATOR_HPP
@@ -0,0 +1,217 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_TANGENTEVALUATOR_HPP
+#define WAVE_GEOMETRY_TANGENTEVALUATOR_HPP
+
+namespace wave {
+
+/** A leaf, and a vector in its tangent space along which to differentiate
+ *
+ * @see perturb(), ExpressionBase::evalWithDirectionalDerivative()
+ */
+template <typename Leaf>
+struct Perturbation {
+    using Tangent = Eigen::Matrix<internal::scalar_t<Leaf>,
+                                  internal::eval_traits<Leaf>::TangentSize,
+                                  1>;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    const Leaf &leaf;
+    const Tangent delta;
+};
+
+/** Pairs a leaf with a tangent vector, for a directional derivative */
+template <typename Leaf, typename DeltaDerived>
+auto perturb(const ExpressionBase<Leaf> &leaf, const Eigen::MatrixBase<DeltaDerived> &delta)
+  -> Perturbation<Leaf> {
+    return Perturbation<Leaf>{leaf.derived(), delta.derived()};
+}
+
+/** Pairs a scalar leaf with a tangent vector, for a directional derivative */
+template <typename S,
+          typename DeltaDerived,
+          std::enable_if_t<internal::is_scalar<S>{}, int> = 0>
+auto perturb(const S &leaf, const Eigen::MatrixBase<DeltaDerived> &delta)
+  -> Perturbation<S> {
+    return Perturbation<S>{leaf, delta.derived()};
+}
+
+namespace internal {
+
+/** The tangent vector of one leaf, known only by address */
+template <typename Scalar>
+struct TangentSeed {
+    const void *target;
+    const Scalar *delta;
+};
+
+/** The tangent vectors of all perturbed leaves */
+template <typename Scalar>
+struct TangentSeeds {
+    const TangentSeed<Scalar> *seeds;
+    std::size_t size;
+
+    /** Returns the tangent vector of an expression, or null if it is not perturbed */
+    template <typename Derived>
+    const Scalar *find(const Derived &expr) const {
+        for (std::size_t i = 0; i < this->size; ++i) {
+            if (isSame(expr, this->seeds[i].target)) {
+                return this->seeds[i].delta;
+            }
+        }
+        return nullptr;
+    }
+};
+
+/** Evaluates an expression's directional derivative in forward mode
+ *
+ * The tangent vectors of the perturbed leaves are pushed up the tree as matrix-vector
+ * products with each node's local Jacobians, so no full Jacobian is formed.
+ */
+template <typename Derived, typename = void>
+struct TangentEvaluator;
+
+/** Specialization for leaf expression */
+template <typename Derived>
+struct TangentEvaluator<Derived, enable_if_leaf_or_scalar_t<Derived>> {
+    using Tangent = Eigen::Matrix<scalar_t<Derived>, traits<Derived>::TangentSize, 1>;
+
+    WAVE_STRONG_INLINE TangentEvaluator(const Evaluator<Derived> &evaluator,
+                                        const TangentSeeds<scalar_t<Derived>> &seeds)
+        : delta{seeds.find(evaluator.expr)} {}
+
+    /** @returns the leaf's tangent vector if it is perturbed, or none ("zero") */
+    WAVE_STRONG_INLINE boost::optional<Tangent> tangent() const {
+        if (this->delta) {
+            return Tangent{Eigen::Map<const Tangent>{this->delta}};
+        }
+        return boost::none;
+    }
+
+ private:
+    const scalar_t<Derived> *delta;
+};
+
+/** Specialization for unary expression */
+template <typename Derived>
+struct TangentEvaluator<Derived, enable_if_unary_t<Derived>> {
+    using Tangent = Eigen::Matrix<scalar_t<Derived>, eval_traits<Derived>::TangentSize, 1>;
+
+ private:
+    // Wrapped Evaluator and nested tangent-evaluators
+    const Evaluator<Derived> &evaluator;
+    const TangentEvaluator<typename traits<Derived>::RhsDerived> rhs_eval;
+
+ public:
+    WAVE_STRONG_INLINE TangentEvaluator(const Evaluator<Derived> &evaluator,
+                                        const TangentSeeds<scalar_t<Derived>> &seeds)
+        : evaluator{evaluator}, rhs_eval{evaluator.rhs_eval, seeds} {}
+
+    /** @returns tangent vector if expr contains a perturbed leaf, or none otherwise */
+    WAVE_STRONG_INLINE boost::optional<Tangent> tangent() const {
+        const auto &rhs_tangent = this->rhs_eval.tangent();
+        if (rhs_tangent) {
+            return Tangent{jacobianImpl(get_expr_tag_t<Derived>{},
+                                        this->evaluator(),
+                                        this->evaluator.rhs_eval()) *
+                           (*rhs_tangent)};
+        }
+        return boost::none;
+    }
+};
+
+/** Specialization for binary expression */
+template <typename Derived>
+struct TangentEvaluator<Derived, enable_if_binary_t<Derived>> {
+    using Tangent = Eigen::Matrix<scalar_t<Derived>, eval_traits<Derived>::TangentSize, 1>;
+
+ private:
+    // Wrapped Evaluator and nested tangent-evaluators
+    const Evaluator<Derived> &evaluator;
+    const TangentEvaluator<typename traits<Derived>::LhsDerived> lhs_eval;
+    const TangentEvaluator<typename traits<Derived>::RhsDerived> rhs_eval;
+
+ public:
+    WAVE_STRONG_INLINE TangentEvaluator(const Evaluator<Derived> &evaluator,
+                                        const TangentSeeds<scalar_t<Derived>> &seeds)
+        : evaluator{evaluator},
+          lhs_eval{evaluator.lhs_eval, seeds},
+          rhs_eval{evaluator.rhs_eval, seeds} {}
+
+    /** @returns tangent vector if expr contains a perturbed leaf, or none otherwise */
+    WAVE_STRONG_INLINE boost::optional<Tangent> tangent() const {
+        const auto &lhs_tangent = this->lhs_eval.tangent();
+        const auto &rhs_tangent = this->rhs_eval.tangent();
+        if (lhs_tangent && rhs_tangent) {
+            return Tangent{leftJacobianImpl(get_expr_tag_t<Derived>{},
+                                            this->evaluator(),
+                                            this->evaluator.lhs_eval(),
+                                            this->evaluator.rhs_eval()) *
+                             (*lhs_tangent) +
+                           rightJacobianImpl(get_expr_tag_t<Derived>{},
+                                             this->evaluator(),
+                                             this->evaluator.lhs_eval(),
+                                             this->evaluator.rhs_eval()) *
+                             (*rhs_tangent)};
+        } else if (lhs_tangent) {
+            return Tangent{leftJacobianImpl(get_expr_tag_t<Derived>{},
+                                            this->evaluator(),
+                                            this->evaluator.lhs_eval(),
+                                            this->evaluator.rhs_eval()) *
+                           (*lhs_tangent)};
+        } else if (rhs_tangent) {
+            return Tangent{rightJacobianImpl(get_expr_tag_t<Derived>{},
+                                             this->evaluator(),
+                                             this->evaluator.lhs_eval(),
+                                             this->evaluator.rhs_eval()) *
+                           (*rhs_tangent)};
+        }
+        return boost::none;
+    }
+};
+
+/** Evaluate a directional derivative using an existing Evaluator tree
+ */
+template <typename Derived>
+inline auto evaluateOneTangent(const Evaluator<Derived> &v_eval,
+                               const TangentSeeds<scalar_t<Derived>> &seeds)
+  -> Eigen::Matrix<scalar_t<Derived>, eval_traits<Derived>::TangentSize, 1> {
+    using Tangent = Eigen::Matrix<scalar_t<Derived>, eval_traits<Derived>::TangentSize, 1>;
+    const auto t_eval = TangentEvaluator<Derived>{v_eval, seeds};
+    const auto &result = t_eval.tangent();
+    if (result) {
+        return *result;
+    } else {
+        return Tangent::Zero();
+    }
+}
+
+/** Evaluate the result of an expression tree and its directional derivative
+ *
+ * @param perturbations leaves and tangent vectors; the derivative is the sum of the
+ * Jacobian-vector products for each
+ * @return the value of the expression and its tangent vector, J_1 * delta_1 + ...
+ */
+template <typename Derived, typename... Leaves>
+auto evaluateWithDirectionalDerivative(const ExpressionBase<Derived> &expr,
+                                       const Perturbation<Leaves> &... perturbations)
+  -> std::pair<plain_output_t<Derived>,
+               Eigen::Matrix<scalar_t<Derived>, eval_traits<Derived>::TangentSize, 1>> {
+    using Scalar = scalar_t<Derived>;
+    const auto &v_eval = prepareEvaluatorTo<plain_output_t<Derived>>(expr.derived());
+
+    // The last seed is only there so the array is never empty
+    const TangentSeed<Scalar> seeds[] = {
+      {&getWrtTarget(adl{}, perturbations.leaf), perturbations.delta.data()}...,
+      {nullptr, nullptr}};
+    const auto seed_list = TangentSeeds<Scalar>{seeds, sizeof...(Leaves)};
+    return {prepareOutput(v_eval), evaluateOneTangent(v_eval, seed_list)};
+}
+
+}  // namespace internal
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_TANGENTEVALUATOR_HPP
@@ -262,7 +262,8 @@ auto evaluateTypedJacobian(const ExpressionBase<Derived> &expr,
     // Note since we don't return the value, we don't need the user-facing OutputType
     using OutType = eval_output_t<Derived>;
     const auto &v_eval = prepareEvaluatorTo<OutType>(expr.derived());
-    internal::TypedJacobianEvaluator<Derived, TargetDerived> j_eval{v_eval, target};
+    using ExprType = tmp::remove_cr_t<decltype(v_eval.expr)>;
+    internal::TypedJacobianEvaluator<ExprType, TargetDerived> j_eval{v_eval, target};
     const auto &result = j_eval.jacobian();
     return result;
 }
@@ -323,30 +324,6 @@ auto evaluateJacobianAuto(const ExpressionBase<Derived> &expr,
     return evaluateJacobian(expr.derived(), target);
 }
 
-/** Evaluate the result of an expression tree and any number of jacobians
- *
- * Either TypedJacobianEvaluator or untyped JacobianEvaluator is used, depending on
- * whether the expression is a tree with unique types.
- */
-template <typename Derived,
-          typename... Targets,
-          std::enable_if_t<unique_leaves_t<Derived>{}, int> = 0>
-auto evaluateWithJacobiansAuto(const ExpressionBase<Derived> &expr,
-                               const Targets &... targets)
-  -> std::tuple<plain_output_t<Derived>, jacobian_t<Derived, Targets>...> {
-    return evaluateWithTypedJacobians(expr.derived(), targets...);
-}
-
-template <typename Derived,
-          typename... Targets,
-          std::enable_if_t<!unique_leaves_t<Derived>{}, int> = 0>
-auto evaluateWithJacobiansAuto(const ExpressionBase<Derived> &expr,
-                               const Targets &... targets)
-  -> std::tuple<plain_output_t<Derived>, jacobian_t<Derived, Targets>...> {
-    return evaluateWithJacobians(expr.derived(), targets...);
-}
-
-
 }  // namespace internal
 }  // namespace wave
 
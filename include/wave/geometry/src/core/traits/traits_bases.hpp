@@ -73,37 +73,16 @@ struct binary_traits_base<Tmpl<LhsDerived_, RhsDerived_>> {
     using Tag = internal::expr<Tmpl>;
 
  private:
-    // Convenience aliases, not part of traits interface
-    using This = Tmpl<LhsDerived_, RhsDerived_>;
-    using LhsEval = clean_eval_t<LhsDerived>;
-    using RhsEval = clean_eval_t<RhsDerived>;
-    // Types of the operands after applying their PreparedType (before evaluation)
-    using LhsPrepared = typename traits<LhsDerived>::PreparedType;
-    using RhsPrepared = typename traits<RhsDerived>::PreparedType;
-    // Type of this expression template rebound to the prepared operands
-    using AdaptedType = rebind<LhsPrepared, RhsPrepared>;
-
     // We want our Prepare step to apply one conversion to each operand, if needed. Find
-    // the conversions
-    using ConvertedType = typename first_directly_evaluable_conversion_binary<
-      AdaptedType,
-      Tag,
-      rebind,
-      LhsPrepared,
-      RhsPrepared,
-      typename traits<LhsEval>::ConvertTo,
-      typename traits<RhsEval>::ConvertTo>::type;
-
-    using ConvertedTraits = traits_safe_t<ConvertedType, This, binary_traits_base>;
-    using ConvertedLhs = typename ConvertedTraits::LhsDerived;
-    using ConvertedRhs = typename ConvertedTraits::RhsDerived;
+    // the cheapest conversions
+    using Conversions = cheapest_conversion_binary<Tag, rebind, LhsDerived, RhsDerived>;
 
  public:
-    using PreparedType = ConvertedType &&;
+    using PreparedType = typename Conversions::type;
+    /** The plans a parent expression may choose from (see prepared_plans) */
+    using PreparedPlans = typename Conversions::plans;
     /** The (leaf) result of evaluating PreparedType */
-    using EvalType = eval_t_binary<Tag,
-                                   typename traits<ConvertedLhs>::EvalType,
-                                   typename traits<ConvertedRhs>::EvalType>;
+    using EvalType = typename tmp::front_t<PreparedPlans>::eval_type;
 
     using OutputFunctor = IdentityFunctor;
     using UniqueLeaves = has_unique_leaves_binary<LhsDerived, RhsDerived>;
@@ -127,31 +106,16 @@ struct unary_traits_base<Tmpl<RhsDerived_>> {
     using Tag = internal::expr<Tmpl>;
 
  private:
-    // Convenience aliases, not part of traits interface
-    using This = Tmpl<RhsDerived_>;
-    using RhsEval = clean_eval_t<RhsDerived>;
-    // Type of the Rhs after applying its PreparedType (before evaluation)
-    using RhsPrepared = typename traits<RhsDerived>::PreparedType;
-
-    // Type of this expression template rebound to the prepared rhs
-    using AdaptedType = rebind<RhsPrepared>;
-
     // We want our Prepare step to apply one conversion to the Rhs, if needed. Find the
-    // conversion
-    using ConvertedType = typename first_directly_evaluable_conversion_unary<
-      AdaptedType,
-      Tag,
-      rebind,
-      RhsPrepared,
-      typename traits<RhsEval>::ConvertTo>::type;
-
-    using ConvertedRhs =
-      typename traits_safe_t<ConvertedType, This, unary_traits_base>::RhsDerived;
+    // cheapest conversion
+    using Conversions = cheapest_conversion_unary<Tag, rebind, RhsDerived>;
 
  public:
-    using PreparedType = ConvertedType &&;
+    using PreparedType = typename Conversions::type;
+    /** The plans a parent expression may choose from (see prepared_plans) */
+    using PreparedPlans = typename Conversions::plans;
     /** The (leaf) result of evaluating PreparedType */
-    using EvalType = eval_t_unary<Tag, typename traits<ConvertedRhs>::EvalType>;
+    using EvalType = typename tmp::front_t<PreparedPlans>::eval_type;
 
     using OutputFunctor = IdentityFunctor;
     using UniqueLeaves = has_unique_leaves_unary<RhsDerived>;
@@ -171,31 +135,16 @@ struct unary_traits_base_tag<Tmpl<Aux, RhsDerived_>, Tag_> {
     using rebind = Tmpl<Aux, NewRhs>;
 
  private:
-    // Convenience aliases, not part of traits interface
-    using This = Tmpl<Aux, RhsDerived_>;
-    using RhsEval = clean_eval_t<RhsDerived>;
-    // Type of the Rhs after applying its PreparedType (before evaluation)
-    using RhsPrepared = typename traits<RhsDerived>::PreparedType;
-
-    // Type of this expression template rebound to the prepared rhs
-    using AdaptedType = rebind<RhsPrepared>;
-
     // We want our Prepare step to apply one conversion to the Rhs, if needed. Find the
-    // conversion
-    using ConvertedType = typename first_directly_evaluable_conversion_unary<
-      AdaptedType,
-      Tag,
-      rebind,
-      RhsPrepared,
-      typename traits<RhsEval>::ConvertTo>::type;
-
-    using ConvertedRhs =
-      typename traits_safe_t<ConvertedType, This, unary_traits_base_tag>::RhsDerived;
+    // cheapest conversion
+    using Conversions = cheapest_conversion_unary<Tag, rebind, RhsDerived>;
 
  public:
-    using PreparedType = ConvertedType &&;
+    using PreparedType = typename Conversions::type;
+    /** The plans a parent expression may choose from (see prepared_plans) */
+    using PreparedPlans = typename Conversions::plans;
     /** The (leaf) result of evaluating PreparedType */
-    using EvalType = eval_t_unary<Tag, typename traits<ConvertedRhs>::EvalType>;
+    using EvalType = typename tmp::front_t<PreparedPlans>::eval_type;
 
     using OutputFunctor = IdentityFunctor;
     using UniqueLeaves = has_unique_leaves_unary<RhsDerived>;
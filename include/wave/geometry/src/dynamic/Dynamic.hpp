@@ -25,17 +25,25 @@ struct Dynamic final : internal::base_tmpl_t<RhsDerived, Dynamic<RhsDerived>>,
     using OutputType = internal::plain_output_t<CleanType>;
     using Storage = internal::unary_storage_for<Dynamic<RhsDerived>>;
     using Scalar = internal::scalar_t<CleanType>;
-    using MatrixType = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using MatrixType = internal::DynamicMatrix<Scalar>;
     using EvalType = internal::eval_t<OutputType>;
     using PreparedType =
       tmp::remove_cr_t<typename internal::traits<RhsDerived>::PreparedType>;
     enum : int { TangentSize = internal::traits<EvalType>::TangentSize };
 
+    // Whether this node does nothing but wrap a leaf. Tapes and passes use the leaf's
+    // value directly.
+    using WrapsLeaf = tmp::bool_constant<internal::is_leaf_expression<CleanType>{} &&
+                                         std::is_same<CleanType, EvalType>{}>;
+
  public:
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
     using Storage::Storage;
 
  private:
+    using Context = internal::EvaluationContext<Scalar>;
+
+    /** Constructs the evaluator used while a Tape runs, cached in this node */
     decltype(auto) constructEvaluator() const {
         auto &&evaluable_expr = internal::PrepareExpr<CleanType>::run(this->rhs());
         using ExprType = tmp::remove_cr_t<decltype(evaluable_expr)>;
@@ -57,66 +65,171 @@ struct Dynamic final : internal::base_tmpl_t<RhsDerived, Dynamic<RhsDerived>>,
     }
 
     auto dynEvaluate() const -> EvalType override {
-        const auto &v_eval = this->constructEvaluator();
+        const internal::Evaluator<PreparedType> v_eval{
+          internal::PrepareExpr<CleanType>::run(this->rhs())};
         return v_eval();
     }
 
     auto dynJacobian(const void *target_ptr) const -> MatrixType override {
-        // Note we don't reconstruct the evaluator here. This is OK as long as all of our
-        // user-facing methods require function evaluation before derivative.
-        const auto &v_eval = this->evaluator();
+        // The evaluators of this node and those below it are kept in the context
+        if (auto *context = Context::current()) {
+            return this->contextJacobian(*context, target_ptr, WrapsLeaf{});
+        }
+        const auto context = Context::acquire();
+        typename Context::Scope scope{*context};
+        return this->contextJacobian(*context, target_ptr, WrapsLeaf{});
+    }
+
+    MatrixType contextJacobian(Context &, const void *target_ptr, std::true_type) const {
+        // A leaf's evaluator is only a reference to it; there is nothing to look up
+        const internal::Evaluator<PreparedType> v_eval{
+          internal::PrepareExpr<CleanType>::run(this->rhs())};
         return internal::evaluateOneDynamicJacobianRaw(v_eval, target_ptr);
     }
 
-    /** Generic implementation of dynReverse*() methods */
-    template <typename MatrixDerived>
-    inline void dynReverseImpl(
-      MatrixMap<const void *, Scalar> &jac_map,
-      const Eigen::MatrixBase<MatrixDerived> &init_adjoint) const {
-        // Note we don't reconstruct the evaluator here. This is OK as long as all of our
-        // user-facing methods require function evaluation before derivative.
-        const auto &v_eval = this->evaluator();
-        return internal::evaluateDynamicReverseJacobiansImpl(
-          jac_map, v_eval, init_adjoint.derived());
+    MatrixType contextJacobian(Context &context,
+                               const void *target_ptr,
+                               std::false_type) const {
+        const auto &v_eval = *static_cast<const internal::Evaluator<PreparedType> *>(
+          context.evaluatorOf(static_cast<const Base &>(*this)));
+        return internal::evaluateOneDynamicJacobianRaw(v_eval, target_ptr);
     }
 
-    void dynReverseDynamic(
-      MatrixMap<const void *, Scalar> &jac_map,
-      const internal::DynamicMatrix<Scalar> &init_adjoint) const override {
-        return this->dynReverseImpl(jac_map, init_adjoint);
+    /** Evaluates this node's subtree in a new context, and propagates through it */
+    void dynReverse(MatrixMap<const void *, Scalar> &jac_map,
+                    const Scalar *init_adjoint,
+                    int rows) const override {
+        const auto context = Context::acquire();
+        typename Context::Scope scope{*context};
+        const auto &node = static_cast<const Base &>(*this);
+        context->run(node);
+        internal::dispatchReverseRows(
+          internal::FixedReverseRows{},
+          rows,
+          [&](auto fixed_rows) {
+              using AdjointType =
+                Eigen::Matrix<Scalar, decltype(fixed_rows)::value, TangentSize>;
+              context->accumulate(
+                jac_map, node, Eigen::Map<const AdjointType>{init_adjoint});
+          },
+          [&] {
+              using AdjointType = Eigen::Matrix<Scalar, Eigen::Dynamic, TangentSize>;
+              const auto adjoint =
+                Eigen::Map<const AdjointType>{init_adjoint, rows, TangentSize};
+              context->accumulate(jac_map, node, adjoint);
+          });
     }
 
-    void dynReverse(
-      MatrixMap<const void *, Scalar> &jac_map,
-      const Eigen::Matrix<Scalar, 1, TangentSize> &init_adjoint) const override {
-        return this->dynReverseImpl(jac_map, init_adjoint);
+    auto dynEvaluateWithDelta(const void *target, int coeff, Scalar delta) const
+      -> EvalType override {
+        return internal::EvaluatorWithDelta<CleanType>{}(
+          this->rhs(), target, coeff, delta);
     }
 
-    void dynReverse(
-      MatrixMap<const void *, Scalar> &jac_map,
-      const Eigen::Matrix<Scalar, 2, TangentSize> &init_adjoint) const override {
-        return this->dynReverseImpl(jac_map, init_adjoint);
+    void dynCompile(internal::TapeBuilder<Scalar> &builder) const override {
+        return this->tapeCompile(builder, WrapsLeaf{});
     }
 
-    void dynReverse(
-      MatrixMap<const void *, Scalar> &jac_map,
-      const Eigen::Matrix<Scalar, 3, TangentSize> &init_adjoint) const override {
-        return this->dynReverseImpl(jac_map, init_adjoint);
+    /** Adds a node which only wraps a leaf. The tape uses the leaf's value directly, and
+     * accumulates its Jacobian without going through the map, so needs no functions.
+     */
+    void tapeCompile(internal::TapeBuilder<Scalar> &builder, std::true_type) const {
+        builder.push(static_cast<const Base &>(*this), nullptr, nullptr, &this->rhs());
     }
 
-    void dynReverse(
-      MatrixMap<const void *, Scalar> &jac_map,
-      const Eigen::Matrix<Scalar, 6, TangentSize> &init_adjoint) const override {
-        return this->dynReverseImpl(jac_map, init_adjoint);
+    void tapeCompile(internal::TapeBuilder<Scalar> &builder, std::false_type) const {
+        // Children first, so the tape is in topological order
+        addTapeChildren(internal::adl{}, builder, this->rhs());
+        builder.push(static_cast<const Base &>(*this),
+                     &Dynamic::tapeEvaluate,
+                     &Dynamic::tapeReverse);
     }
 
-    auto dynEvaluateWithDelta(const void *target, int coeff, Scalar delta) const
-      -> EvalType override {
-        return internal::EvaluatorWithDelta<CleanType>{}(
-          this->rhs(), target, coeff, delta);
+    void dynForward(Context &context) const override {
+        return this->contextForward(context, WrapsLeaf{});
+    }
+
+    void contextForward(Context &context, std::true_type) const {
+        context.bind(
+          static_cast<const Base &>(*this), &this->rhs(), nullptr, nullptr, &this->rhs());
+    }
+
+    void contextForward(Context &context, std::false_type) const {
+        // Children first, so the evaluator finds their values in the context. The
+        // evaluator is owned by the context, leaving the node untouched.
+        addTapeChildren(internal::adl{}, context, this->rhs());
+        auto &&evaluable_expr = internal::PrepareExpr<CleanType>::run(this->rhs());
+        const auto &v_eval = context.template emplace<internal::Evaluator<PreparedType>>(
+          std::move(evaluable_expr));
+        context.bind(
+          static_cast<const Base &>(*this), &v_eval(), &v_eval, &Dynamic::contextReverse);
+    }
+
+    /** Context reverse function: propagates the node's adjoint using its evaluator */
+    static void contextReverse(const void *evaluator,
+                               MatrixMap<const void *, Scalar> &jac_map,
+                               const Scalar *adjoint,
+                               int rows) {
+        const auto &v_eval =
+          *static_cast<const internal::Evaluator<PreparedType> *>(evaluator);
+        return reverseFrom(v_eval, jac_map, adjoint, rows);
+    }
+
+    /** Recovers the Dynamic from the DynamicBase address stored in a tape instruction */
+    static const Dynamic &fromTapeNode(const void *node) {
+        return static_cast<const Dynamic &>(*static_cast<const Base *>(node));
+    }
+
+    /** Tape instruction: evaluates the node, returning the address of its value */
+    static const void *tapeEvaluate(const void *node) {
+        const auto &v_eval = fromTapeNode(node).constructEvaluator();
+        return &v_eval();
+    }
+
+    /** Tape instruction: propagates the node's accumulated adjoint to its children */
+    static void tapeReverse(const void *node,
+                            MatrixMap<const void *, Scalar> &jac_map,
+                            const Scalar *adjoint,
+                            int rows) {
+        // The evaluator was constructed by the tape's forward pass
+        return reverseFrom(fromTapeNode(node).evaluator(), jac_map, adjoint, rows);
+    }
+
+    /** Propagates an adjoint of rows * TangentSize, stored contiguously, through the
+     * given evaluator of this node's expression
+     *
+     * Adjoints with a height in WAVE_GEOMETRY_REVERSE_ROWS stay fixed-size throughout.
+     */
+    static void reverseFrom(const internal::Evaluator<PreparedType> &v_eval,
+                            MatrixMap<const void *, Scalar> &jac_map,
+                            const Scalar *adjoint,
+                            int rows) {
+        internal::dispatchReverseRows(
+          internal::FixedReverseRows{},
+          rows,
+          [&](auto fixed_rows) {
+              reverseFromImpl<decltype(fixed_rows)::value>(v_eval, jac_map, adjoint);
+          },
+          [&] {
+              using AdjointType = Eigen::Matrix<Scalar, Eigen::Dynamic, TangentSize>;
+              internal::evaluateDynamicReverseJacobiansImpl(
+                jac_map,
+                v_eval,
+                AdjointType{Eigen::Map<const AdjointType>{adjoint, rows, TangentSize}});
+          });
+    }
+
+    template <int Rows>
+    static void reverseFromImpl(const internal::Evaluator<PreparedType> &v_eval,
+                                MatrixMap<const void *, Scalar> &jac_map,
+                                const Scalar *adjoint) {
+        using AdjointType = Eigen::Matrix<Scalar, Rows, TangentSize>;
+        return internal::evaluateDynamicReverseJacobiansImpl(
+          jac_map, v_eval, AdjointType{Eigen::Map<const AdjointType>{adjoint}});
     }
 
  private:
+    // Used only by a running Tape. Other evaluations keep the evaluator in a context.
     mutable boost::optional<internal::Evaluator<PreparedType>> lazy_evaluator;
 };
 
@@ -6,6 +6,25 @@
 #define WAVE_GEOMETRY_DYNAMICBASE_HPP
 
 namespace wave {
+namespace internal {
+
+/** Slots through which a running Tape passes values and adjoints to a DynamicBase
+ *
+ * Both are null unless the tape is running.
+ */
+template <typename Scalar>
+struct TapeSlots {
+    /** The node's value, of its EvalType */
+    const void *value = nullptr;
+
+    /** The node's adjoint block, which its parents accumulate into */
+    Scalar *adjoint = nullptr;
+
+    /** While a Tape is built, one plus the node's index in it */
+    std::size_t instruction = 0;
+};
+
+}  // namespace internal
 
 /** Base class for expressions with dynamic dispatch
  *
@@ -37,63 +56,99 @@ class DynamicBase {
      * @param target_ptr address of the target object
      */
     virtual auto dynJacobian(const void *target_ptr) const
-      -> Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> = 0;
+      -> internal::DynamicMatrix<Scalar> = 0;
 
-    /** Returns set of reverse-mode Jacobians with respect to all leaves
+    /** Accumulates reverse-mode Jacobians with respect to all leaves
      *
-     * @param[in,out] jac_map a map of leaf address to dynamic Matrix, to be filled
-     * @param init_adjoint the adjoint matrix of the root node
-     * @returns a map of leaf address to dynamic Matrix
+     * @param[in,out] jac_map a map of leaf address to Jacobian, to be added to
+     * @param init_adjoint the adjoint of this node, rows * TangentSize, in column-major
+     * order
+     * @param rows the height of the adjoint
      */
-    virtual void dynReverseDynamic(
-      MatrixMap<const void *, Scalar> &jac_map,
-      const internal::DynamicMatrix<Scalar> &init_adjoint) const = 0;
+    virtual void dynReverse(MatrixMap<const void *, Scalar> &jac_map,
+                            const Scalar *init_adjoint,
+                            int rows) const = 0;
 
-    /** Returns set of reverse-mode Jacobians with respect to all leaves
-     * @see dynReverseDynamic. Specialization for 1*m adjoints.
+    /** Accumulates reverse-mode Jacobians with respect to all leaves, given an adjoint
+     * matrix of any height
      */
-    virtual void dynReverse(
-      MatrixMap<const void *, Scalar> &jac_map,
-      const Eigen::Matrix<Scalar, 1, TangentSize> &init_adjoint) const = 0;
+    template <typename Derived>
+    void dynReverse(MatrixMap<const void *, Scalar> &jac_map,
+                    const Eigen::MatrixBase<Derived> &init_adjoint) const {
+        using AdjointType =
+          Eigen::Matrix<Scalar, Derived::RowsAtCompileTime, TangentSize>;
+        const auto plain = AdjointType{init_adjoint};
+        return this->dynReverse(jac_map, plain.data(), static_cast<int>(plain.rows()));
+    }
 
-    /** Returns set of reverse-mode Jacobians with respect to all leaves
-     * @see dynReverseDynamic. Specialization for 2*m adjoints.
+    /** Returns result of evaluation for numerical diff
+     *
+     * @see EvaluatorWithDelta
      */
-    virtual void dynReverse(
-      MatrixMap<const void *, Scalar> &jac_map,
-      const Eigen::Matrix<Scalar, 2, TangentSize> &init_adjoint) const = 0;
+    virtual auto dynEvaluateWithDelta(const void *target, int coeff, Scalar delta) const
+      -> EvalType = 0;
 
-    /** Returns set of reverse-mode Jacobians with respect to all leaves
-     * @see dynReverseDynamic. Specialization for 3*m adjoints.
+    /** Appends this node's instruction to the tape, after those of its children
+     *
+     * @see Tape
      */
-    virtual void dynReverse(
-      MatrixMap<const void *, Scalar> &jac_map,
-      const Eigen::Matrix<Scalar, 3, TangentSize> &init_adjoint) const = 0;
+    virtual void dynCompile(internal::TapeBuilder<Scalar> &builder) const = 0;
 
-    /** Returns set of reverse-mode Jacobians with respect to all leaves
-     * @see dynReverseDynamic. Specialization for 6*m adjoints.
+    /** Evaluates this node in a context, after any of its children not yet evaluated in
+     * the context, and records its evaluator and value there
+     *
+     * @see EvaluationContext
      */
-    virtual void dynReverse(
-      MatrixMap<const void *, Scalar> &jac_map,
-      const Eigen::Matrix<Scalar, 6, TangentSize> &init_adjoint) const = 0;
+    virtual void dynForward(internal::EvaluationContext<Scalar> &context) const = 0;
 
-    /** Fallback for matrix sizes for which there is no specialization of dynReverse().
-     *
-     * Converts the adjoint to dynamic matrix and calls dynReverseDynamic().
+    /** Returns the value of this node in the given context, which must be current,
+     * evaluating the graph below it there if needed. If the context is null, returns the
+     * value bound by a running Tape.
      */
-    template <int N>
-    void dynReverse(MatrixMap<const void *, Scalar> &jac_map,
-                    const Eigen::Matrix<Scalar, N, TangentSize> &init_adjoint) const {
-        // @todo make dynamic adapter for MatrixMap
-        return dynReverseDynamic(jac_map, internal::DynamicMatrix<Scalar>{init_adjoint});
+    auto valueIn(internal::EvaluationContext<Scalar> *context) const -> EvalType {
+        if (!context) {
+            assert(this->tape_slots.value && "Without a context, a Tape must be running");
+            return *static_cast<const EvalType *>(this->tape_slots.value);
+        }
+        assert(context == internal::EvaluationContext<Scalar>::current());
+        return context->valueOf(*this);
     }
 
-    /** Returns result of evaluation for numerical diff
-     *
-     * @see EvaluatorWithDelta
+    /** Returns the Jacobian with respect to the given target, using the evaluators of
+     * this node and the graph below it in the given context
      */
-    virtual auto dynEvaluateWithDelta(const void *target, int coeff, Scalar delta) const
-      -> EvalType = 0;
+    auto jacobianIn(internal::EvaluationContext<Scalar> *context,
+                    const void *target_ptr) const
+      -> internal::DynamicMatrix<Scalar> {
+        assert(context && "Forward-mode Jacobians are not evaluated by a Tape");
+        typename internal::EvaluationContext<Scalar>::Scope scope{*context};
+        return this->dynJacobian(target_ptr);
+    }
+
+    /** Accumulates the adjoint into the given context, or into the slot bound by a
+     * running Tape if the context is null, or evaluates the Jacobians of this node's
+     * subtree in a new context otherwise
+     */
+    template <typename Adjoint>
+    void reverseIn(internal::EvaluationContext<Scalar> *context,
+                   MatrixMap<const void *, Scalar> &jac_map,
+                   const Adjoint &adjoint) const {
+        if (context && context == internal::EvaluationContext<Scalar>::current()) {
+            context->accumulate(jac_map, *this, adjoint);
+        } else if (context) {
+            typename internal::EvaluationContext<Scalar>::Scope scope{*context};
+            context->accumulate(jac_map, *this, adjoint);
+        } else if (this->tape_slots.adjoint) {
+            using AdjointType =
+              Eigen::Matrix<Scalar, Adjoint::RowsAtCompileTime, TangentSize>;
+            Eigen::Map<AdjointType>{
+              this->tape_slots.adjoint, adjoint.rows(), TangentSize} += adjoint;
+        } else {
+            this->dynReverse(jac_map, adjoint);
+        }
+    }
+
+    mutable internal::TapeSlots<Scalar> tape_slots;
 
     // These friend templates (in specializations for Proxy) use the above virtual methods
     template <typename, typename>
@@ -106,7 +161,15 @@ class DynamicBase {
     friend struct internal::DynamicJacobianEvaluator;
     template <typename, typename, typename>
     friend struct internal::DynamicReverseJacobianEvaluator;
+    template <typename, typename, typename>
+    friend struct internal::StackedJacobianEvaluator;
+    template <typename, typename>
+    friend struct internal::TangentEvaluator;
     friend class RefProxy<Leaf>;
+    template <typename>
+    friend struct internal::TapeBuilder;
+    template <typename>
+    friend class internal::EvaluationContext;
 };  // namespace wave
 
 namespace internal {
@@ -116,6 +179,31 @@ namespace internal {
 template <typename Leaf>
 struct traits<DynamicBase<Leaf>> : traits<Leaf> {};
 
+/** The heights in WAVE_GEOMETRY_REVERSE_ROWS */
+using FixedReverseRows = tmp::index_sequence<WAVE_GEOMETRY_REVERSE_ROWS>;
+
+/** Calls fixed(std::integral_constant<int, R>{}) if rows is one of the heights R in the
+ * sequence, or fallback() otherwise
+ */
+template <typename Fixed, typename Fallback>
+void dispatchReverseRows(tmp::index_sequence<>, int, Fixed &&, Fallback &&fallback) {
+    return fallback();
+}
+
+template <int R, int... Rs, typename Fixed, typename Fallback>
+void dispatchReverseRows(tmp::index_sequence<R, Rs...>,
+                         int rows,
+                         Fixed &&fixed,
+                         Fallback &&fallback) {
+    if (rows == R) {
+        return fixed(std::integral_constant<int, R>{});
+    }
+    return dispatchReverseRows(tmp::index_sequence<Rs...>{},
+                               rows,
+                               std::forward<Fixed>(fixed),
+                               std::forward<Fallback>(fallback));
+}
+
 }  // namespace internal
 }  // namespace wave
 
@@ -0,0 +1,532 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_EVALUATIONCONTEXT_HPP
+#define WAVE_GEOMETRY_EVALUATIONCONTEXT_HPP
+
+namespace wave {
+namespace internal {
+
+/** Holds the state of evaluating a graph of Dynamic nodes, outside the nodes
+ *
+ * A context keeps each node's evaluator, value and adjoint in its own storage, and never
+ * writes to the nodes. Graphs which share nodes can then be evaluated from several
+ * threads at once, each with its own context, without locks. (Only a running Tape binds
+ * values into the nodes themselves.)
+ *
+ * A context is used by making it current on a thread, with a Scope. While it is current,
+ * evaluating a Proxy on that thread looks up or adds the node's value in the context,
+ * forward-mode AD uses the node's evaluator in the context, and reverse-mode AD
+ * accumulates the node's adjoint in the context. Each node is evaluated once, and every
+ * node's adjoint is summed from all its parents before being propagated.
+ *
+ * Evaluating a Proxy when no context is current uses one from acquire(), owned by the
+ * Proxy's evaluator. Thus every evaluation has its own context.
+ *
+ * A context can be clear()ed and reused. It keeps its memory, so evaluating graphs of
+ * similar size repeatedly does not allocate.
+ */
+template <typename Scalar>
+class EvaluationContext {
+ public:
+    /** Propagates a node's adjoint (rows * tangent size) to its children and leaves,
+     * given the node's evaluator in this context
+     */
+    using ReverseFunction = void (*)(const void *evaluator,
+                                     DynamicReverseResult<Scalar> &,
+                                     const Scalar *,
+                                     int);
+
+    /** Makes a context current on the calling thread, until the scope ends */
+    class Scope {
+     public:
+        explicit Scope(EvaluationContext &context) noexcept
+            : previous{EvaluationContext::current()} {
+            EvaluationContext::current() = &context;
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        ~Scope() {
+            EvaluationContext::current() = this->previous;
+        }
+
+     private:
+        EvaluationContext *previous;
+    };
+
+    /** Owner of a context from acquire(), which returns it to the pool when the last
+     * owner is destroyed
+     *
+     * Copies of an evaluator share its context. They are made on one thread, so the
+     * count of owners is not atomic.
+     */
+    class Handle {
+     public:
+        Handle() noexcept = default;
+
+        explicit Handle(EvaluationContext *context) noexcept : context{context} {
+            ++context->owners;
+        }
+
+        Handle(const Handle &other) noexcept : context{other.context} {
+            if (this->context) {
+                ++this->context->owners;
+            }
+        }
+
+        Handle &operator=(const Handle &) = delete;
+
+        ~Handle() {
+            if (this->context && --this->context->owners == 0) {
+                EvaluationContext::release(this->context);
+            }
+        }
+
+        EvaluationContext *get() const noexcept {
+            return this->context;
+        }
+
+        EvaluationContext &operator*() const noexcept {
+            return *this->context;
+        }
+
+        EvaluationContext *operator->() const noexcept {
+            return this->context;
+        }
+
+        explicit operator bool() const noexcept {
+            return this->context != nullptr;
+        }
+
+     private:
+        EvaluationContext *context = nullptr;
+    };
+
+    EvaluationContext() = default;
+    EvaluationContext(const EvaluationContext &) = delete;
+    EvaluationContext &operator=(const EvaluationContext &) = delete;
+
+    /** Returns the context current on the calling thread, or null */
+    static EvaluationContext *&current() noexcept {
+        static thread_local EvaluationContext *context = nullptr;
+        return context;
+    }
+
+    /** Returns an empty context, reusing one released earlier on the calling thread if
+     * possible, along with its memory
+     */
+    static Handle acquire() {
+        auto &pool = EvaluationContext::pool();
+        if (pool.empty()) {
+            return Handle{new EvaluationContext{}};
+        }
+        auto context = Handle{pool.back().release()};
+        pool.pop_back();
+        return context;
+    }
+
+    /** Evaluates the graph below a root, and any nodes below it not yet evaluated */
+    template <typename Leaf>
+    void run(const DynamicBase<Leaf> &root) {
+        this->entryOf(root);
+    }
+
+    /** Returns a node's value in this context, evaluating it first if needed */
+    template <typename Leaf>
+    auto valueOf(const DynamicBase<Leaf> &node) -> const eval_t<Leaf> & {
+        const auto &entry = this->entries[this->entryOf(node)];
+        return *static_cast<const eval_t<Leaf> *>(entry.value);
+    }
+
+    /** Returns a node's evaluator in this context, evaluating the node first if needed
+     *
+     * The evaluator is null if the node only wraps a leaf.
+     */
+    template <typename Leaf>
+    const void *evaluatorOf(const DynamicBase<Leaf> &node) {
+        return this->entries[this->entryOf(node)].evaluator;
+    }
+
+    /** Evaluates a child of the node being evaluated, unless it already has a value. A
+     * child reached from more than one parent is marked as shared.
+     */
+    template <typename Leaf>
+    void addChild(const DynamicBase<Leaf> &node) {
+        const auto k = this->find(&node);
+        if (k == NotFound) {
+            node.dynForward(*this);
+        } else {
+            this->entries[k].shared = true;
+        }
+    }
+
+    /** Records a leaf referenced by the node being evaluated */
+    void addLeaf(const void *leaf, int tangent_size) {
+        this->leaves.emplace_back(leaf, tangent_size);
+    }
+
+    /** Constructs an object, such as a node's evaluator, owned by the context until it
+     * is cleared
+     */
+    template <typename T, typename... Args>
+    T &emplace(Args &&... args) {
+        return this->arena.template emplace<T>(std::forward<Args>(args)...);
+    }
+
+    /** Records a node's value. Called by the node's dynForward().
+     *
+     * @param evaluator the node's evaluator, passed to reverse
+     * @param leaf address of the leaf, if the node does nothing but wrap one. Then
+     * reverse is not needed, and may be null.
+     */
+    template <typename Leaf>
+    void bind(const DynamicBase<Leaf> &node,
+              const void *value,
+              const void *evaluator,
+              ReverseFunction reverse,
+              const void *leaf = nullptr) {
+        this->entries.push_back({&node,
+                                 value,
+                                 evaluator,
+                                 reverse,
+                                 leaf,
+                                 this->leaves.size(),
+                                 traits<Leaf>::TangentSize,
+                                 false,
+                                 nullptr});
+        this->insert(this->entries.size() - 1);
+        if (leaf) {
+            this->addLeaf(leaf, traits<Leaf>::TangentSize);
+        }
+    }
+
+    /** Propagates adjoints from a root evaluated in this context to every leaf
+     *
+     * @return map of leaf address to Jacobians of the root
+     */
+    template <typename Leaf>
+    auto reverse(const DynamicBase<Leaf> &root) -> DynamicReverseResult<Scalar> {
+        auto jac_map = DynamicReverseResult<Scalar>{};
+        this->reverseTo(jac_map, root);
+        return jac_map;
+    }
+
+    /** Propagates adjoints from a root evaluated in this context to every leaf, writing
+     * the Jacobians to an existing map
+     *
+     * The map is zeroed, and its registry of leaves is kept if they are the same as in
+     * its last use, so a reused map is not reallocated.
+     */
+    template <typename Leaf>
+    void reverseTo(DynamicReverseResult<Scalar> &jac_map, const DynamicBase<Leaf> &root) {
+        enum : int { Rows = traits<Leaf>::TangentSize };
+        this->reverseTo(jac_map, root, Eigen::Matrix<Scalar, Rows, Rows>::Identity());
+    }
+
+    /** Propagates an adjoint of a root evaluated in this context to every leaf, writing
+     * its products with the Jacobians to an existing map
+     *
+     * @param init_adjoint the adjoint of the root, with one column per tangent dimension
+     */
+    template <typename Leaf, typename Adjoint>
+    void reverseTo(DynamicReverseResult<Scalar> &jac_map,
+                   const DynamicBase<Leaf> &root,
+                   const Adjoint &init_adjoint) {
+        // Each leaf is listed once per referencing node; the map gives each one ID
+        jac_map.assign(this->leaves.begin(), this->leaves.end(), init_adjoint.rows());
+        auto &root_entry = this->entries[this->find(&root)];
+        root_entry.shared = true;
+        this->beginReverse(jac_map, jac_map.elementIds());
+
+        using RootAdjoint = Eigen::Matrix<Scalar,
+                                          Adjoint::RowsAtCompileTime,
+                                          traits<Leaf>::TangentSize>;
+        Eigen::Map<RootAdjoint>{
+          root_entry.adjoint, init_adjoint.rows(), traits<Leaf>::TangentSize} +=
+          init_adjoint;
+        this->propagate(jac_map);
+    }
+
+    /** Adds to a node's adjoint during a reverse pass started by reverse(), if the node
+     * is shared or wraps a leaf. Otherwise, such as when the node has one parent or is
+     * below a static expression, propagates the adjoint through the node directly.
+     */
+    template <typename Leaf, typename Adjoint>
+    void accumulate(DynamicReverseResult<Scalar> &jac_map,
+                    const DynamicBase<Leaf> &node,
+                    const Adjoint &adjoint) {
+        using AdjointType = Eigen::Matrix<Scalar,
+                                          Adjoint::RowsAtCompileTime,
+                                          traits<Leaf>::TangentSize>;
+        const auto &entry = this->entries[this->find(&node)];
+        if (entry.adjoint) {
+            Eigen::Map<AdjointType>{
+              entry.adjoint, adjoint.rows(), traits<Leaf>::TangentSize} += adjoint;
+        } else if (entry.leaf) {
+            jac_map.block(jac_map.visit(entry.leaf)) += adjoint;
+        } else {
+            const auto plain = AdjointType{adjoint};
+            entry.reverse(entry.evaluator, jac_map, plain.data(), plain.rows());
+        }
+    }
+
+    /** Forgets all nodes, and destroys their evaluators, keeping the memory for reuse */
+    void clear() {
+        ++this->generation;
+        this->entries.clear();
+        this->leaves.clear();
+        this->arena.clear();
+    }
+
+ private:
+    // Contexts kept by each thread for acquire(). Nested evaluations each take one.
+    enum : std::size_t { MaxPooled = 16 };
+    enum : std::size_t { NotFound = std::size_t(-1) };
+
+    static std::vector<std::unique_ptr<EvaluationContext>> &pool() {
+        static thread_local std::vector<std::unique_ptr<EvaluationContext>> contexts;
+        return contexts;
+    }
+
+    /** Clears a context whose last Handle is gone, and keeps it for acquire() */
+    static void release(EvaluationContext *context) {
+        context->clear();
+        auto &pool = EvaluationContext::pool();
+        if (pool.size() < MaxPooled) {
+            pool.emplace_back(context);
+        } else {
+            delete context;
+        }
+    }
+
+    /** A node evaluated in the context */
+    struct Entry {
+        /** Address of the node's DynamicBase */
+        const void *node;
+        const void *value;
+        const void *evaluator;
+        ReverseFunction reverse;
+
+        /** If the node only wraps a leaf, the leaf. Its adjoint is the leaf's Jacobian */
+        const void *leaf;
+
+        /** If the node only wraps a leaf, the leaf's index in leaves */
+        std::size_t leaf_index;
+        int tangent_size;
+
+        /** Whether the node was reached from more than one parent */
+        bool shared;
+
+        /** The node's adjoint block, while a reverse pass runs */
+        Scalar *adjoint;
+    };
+
+    /** Propagates the accumulated adjoints of all nodes to their children and leaves, in
+     * reverse topological order, ending the reverse pass
+     */
+    void propagate(DynamicReverseResult<Scalar> &jac_map) {
+        // Each stored adjoint is complete once all nodes above it have run
+        for (auto it = this->entries.rbegin(); it != this->entries.rend(); ++it) {
+            if (it->adjoint && !it->leaf) {
+                it->reverse(it->evaluator, jac_map, it->adjoint, this->adjoint_rows);
+            }
+        }
+        for (auto &entry : this->entries) {
+            entry.adjoint = nullptr;
+        }
+    }
+
+    /** Points the adjoint of each node which only wraps a leaf at the leaf's Jacobian,
+     * and that of each shared node at zeroed storage. Other nodes have one parent, which
+     * propagates to them directly.
+     *
+     * @param leaf_ids the ID in jac_map of each element of leaves
+     */
+    void beginReverse(DynamicReverseResult<Scalar> &jac_map,
+                      const std::vector<int> &leaf_ids) {
+        const auto rows = jac_map.rows();
+        auto cols = Eigen::Index{0};
+        for (const auto &entry : this->entries) {
+            if (entry.shared && !entry.leaf) {
+                cols += entry.tangent_size;
+            }
+        }
+        this->adjoint_rows = static_cast<int>(rows);
+        this->adjoints.assign(rows * cols, Scalar{0});
+
+        auto *next = this->adjoints.data();
+        for (auto &entry : this->entries) {
+            if (entry.leaf) {
+                entry.adjoint = jac_map.block(leaf_ids[entry.leaf_index]).data();
+            } else if (entry.shared) {
+                entry.adjoint = next;
+                next += rows * entry.tangent_size;
+            }
+        }
+    }
+
+    /** Evaluates a node unless it already has a value, without marking it as shared
+     *
+     * @return the index of the node's entry
+     */
+    template <typename Leaf>
+    std::size_t entryOf(const DynamicBase<Leaf> &node) {
+        const auto k = this->find(&node);
+        if (k != NotFound) {
+            return k;
+        }
+        // The node's entry is added last, after those of its children
+        node.dynForward(*this);
+        return this->entries.size() - 1;
+    }
+
+    /** Returns the index of a node's entry, or NotFound */
+    std::size_t find(const void *node) const {
+        if (this->slots.empty()) {
+            return NotFound;
+        }
+        const auto mask = this->slots.size() - 1;
+        for (auto i = this->slotFor(node);; i = (i + 1) & mask) {
+            const auto &slot = this->slots[i];
+            if (slot.generation != this->generation) {
+                return NotFound;
+            }
+            if (slot.node == node) {
+                return slot.entry;
+            }
+        }
+    }
+
+    /** Adds an entry to the index, growing it to keep it at most half full */
+    void insert(std::size_t entry) {
+        if (2 * this->entries.size() > this->slots.size()) {
+            return this->rehash();
+        }
+        const auto mask = this->slots.size() - 1;
+        auto i = this->slotFor(this->entries[entry].node);
+        while (this->slots[i].generation == this->generation) {
+            i = (i + 1) & mask;
+        }
+        this->slots[i] = {this->entries[entry].node, entry, this->generation};
+    }
+
+    void rehash() {
+        this->shift = 64 - 5;
+        while ((std::size_t{1} << (64 - this->shift)) < 4 * this->entries.size()) {
+            --this->shift;
+        }
+        this->slots.assign(std::size_t{1} << (64 - this->shift), Slot{});
+        for (std::size_t k = 0; k < this->entries.size(); ++k) {
+            this->insert(k);
+        }
+    }
+
+    /** Returns the first slot to probe for a node, from the high bits of a Fibonacci
+     * hash of its address
+     */
+    std::size_t slotFor(const void *node) const {
+        const auto address =
+          static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(node));
+        return static_cast<std::size_t>((address * 0x9E3779B97F4A7C15ull) >> this->shift);
+    }
+
+    /** A slot in the index. Slots from before the last clear() have an older
+     * generation, and are empty.
+     */
+    struct Slot {
+        const void *node;
+        std::size_t entry;
+        std::size_t generation;
+    };
+
+    /** Open-addressed index of each node's entry, by the address of its DynamicBase.
+     * Unlike a std::unordered_map, it keeps its memory across clear().
+     */
+    std::vector<Slot> slots;
+    std::size_t generation = 1;
+    int shift = 64;
+    std::vector<Entry> entries;
+    DynamicLeavesVec leaves;
+
+    /** Owns the evaluators of all nodes */
+    ProxyArena arena;
+
+    /** Adjoint blocks of all nodes, which keep their capacity across clear() */
+    std::vector<Scalar> adjoints;
+    int adjoint_rows = 0;
+
+    /** Number of Handles owning the context, if it came from acquire() */
+    std::size_t owners = 0;
+};
+
+/** Evaluates result and all Jacobians of a Proxy graph in reverse mode
+ *
+ * Overload of evaluateWithDynamicReverseJacobians() for Proxy roots. Each node is
+ * evaluated once, and its adjoints from all parents are summed before they are
+ * propagated to its children. The graph is evaluated in a context of its own, whose
+ * reverse pass covers only this graph.
+ *
+ * @return result and map of leaf address to Jacobians as dynamic matrices
+ */
+template <typename Leaf>
+auto evaluateWithDynamicReverseJacobians(const Proxy<Leaf> &proxy)
+  -> std::pair<plain_output_t<Proxy<Leaf>>, DynamicReverseResult<scalar_t<Leaf>>> {
+    using Context = EvaluationContext<scalar_t<Leaf>>;
+    const auto context = Context::acquire();
+    typename Context::Scope scope{*context};
+    const auto &value = context->valueOf(proxy.follow());
+    return {prepareLeafForOutput<Proxy<Leaf>>(value), context->reverse(proxy.follow())};
+}
+
+/** Evaluates result, and the products of an adjoint with all Jacobians, of a Proxy graph
+ * in reverse mode
+ *
+ * Overload of evaluateWithDynamicReverseJacobians() for Proxy roots.
+ *
+ * @param adjoint a k*m matrix, where m is the tangent size of the Proxy
+ * @return result and map of leaf address to k*n products of the adjoint and Jacobians
+ */
+template <typename Leaf, typename AdjointDerived>
+auto evaluateWithDynamicReverseJacobians(const Proxy<Leaf> &proxy,
+                                         const Eigen::MatrixBase<AdjointDerived> &adjoint)
+  -> std::pair<plain_output_t<Proxy<Leaf>>, DynamicReverseResult<scalar_t<Leaf>>> {
+    static_assert(static_cast<int>(AdjointDerived::ColsAtCompileTime) ==
+                    static_cast<int>(traits<Leaf>::TangentSize),
+                  "The adjoint must have one column per tangent dimension of the "
+                  "expression");
+    using Context = EvaluationContext<scalar_t<Leaf>>;
+    const auto context = Context::acquire();
+    typename Context::Scope scope{*context};
+    const auto &value = context->valueOf(proxy.follow());
+    auto jac_map = DynamicReverseResult<scalar_t<Leaf>>{};
+    context->reverseTo(jac_map, proxy.follow(), adjoint.derived());
+    return {prepareLeafForOutput<Proxy<Leaf>>(value), std::move(jac_map)};
+}
+
+/** Evaluates result and all Jacobians of a Proxy graph in reverse mode, writing the
+ * Jacobians to an existing map
+ *
+ * Overload of evaluateWithDynamicReverseJacobiansTo() for Proxy roots.
+ *
+ * @param[out] jac_map map of leaf address to Jacobians, reused across calls
+ * @return result
+ */
+template <typename Leaf>
+auto evaluateWithDynamicReverseJacobiansTo(DynamicReverseResult<scalar_t<Leaf>> &jac_map,
+                                           const Proxy<Leaf> &proxy)
+  -> plain_output_t<Proxy<Leaf>> {
+    using Context = EvaluationContext<scalar_t<Leaf>>;
+    const auto context = Context::acquire();
+    typename Context::Scope scope{*context};
+    const auto &value = context->valueOf(proxy.follow());
+    context->reverseTo(jac_map, proxy.follow());
+    return prepareLeafForOutput<Proxy<Leaf>>(value);
+}
+
+}  // namespace internal
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_EVALUATIONCONTEXT_HPP
@@ -43,7 +43,20 @@ class Proxy final : public internal::base_tmpl_t<Leaf, Proxy<Leaf>> {
             Eigen::aligned_allocator<Dynamic<Derived &&>>{},
             Dynamic<Derived &&>{expr.derived()})} {}
 
+    /** Construct by making an rvalue expression Dynamic and moving it to an arena
+     *
+     * The node is owned by the arena, not shared by copies of this proxy.
+     * @see ProxyArena
+     */
+    template <typename Derived>
+    Proxy(ProxyArena &arena, ExpressionBase<Derived> &&expr)
+        : storage{std::shared_ptr<void>{},
+                  &arena.emplace<Dynamic<Derived &&>>(
+                    Dynamic<Derived &&>{expr.derived()})} {}
+
     /** Get a copy of the wrapped smart pointer
+     *
+     * If the proxy was constructed with an arena, the pointer is non-owning.
      */
     auto get() const noexcept -> std::shared_ptr<DynamicBase<Leaf>> {
         return storage;
@@ -70,6 +83,17 @@ auto makeProxy(ExpressionBase<Derived> &&expr)
     return Proxy<internal::plain_output_t<Derived>>{std::move(expr).derived()};
 }
 
+/** Moves an rvalue expression to an arena, and returns a Proxy to it
+ *
+ * @warning The proxy is left dangling if it outlasts the arena.
+ * @see ProxyArena
+ */
+template <typename Derived>
+auto makeProxy(ProxyArena &arena, ExpressionBase<Derived> &&expr)
+  -> Proxy<internal::plain_output_t<Derived>> {  // return type for gcc5
+    return Proxy<internal::plain_output_t<Derived>>{arena, std::move(expr).derived()};
+}
+
 namespace internal {
 
 // Trait to specialize the below templates for only Proxy and related types
@@ -93,20 +117,51 @@ struct PrepareExpr<Derived, std::enable_if_t<is_proxy<Derived>{}>> {
     }
 };
 
+/** Evaluates a Proxy in the calling thread's current EvaluationContext
+ *
+ * If there is none, and no Tape is running, the evaluator takes a context of its own and
+ * keeps it, with the evaluators of the graph, for the Jacobian evaluators which use it.
+ * Thus the nodes are never written to, and may be shared across threads.
+ */
 template <typename Derived>
 struct Evaluator<Derived, std::enable_if_t<is_proxy<Derived>{}>> {
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
     using EvalType = eval_t<Derived>;
+    using Context = EvaluationContext<scalar_t<Derived>>;
 
     WAVE_STRONG_INLINE explicit Evaluator(const Derived &proxy)
-        : expr{proxy.follow()}, result{expr.dynEvaluate()} {}
+        : Evaluator{proxy.follow(), Context::current()} {}
 
     const EvalType &operator()() const {
         return this->result;
     }
 
+ private:
+    WAVE_STRONG_INLINE Evaluator(const DynamicBase<plain_output_t<Derived>> &expr,
+                                 Context *current)
+        : expr{expr},
+          owned_context{current || expr.tape_slots.value ? typename Context::Handle{}
+                                                         : Context::acquire()},
+          context{owned_context ? owned_context.get() : current},
+          result{this->evaluate()} {}
+
+    EvalType evaluate() const {
+        if (this->owned_context) {
+            typename Context::Scope scope{*this->context};
+            return this->context->valueOf(this->expr);
+        }
+        return this->expr.valueIn(this->context);
+    }
+
  public:
     const DynamicBase<plain_output_t<Derived>> &expr;
+
+ private:
+    typename Context::Handle owned_context;
+
+ public:
+    /** The context holding the graph's evaluators, or null while a Tape runs */
+    Context *const context;
     const EvalType result;
 };
 
@@ -127,7 +182,7 @@ struct DynamicJacobianEvaluator<Derived, enable_if_proxy_t<Derived>> {
             return DynamicMatrix<Scalar>::Identity(TangentSize, TangentSize).eval();
         }
         // Otherwise, dynamically get the Jacobian of the derived expression
-        return this->v_eval.expr.dynJacobian(this->target_ptr);
+        return this->v_eval.expr.jacobianIn(this->v_eval.context, this->target_ptr);
     }
 
  private:
@@ -135,6 +190,90 @@ struct DynamicJacobianEvaluator<Derived, enable_if_proxy_t<Derived>> {
     const void *target_ptr;
 };
 
+template <typename Derived>
+struct TangentEvaluator<Derived, enable_if_proxy_t<Derived>> {
+    using Scalar = scalar_t<Derived>;
+    enum : int { TangentSize = eval_traits<Derived>::TangentSize };
+    using Tangent = Eigen::Matrix<Scalar, TangentSize, 1>;
+
+    WAVE_STRONG_INLINE TangentEvaluator(const Evaluator<Derived> &v_eval,
+                                        const TangentSeeds<Scalar> &seeds)
+        : v_eval{v_eval}, seeds{seeds} {}
+
+    WAVE_STRONG_INLINE boost::optional<Tangent> tangent() const {
+        // Check if this Proxy is itself perturbed
+        if (const auto *delta = this->seeds.find(this->v_eval.expr)) {
+            return Tangent{Eigen::Map<const Tangent>{delta}};
+        }
+        // Otherwise, sum the products of the dynamic Jacobians, which are bounded in
+        // size, with the perturbations
+        auto result = boost::optional<Tangent>{};
+        for (std::size_t i = 0; i < this->seeds.size; ++i) {
+            const auto &seed = this->seeds.seeds[i];
+            const auto jac = this->v_eval.expr.jacobianIn(this->v_eval.context, seed.target);
+            if (jac.size() > 0) {
+                const auto delta = Eigen::Map<const Eigen::Matrix<Scalar, Eigen::Dynamic, 1>>{
+                  seed.delta, jac.cols()};
+                result = Tangent{(result ? *result : Tangent::Zero()) + jac * delta};
+            }
+        }
+        return result;
+    }
+
+ private:
+    const Evaluator<Derived> &v_eval;
+    const TangentSeeds<Scalar> &seeds;
+};
+
+template <typename Derived, typename... Targets>
+struct StackedJacobianEvaluator<Derived,
+                                tmp::type_list<Targets...>,
+                                enable_if_proxy_t<Derived>>
+    : StackedJacobianBase<Derived, Targets...> {
+    using Base = StackedJacobianBase<Derived, Targets...>;
+    using Scalar = scalar_t<Derived>;
+
+    WAVE_STRONG_INLINE StackedJacobianEvaluator(const Evaluator<Derived> &v_eval,
+                                                const void *const *targets) {
+        this->setBlocks(v_eval, targets, typename Base::Indices{});
+    }
+
+ private:
+    template <int... K>
+    WAVE_STRONG_INLINE void setBlocks(const Evaluator<Derived> &v_eval,
+                                      const void *const *targets,
+                                      tmp::index_sequence<K...>) {
+        int foreach[] = {0, (this->template setBlock<K>(v_eval, targets[K]), 0)...};
+        (void) foreach;
+    }
+
+    template <int K>
+    WAVE_STRONG_INLINE void setBlock(const Evaluator<Derived> &v_eval,
+                                     const void *target) {
+        auto block = this->template block<K>();
+        // Check if Jacobian is wrt this Proxy
+        if (isSame(v_eval.expr, target)) {
+            block.setIdentity();
+            return;
+        }
+        // Otherwise, dynamically get the Jacobian of the derived expression
+        const auto &jac = v_eval.expr.jacobianIn(v_eval.context, target);
+        if (jac.size() > 0) {
+            block = jac;
+        } else {
+            block.setZero();
+        }
+    }
+};
+
+// A Proxy may contain any target, so its Jacobians are always found
+template <typename A, typename B>
+struct contains_same_type<A, B, enable_if_proxy_t<A>> : std::true_type {};
+
+// Proxies are matched by address, so they can be targets of stacked forward mode
+template <typename Derived>
+struct is_stackable_target<Derived, enable_if_proxy_t<Derived>> : std::true_type {};
+
 template <typename Derived, typename Target>
 struct JacobianEvaluator<
   Derived,
@@ -155,7 +294,8 @@ struct JacobianEvaluator<
         }
         // Otherwise, dynamically get the Jacobian of the derived expression and convert
         // to the expected optional-fixed-size return type
-        const auto dyn_jac = this->v_eval.expr.dynJacobian(this->target_ptr);
+        const auto dyn_jac =
+          this->v_eval.expr.jacobianIn(this->v_eval.context, this->target_ptr);
         if (dyn_jac.size() > 0) {
             return jacobian_t<Derived, Target>{dyn_jac};
         } else {
@@ -175,8 +315,8 @@ struct DynamicReverseJacobianEvaluator<Derived, Adjoint, enable_if_proxy_t<Deriv
       DynamicReverseResult<scalar_t<Derived>> &jac_map,
       const Evaluator<Derived> &v_eval,
       const Adjoint &adjoint) {
-        // Dynamically get the Jacobians of the derived expression
-        v_eval.expr.dynReverse(jac_map, adjoint.eval());
+        // Accumulate into the evaluator's context, or a running Tape
+        v_eval.expr.reverseIn(v_eval.context, jac_map, adjoint.eval());
     }
 };
 
@@ -0,0 +1,127 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_PROXYARENA_HPP
+#define WAVE_GEOMETRY_PROXYARENA_HPP
+
+namespace wave {
+
+/** Owns Dynamic nodes placed contiguously in large blocks, and frees them all at once
+ *
+ * Constructing a Proxy normally makes one heap allocation, with its own shared_ptr
+ * control block, for each node. Building a large graph is then dominated by the
+ * allocator, and the nodes end up scattered across the heap. A Proxy constructed with an
+ * arena instead bump-allocates its node in the arena's current block:
+ *
+ *     auto arena = ProxyArena{};
+ *     auto expr = makeProxy(arena, Translationd::Random());
+ *     for (...) {
+ *         expr = makeProxy(arena, makeProxy(arena, RotationMd::Random()) * expr);
+ *     }
+ *
+ * Nodes in an arena are not reference-counted: the arena owns them, and destroys them
+ * together when it is destroyed or cleared. Copying such a Proxy costs no atomic
+ * operations.
+ *
+ * @warning A Proxy constructed with an arena is left dangling if it outlasts the arena,
+ * including a Proxy stored in a node outside the arena.
+ */
+class ProxyArena {
+ public:
+    /** Constructs an empty arena. No memory is allocated until the first node.
+     *
+     * @param block_size number of bytes in each block. Larger nodes get their own block.
+     */
+    explicit ProxyArena(std::size_t block_size = 64 * 1024) noexcept
+        : block_size{block_size} {}
+
+    ProxyArena(const ProxyArena &) = delete;
+    ProxyArena &operator=(const ProxyArena &) = delete;
+
+    ~ProxyArena() {
+        this->destroyAll();
+    }
+
+    /** Constructs an object of type T in the arena, and returns a reference to it
+     *
+     * The object is destroyed when the arena is destroyed or cleared.
+     */
+    template <typename T, typename... Args>
+    T &emplace(Args &&... args) {
+        auto *ptr = new (this->allocate(sizeof(T), alignof(T)))
+          T(std::forward<Args>(args)...);
+        this->destructors.push_back({ptr, &ProxyArena::destroy<T>});
+        return *ptr;
+    }
+
+    /** Destroys all nodes, in the reverse order of their construction
+     *
+     * The blocks are kept to be reused by the next nodes.
+     */
+    void clear() {
+        this->destroyAll();
+        this->current = 0;
+        this->offset = 0;
+    }
+
+    /** Returns the number of objects in the arena */
+    std::size_t size() const noexcept {
+        return this->destructors.size();
+    }
+
+ private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+    };
+
+    struct Destructor {
+        void *ptr;
+        void (*destroy)(void *);
+    };
+
+    template <typename T>
+    static void destroy(void *ptr) {
+        static_cast<T *>(ptr)->~T();
+    }
+
+    /** Returns suitably aligned storage from the current block, or a new block */
+    void *allocate(std::size_t size, std::size_t alignment) {
+        for (; this->current < this->blocks.size(); ++this->current, this->offset = 0) {
+            auto &block = this->blocks[this->current];
+            void *ptr = block.data.get() + this->offset;
+            auto space = block.size - this->offset;
+            if (std::align(alignment, size, ptr, space)) {
+                this->offset = block.size - space + size;
+                return ptr;
+            }
+        }
+
+        // No existing block has room. Add one big enough for the object.
+        const auto new_size = std::max(this->block_size, size + alignment);
+        this->blocks.push_back({std::unique_ptr<char[]>{new char[new_size]}, new_size});
+        this->current = this->blocks.size() - 1;
+        this->offset = 0;
+        return this->allocate(size, alignment);
+    }
+
+    void destroyAll() {
+        for (auto it = this->destructors.rbegin(); it != this->destructors.rend(); ++it) {
+            it->destroy(it->ptr);
+        }
+        this->destructors.clear();
+    }
+
+    std::size_t block_size;
+    std::vector<Block> blocks;
+    std::vector<Destructor> destructors;
+
+    // Position of the next allocation: index of a block, and a byte offset into it
+    std::size_t current = 0;
+    std::size_t offset = 0;
+};
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_PROXYARENA_HPP
@@ -0,0 +1,536 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_TAPE_HPP
+#define WAVE_GEOMETRY_TAPE_HPP
+
+namespace wave {
+namespace internal {
+
+/** One step of a Tape: the evaluation of one Dynamic node
+ *
+ * The function pointers are static members of the node's concrete Dynamic type, so
+ * running an instruction is one indirect call rather than a chain of virtual calls.
+ */
+template <typename Scalar>
+struct TapeInstruction {
+    /** Address of the node's DynamicBase */
+    const void *node;
+
+    /** The node's slots, bound while the tape runs */
+    TapeSlots<Scalar> *slots;
+
+    /** Evaluates the node, returning the address of its value */
+    const void *(*evaluate)(const void *node);
+
+    /** Propagates the node's adjoint (rows * tangent size) to its children and leaves */
+    void (*reverse)(const void *node,
+                    DynamicReverseResult<Scalar> &jac_map,
+                    const Scalar *adjoint,
+                    int rows);
+
+    /** First column of the node's block in the tape's adjoint storage */
+    Eigen::Index adjoint_col;
+
+    /** The node's tangent size: the width of its adjoint block */
+    int tangent_size;
+
+    /** If the node only wraps a leaf, the leaf, which is also the node's value. The tape
+     * uses it instead of calling evaluate.
+     */
+    const void *leaf;
+
+    /** If the node only wraps a leaf, the start of the leaf's Jacobian block. The tape
+     * accumulates the adjoint there instead of calling reverse.
+     */
+    Scalar *leaf_jacobian;
+
+    /** Range of the node's children, as instruction indices, in the tape's edges */
+    std::size_t children_begin;
+    std::size_t children_end;
+
+    /** Range of the leaves the node references directly, in the order its reverse
+     * function visits them, as indices into the tape's leaves
+     */
+    std::size_t leaves_begin;
+    std::size_t leaves_end;
+
+    /** Index of the first instruction added while compiling the node. The instructions
+     * from there up to the node's own are the nodes first reached through it.
+     */
+    std::size_t first;
+
+    /** The node's value from the last run it was evaluated in */
+    const void *value;
+
+    /** Whether the node must be evaluated again: a leaf it references was marked as
+     * changed, or it has not been evaluated yet
+     */
+    bool changed;
+};
+
+/** Flattens a graph of Dynamic nodes into tape instructions in topological order
+ *
+ * Nodes reachable by more than one path are added once. For each node, the builder also
+ * records the edges to its children and the leaves it references directly, so the tape
+ * can tell which nodes depend on a changed leaf.
+ */
+template <typename Scalar>
+struct TapeBuilder {
+    TapeBuilder() = default;
+    TapeBuilder(TapeBuilder &&) = default;
+
+    ~TapeBuilder() {
+        this->unmark();
+    }
+    /** Adds the node and, before it, any of its children not already added
+     *
+     * @return index of the node's instruction
+     */
+    template <typename Leaf>
+    std::size_t add(const DynamicBase<Leaf> &node) {
+        if (node.tape_slots.instruction) {
+            return node.tape_slots.instruction - 1;
+        }
+        // Edges found while compiling this node start here. Its children use the
+        // positions after, and remove them when they are pushed.
+        this->frames.push_back({this->pending_children.size(),
+                                this->pending_leaves.size(),
+                                this->instructions.size()});
+        node.dynCompile(*this);
+        this->frames.pop_back();
+        return this->instructions.size() - 1;
+    }
+
+    /** Adds a child of the node being compiled. Called by addTapeChildren(). */
+    template <typename Leaf>
+    void addChild(const DynamicBase<Leaf> &node) {
+        const auto index = this->add(node);
+        this->pending_children.push_back(index);
+    }
+
+    /** Records a leaf referenced by the node being compiled. Called by addTapeChildren().
+     */
+    void addLeaf(const void *leaf, int tangent_size) {
+        this->pending_leaves.push_back(this->leaves.size());
+        this->leaves.emplace_back(leaf, tangent_size);
+    }
+
+    /** Appends the instruction for one node. Called by the node's dynCompile().
+     *
+     * @param leaf address of the leaf, if the node does nothing but wrap one. Then
+     * evaluate and reverse are not needed, and may be null.
+     */
+    template <typename Leaf>
+    void push(const DynamicBase<Leaf> &node,
+              const void *(*evaluate)(const void *),
+              void (*reverse)(const void *,
+                              DynamicReverseResult<Scalar> &,
+                              const Scalar *,
+                              int),
+              const void *leaf = nullptr) {
+        const auto index = this->instructions.size();
+        node.tape_slots.instruction = index + 1;
+        if (leaf) {
+            this->addLeaf(leaf, traits<Leaf>::TangentSize);
+        }
+
+        // Move the edges found since this node's frame began into the tape
+        const auto &frame = this->frames.back();
+        const auto children_begin = this->edges.size();
+        this->edges.insert(this->edges.end(),
+                           this->pending_children.begin() + frame.children,
+                           this->pending_children.end());
+        this->pending_children.resize(frame.children);
+        const auto leaves_begin = this->leaf_edges.size();
+        this->leaf_edges.insert(this->leaf_edges.end(),
+                                this->pending_leaves.begin() + frame.leaves,
+                                this->pending_leaves.end());
+        this->pending_leaves.resize(frame.leaves);
+
+        this->instructions.push_back({&node,
+                                      &node.tape_slots,
+                                      evaluate,
+                                      reverse,
+                                      this->adjoint_cols,
+                                      traits<Leaf>::TangentSize,
+                                      leaf,
+                                      nullptr,
+                                      children_begin,
+                                      this->edges.size(),
+                                      leaves_begin,
+                                      this->leaf_edges.size(),
+                                      frame.instructions,
+                                      nullptr,
+                                      true});
+        this->adjoint_cols += traits<Leaf>::TangentSize;
+    }
+
+    /** Clears the marks left on added nodes, so they can be added to another tape */
+    void unmark() {
+        for (const auto &instruction : this->instructions) {
+            instruction.slots->instruction = 0;
+        }
+    }
+
+    /** Positions in the pending vectors where the edges of a node being compiled begin,
+     * and the number of instructions when it began
+     */
+    struct Frame {
+        std::size_t children;
+        std::size_t leaves;
+        std::size_t instructions;
+    };
+
+    std::vector<TapeInstruction<Scalar>> instructions;
+    Eigen::Index adjoint_cols = 0;
+
+    /** Child instruction indices of all nodes, in the ranges given by each instruction */
+    std::vector<std::size_t> edges;
+
+    /** Indices into leaves of the leaves of all nodes, in the ranges given by each
+     * instruction
+     */
+    std::vector<std::size_t> leaf_edges;
+
+    /** Addresses and tangent sizes of all leaves, once per referencing node */
+    DynamicLeavesVec leaves;
+
+    /** IDs of the distinct leaves, and the ID of each element of leaves. Filled once
+     * all nodes are added.
+     */
+    LeafRegistry<const void *> registry;
+    std::vector<int> leaf_ids;
+
+    std::vector<Frame> frames;
+    std::vector<std::size_t> pending_children;
+    std::vector<std::size_t> pending_leaves;
+};
+
+/** addTapeChildren() functions find the Dynamic nodes directly below an expression, and
+ * pass them to a TapeBuilder or EvaluationContext.
+ *
+ * They mirror getLeaves(), but stop at each Proxy instead of following it.
+ */
+template <typename Builder,
+          typename Derived,
+          enable_if_leaf_or_scalar_t<Derived, int> = 0>
+void addTapeChildren(adl, Builder &builder, const Derived &leaf) {
+    builder.addLeaf(&leaf, traits<Derived>::TangentSize);
+}
+
+template <typename Builder, typename Derived, enable_if_unary_t<Derived, int> = 0>
+void addTapeChildren(adl, Builder &builder, const ExpressionBase<Derived> &expr) {
+    addTapeChildren(adl{}, builder, expr.derived().rhs());
+}
+
+template <typename Builder, typename Derived, enable_if_binary_t<Derived, int> = 0>
+void addTapeChildren(adl, Builder &builder, const ExpressionBase<Derived> &expr) {
+    addTapeChildren(adl{}, builder, expr.derived().lhs());
+    addTapeChildren(adl{}, builder, expr.derived().rhs());
+}
+
+template <typename Builder, typename Derived, enable_if_proxy_t<Derived, int> = 0>
+void addTapeChildren(adl, Builder &builder, const ExpressionBase<Derived> &proxy) {
+    builder.addChild(proxy.derived().follow());
+}
+
+}  // namespace internal
+
+/** A dynamic expression graph flattened into a linear sequence of instructions
+ *
+ * Evaluating a Proxy walks its graph through virtual calls, and finding all its
+ * Jacobians builds and sorts a map of leaves each time. A Tape does that work once, in
+ * compile(), and keeps a slot for each node's value and adjoint. It can then be run
+ * repeatedly as the values of the graph's leaves change:
+ *
+ *     auto tape = compile(proxy);
+ *     for (...) {
+ *         r1.value() = ...;  // Update leaves referenced by the graph
+ *         const auto &value_and_jac = tape.evaluateWithJacobians();
+ *     }
+ *
+ * Each node is evaluated once per run, even if it is shared by several parents, and runs
+ * allocate no memory.
+ *
+ * When only a few leaves change between runs, the tape can instead re-evaluate only the
+ * nodes which depend on them. Mark the changed leaves, then call update():
+ *
+ *     r1.value() = ...;
+ *     tape.markChanged(r1);
+ *     const auto &value_and_jac = tape.updateWithJacobians();
+ *
+ * Other nodes reuse their values from the previous run.
+ *
+ * @warning The tape records the structure of the graph at compile(). If any Proxy in the
+ * graph is rebound afterwards, the graph must be compiled again.
+ * @warning While it runs, the tape binds values into the nodes of its graph. Unlike
+ * other evaluations, it must not run while those nodes are evaluated on another thread.
+ *
+ * @tparam Leaf The leaf type the graph evaluates to
+ */
+template <typename Leaf>
+class Tape {
+    using Scalar = internal::scalar_t<Leaf>;
+    using EvalType = internal::eval_t<Leaf>;
+    using OutputType = internal::plain_output_t<Proxy<Leaf>>;
+    using JacobianMap = internal::DynamicReverseResult<Scalar>;
+    enum : int { TangentSize = internal::traits<Leaf>::TangentSize };
+
+ public:
+    explicit Tape(const Proxy<Leaf> &proxy) : Tape{proxy, build(proxy)} {}
+
+    // Instructions point into the tape's own Jacobian storage, so it can be moved only
+    Tape(const Tape &) = delete;
+    Tape(Tape &&) = default;
+    Tape &operator=(const Tape &) = delete;
+    Tape &operator=(Tape &&) = default;
+
+    /** Evaluates the graph with the current values of its leaves */
+    auto evaluate() -> OutputType {
+        const auto out = this->forward();
+        this->unbind();
+        return out;
+    }
+
+    /** Evaluates the graph and its Jacobians with respect to all leaves, in reverse mode
+     *
+     * @return result and map of leaf address to Jacobians, as in
+     * evaluateWithDynamicReverseJacobians(). The map is owned by the tape, and is
+     * overwritten by the next run.
+     */
+    auto evaluateWithJacobians() & -> std::pair<OutputType, const JacobianMap &> {
+        const auto out = this->forward();
+        return {out, this->reverse()};
+    }
+
+    /** Evaluates the graph and its Jacobians, moving the map out of the expiring tape */
+    auto evaluateWithJacobians() && -> std::pair<OutputType, JacobianMap> {
+        const auto out = this->forward();
+        this->reverse();
+        return {out, std::move(this->jac_map)};
+    }
+
+    /** Marks a leaf as changed since the last run
+     *
+     * The next update() re-evaluates the nodes which depend on the leaf. Leaves which are
+     * not in the graph are ignored.
+     */
+    template <typename Derived>
+    void markChanged(const ExpressionBase<Derived> &leaf) {
+        const auto key = static_cast<const void *>(&leaf.derived());
+        const auto compare = [](const std::pair<const void *, std::size_t> &user,
+                                const void *address) { return user.first < address; };
+        auto it = std::lower_bound(
+          this->leaf_users.begin(), this->leaf_users.end(), key, compare);
+        for (; it != this->leaf_users.end() && it->first == key; ++it) {
+            this->instructions[it->second].changed = true;
+        }
+    }
+
+    /** Evaluates the graph, re-evaluating only nodes which depend on changed leaves
+     *
+     * @warning Leaves changed without markChanged() are not noticed. The nodes which
+     * depend on them keep their previous values.
+     */
+    auto update() -> OutputType {
+        const auto out = this->forwardChanged();
+        this->unbindChanged();
+        return out;
+    }
+
+    /** Evaluates the graph and its Jacobians, re-evaluating only nodes which depend on
+     * changed leaves
+     *
+     * The adjoints are propagated through the whole graph, since they change along with
+     * the root. Each node computes its Jacobians from its cached value.
+     *
+     * @see update(), evaluateWithJacobians()
+     */
+    auto updateWithJacobians() -> std::pair<OutputType, const JacobianMap &> {
+        const auto out = this->forwardChanged();
+        this->bound.clear();
+        for (auto &instruction : this->instructions) {
+            this->bind(instruction);
+        }
+        return {out, this->reverse()};
+    }
+
+    /** Returns the number of instructions: one for each distinct node in the graph */
+    std::size_t size() const noexcept {
+        return this->instructions.size();
+    }
+
+ private:
+    static auto build(const Proxy<Leaf> &proxy) -> internal::TapeBuilder<Scalar> {
+        auto builder = internal::TapeBuilder<Scalar>{};
+        builder.add(proxy.follow());
+        builder.unmark();
+
+        // Each shared leaf is listed once per referencing node; give each one ID
+        const auto &leaves = builder.leaves;
+        builder.registry = LeafRegistry<const void *>{
+          leaves.begin(), leaves.end(), &builder.leaf_ids};
+        return builder;
+    }
+
+    Tape(const Proxy<Leaf> &proxy, internal::TapeBuilder<Scalar> &&builder)
+        : root{proxy},
+          instructions{std::move(builder.instructions)},
+          edges{std::move(builder.edges)},
+          adjoints{TangentSize, builder.adjoint_cols},
+          jac_map{std::move(builder.registry), TangentSize} {
+        // Resolve each node's leaves to IDs once. Nodes which only wrap a leaf accumulate
+        // straight into its Jacobian. Others visit their leaves in reverse(), in the
+        // order of the instructions run backwards, so the map can expect that order.
+        auto visits = std::vector<int>{};
+        for (auto k = this->instructions.size(); k-- > 0;) {
+            auto &instruction = this->instructions[k];
+            for (auto i = instruction.leaves_begin; i < instruction.leaves_end; ++i) {
+                const auto record = builder.leaf_edges[i];
+                const auto id = builder.leaf_ids[record];
+                this->leaf_users.emplace_back(builder.leaves[record].first, k);
+                if (instruction.leaf) {
+                    instruction.leaf_jacobian = this->jac_map.block(id).data();
+                } else {
+                    visits.push_back(id);
+                }
+            }
+        }
+        this->jac_map.expectVisits(std::move(visits));
+        std::sort(this->leaf_users.begin(), this->leaf_users.end());
+        this->bound.reserve(this->instructions.size() + this->edges.size());
+    }
+
+    Scalar *adjointSlot(const internal::TapeInstruction<Scalar> &instruction) {
+        return this->adjoints.data() + instruction.adjoint_col * TangentSize;
+    }
+
+    void accumulateLeaf(const internal::TapeInstruction<Scalar> &instruction) {
+        const auto cols = instruction.tangent_size;
+        using Block = Eigen::Matrix<Scalar, TangentSize, Eigen::Dynamic>;
+        Eigen::Map<Block>{instruction.leaf_jacobian, TangentSize, cols} +=
+          Eigen::Map<const Block>{this->adjointSlot(instruction), TangentSize, cols};
+    }
+
+    /** Evaluates one node, and binds the slots used by its parents */
+    void run(internal::TapeInstruction<Scalar> &instruction) {
+        if (instruction.leaf) {
+            instruction.value = instruction.leaf;
+        } else {
+            instruction.value = instruction.evaluate(instruction.node);
+        }
+        this->bind(instruction);
+    }
+
+    void bind(internal::TapeInstruction<Scalar> &instruction) {
+        instruction.slots->value = instruction.value;
+        instruction.slots->adjoint = this->adjointSlot(instruction);
+    }
+
+    auto rootValue() const -> OutputType {
+        return internal::prepareLeafForOutput<Proxy<Leaf>>(
+          *static_cast<const EvalType *>(this->instructions.back().value));
+    }
+
+    /** Evaluates every node in order */
+    auto forward() -> OutputType {
+        for (auto &instruction : this->instructions) {
+            this->run(instruction);
+        }
+        return this->rootValue();
+    }
+
+    /** Evaluates, in order, the nodes which are marked as changed or have a changed
+     * child
+     *
+     * Other nodes are not touched, except to bind the cached values of children of
+     * changed nodes. The indices of all bound nodes are recorded, to unbind them later.
+     */
+    auto forwardChanged() -> OutputType {
+        const auto n = this->instructions.size();
+        for (std::size_t k = 0; k < n; ++k) {
+            auto &instruction = this->instructions[k];
+            const auto begin = instruction.children_begin;
+            const auto end = instruction.children_end;
+            for (auto i = begin; i < end; ++i) {
+                instruction.changed |= this->instructions[this->edges[i]].changed;
+            }
+            if (instruction.changed) {
+                for (auto i = begin; i < end; ++i) {
+                    this->bind(this->instructions[this->edges[i]]);
+                    this->bound.push_back(this->edges[i]);
+                }
+                this->run(instruction);
+                this->bound.push_back(k);
+            }
+        }
+        return this->rootValue();
+    }
+
+    /** Propagates adjoints from the root to every leaf, after a forward pass */
+    auto reverse() -> const JacobianMap & {
+        // The root is the last instruction; its adjoint is the identity
+        this->adjoints.setZero();
+        this->adjoints.template rightCols<TangentSize>().setIdentity();
+        this->jac_map.setZero();
+        this->jac_map.rewindVisits();
+
+        // Each node's adjoint is complete once all nodes above it have run
+        const auto rend = this->instructions.rend();
+        for (auto it = this->instructions.rbegin(); it != rend; ++it) {
+            if (it->leaf_jacobian) {
+                this->accumulateLeaf(*it);
+            } else {
+                it->reverse(it->node, this->jac_map, this->adjointSlot(*it), TangentSize);
+            }
+        }
+        this->unbind();
+        return this->jac_map;
+    }
+
+    /** Unbinds all slots, so the graph can be evaluated without the tape again. Every
+     * node's value is now current, so clears the changed flags.
+     */
+    void unbind() {
+        for (auto &instruction : this->instructions) {
+            *instruction.slots = internal::TapeSlots<Scalar>{};
+            instruction.changed = false;
+        }
+    }
+
+    /** Unbinds only the nodes bound by forwardChanged() */
+    void unbindChanged() {
+        for (const auto k : this->bound) {
+            *this->instructions[k].slots = internal::TapeSlots<Scalar>{};
+            this->instructions[k].changed = false;
+        }
+        this->bound.clear();
+    }
+
+    Proxy<Leaf> root;
+    std::vector<internal::TapeInstruction<Scalar>> instructions;
+    std::vector<std::size_t> edges;
+    std::vector<std::pair<const void *, std::size_t>> leaf_users;
+    std::vector<std::size_t> bound;
+    Eigen::Matrix<Scalar, TangentSize, Eigen::Dynamic> adjoints;
+    JacobianMap jac_map;
+
+    // Runs the same instructions, forking independent subtrees onto a thread pool
+    template <typename>
+    friend class ParallelTape;
+};
+
+/** Flattens the graph of a Proxy into a Tape, which can be evaluated repeatedly
+ *
+ * @see Tape
+ */
+template <typename Leaf>
+auto compile(const Proxy<Leaf> &proxy) -> Tape<Leaf> {
+    return Tape<Leaf>{proxy};
+}
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_TAPE_HPP
@@ -31,6 +31,19 @@ WAVE_OVERLOAD_FUNCTION_FOR_RVALUES(operator*,
                                    RigidTransformBase,
                                    TranslationBase)
 
+/** Returns the adjoint of a rigid transform leaf, as a structured 6x6 matrix
+ *
+ * See AdjointMatrix. From http://ethaneade.com/lie.pdf - note we swap order of rotation
+ * and translation, as in Twist.
+ */
+template <typename Derived>
+auto adjointMatrix(const RigidTransformBase<Derived> &T)
+  -> AdjointMatrix<internal::scalar_t<Derived>> {
+    using Mat3 = Eigen::Matrix<internal::scalar_t<Derived>, 3, 3>;
+    return AdjointMatrix<internal::scalar_t<Derived>>{
+      Mat3{T.derived().rotation().value()}, T.derived().translation().value()};
+}
+
 namespace internal {
 
 /** Base for traits of a rigid transform leaf using an Eigen type for storage.*/
@@ -73,27 +86,16 @@ auto evalImpl(expr<Inverse>, const RigidTransformBase<Rhs> &rhs) {
       -(inverse(rhs.derived().rotation()) * rhs.derived().translation())};
 }
 
-/** Jacobian of Inverse for any rigid transform */
+/** Jacobian of Inverse for any rigid transform
+ *
+ * The derivative of the inverse can be found by applying the adjoint identity (see
+ * http://ethaneade.com/lie.pdf) to be negative adjoint of the inverted SE(3)
+ */
 template <typename Val, typename Rhs>
 auto jacobianImpl(expr<Inverse>,
                   const RigidTransformBase<Val> &val,
-                  const RigidTransformBase<Rhs> &) -> jacobian_t<Val, Rhs> {
-    using Scalar = scalar_t<Val>;
-    using Mat3 = Eigen::Matrix<Scalar, 3, 3>;
-
-    // The derivative of the inverse can be found by applying the adjoint identity
-    // (see http://ethaneade.com/lie.pdf) to be negative adjoint of the inverted SE(3)
-    // @todo factor out adjoint
-    const auto &R = Mat3{val.derived().rotation().value()};
-    const auto &t = val.derived().translation().value();
-    jacobian_t<Val, Rhs> adj{};
-
-    adj.template topLeftCorner<3, 3>() = R;
-    adj.template bottomLeftCorner<3, 3>() = crossMatrix(t) * R;
-    adj.template topRightCorner<3, 3>().setZero();
-    adj.template bottomRightCorner<3, 3>() = R;
-
-    return -adj;
+                  const RigidTransformBase<Rhs> &) -> AdjointMatrix<scalar_t<Val>> {
+    return -adjointMatrix(val);
 }
 
 /** Implementation of Compose for any rigid transform
@@ -116,36 +118,28 @@ auto evalImpl(expr<LogMap>, const RigidTransformBase<Rhs> &rhs) ->
   typename traits<Rhs>::TangentType {
     using Scalar = scalar_t<Rhs>;
     using Vec3 = Eigen::Matrix<Scalar, 3, 1>;
-    using Mat3 = Eigen::Matrix<Scalar, 3, 3>;
 
     // Logmap of rotation part: delegate to RelativeRotation code
     const Vec3 omega = eval(log(rhs.derived().rotation())).value();
 
     // Logmap of translation part: not trivial (see http://ethaneade.com/lie.pdf)
-    // @todo optimize
-    Vec3 ln_t;
+    // Vinv = I - cross / 2 + D * cross2, where D = (1 - A / (2 * B)) / theta2
     const auto theta2 = omega.squaredNorm();
-    const auto theta = std::sqrt(theta2);
-    if (theta2 > Eigen::NumTraits<Scalar>::epsilon()) {
+    Scalar D;
+    if (theta2 > Scalar{1e-3}) {
+        const auto theta = std::sqrt(theta2);
         const auto A = std::sin(theta) / theta;
         const auto B = (1 - std::cos(theta)) / theta2;
-        const Mat3 cross = crossMatrix(omega);
-        const Mat3 cross2 = cross * cross;
-
-        const Mat3 Vinv =
-          Mat3::Identity() - cross / 2 + (1 - A / 2 / B) / theta2 * cross2;
-
-        ln_t = Vinv * rhs.derived().translation().value();
-
+        D = (1 - A / 2 / B) / theta2;
     } else {
-        // small theta2; use limit as theta -> 0
-        // @todo: use Taylor series, not just the limit!
-        const Mat3 cross = crossMatrix(omega);
-
-        const Mat3 Vinv = Mat3::Identity() - cross / 2;
-
-        ln_t = Vinv * rhs.derived().translation().value();
+        // small theta2; D cancels catastrophically, so use its Taylor series
+        D = Scalar{1} / Scalar{12} + theta2 / Scalar{720} +
+            theta2 * theta2 / Scalar{30240};
     }
+    // Apply Vinv without forming it
+    const auto &t = rhs.derived().translation().value();
+    const Vec3 omega_t = omega.cross(t);
+    const Vec3 ln_t = t - omega_t / 2 + D * omega.cross(omega_t);
     return typename traits<Rhs>::TangentType{omega, ln_t};
 }
 
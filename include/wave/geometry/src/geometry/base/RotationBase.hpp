@@ -55,6 +55,13 @@ auto operator*(const RotationBase<L> &lhs, const TranslationBase<R> &rhs) {
 
 WAVE_OVERLOAD_FUNCTION_FOR_RVALUES(operator*, Rotate, RotationBase, TranslationBase)
 
+/** Returns the adjoint of a rotation leaf, which is its rotation matrix */
+template <typename Derived>
+auto adjointMatrix(const RotationBase<Derived> &R)
+  -> Eigen::Matrix<internal::scalar_t<Derived>, 3, 3> {
+    return Eigen::Matrix<internal::scalar_t<Derived>, 3, 3>{R.derived().value()};
+}
+
 namespace internal {
 
 /** Base for traits of a rotation leaf expression using an Eigen type for storage.*/
@@ -124,29 +124,16 @@ WAVE_OVERLOAD_FUNCTION_FOR_RVALUES_REQ(operator+,
 
 namespace internal {
 
-/** Jacobian of Compose wrt any transform rhs
+/** Jacobian of Compose wrt any transform rhs: the adjoint of the lhs
+ *
+ * See adjointMatrix() for rotations and rigid transforms.
  */
 template <typename Val, typename Lhs, typename Rhs>
 auto rightJacobianImpl(expr<Compose>,
                        const TransformBase<Val> &,
                        const TransformBase<Lhs> &lhs,
-                       const TransformBase<Rhs> &) -> jacobian_t<Val, Lhs> {
-    using Scalar = scalar_t<Val>;
-    using Mat3 = Eigen::Matrix<Scalar, 3, 3>;
-
-    // From http://ethaneade.com/lie.pdf - note we swap order of rotation and translation
-    // Actually the adjoint of SE(3)
-    // @todo factor out adjoint
-    const auto &R = Mat3{lhs.derived().rotation().value()};
-    const auto &t = lhs.derived().translation().value();
-    jacobian_t<Val, Lhs> out{};
-
-    out.template topLeftCorner<3, 3>() = R;
-    out.template bottomLeftCorner<3, 3>() = crossMatrix(t) * R;
-    out.template topRightCorner<3, 3>().setZero();
-    out.template bottomRightCorner<3, 3>() = R;
-
-    return out;
+                       const TransformBase<Rhs> &) {
+    return adjointMatrix(lhs.derived());
 }
 
 /** Implements Transform for any transform
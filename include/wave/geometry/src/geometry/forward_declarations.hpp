@@ -59,6 +59,9 @@ struct Inverse;
 template <typename Rhs>
 struct ExpMap;
 
+template <typename ToDerived, typename Rhs>
+struct ExpMapTo;
+
 template <typename Rhs, typename ExtraFrame>
 struct LogMap;
 
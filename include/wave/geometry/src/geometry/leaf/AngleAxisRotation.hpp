@@ -65,6 +65,9 @@ auto evalImpl(expr<Inverse>, const AngleAxisRotation<Rhs> &a) {
     return makeLeaf<AngleAxisRotation>(a.value().inverse());
 }
 
+template <typename Rhs>
+auto evalCost(expr<Inverse>, const AngleAxisRotation<Rhs> &) -> flops<3>;
+
 /** Jacobian of inverse of an angle-axis */
 template <typename Val, typename Rhs>
 auto jacobianImpl(expr<Inverse>,
@@ -91,6 +94,10 @@ auto evalImpl(expr<Convert, AngleAxisRotation<ToImpl>>,
     return AngleAxisRotation<ToImpl>{rhs.value()};
 }
 
+template <typename ToImpl, typename FromImpl>
+auto evalCost(expr<Convert, AngleAxisRotation<ToImpl>>,
+              const AngleAxisRotation<FromImpl> &) -> flops<4>;
+
 /** Converts from angle-axis to rotation matrix
  */
 template <typename ToImpl, typename FromImpl>
@@ -100,6 +107,10 @@ auto evalImpl(expr<Convert, MatrixRotation<ToImpl>>,
     return MatrixRotation<ToImpl>{rhs.value().toRotationMatrix()};
 }
 
+template <typename ToImpl, typename FromImpl>
+auto evalCost(expr<Convert, MatrixRotation<ToImpl>>, const AngleAxisRotation<FromImpl> &)
+  -> flops<65>;
+
 /** Converts from rotation matrix to angle-axis
  */
 template <typename ToImpl, typename FromImpl>
@@ -115,9 +126,13 @@ template <typename ToImpl, typename FromImpl>
 auto evalImpl(expr<Convert, QuaternionRotation<ToImpl>>,
               const AngleAxisRotation<FromImpl> &rhs) {
     // Use Eigen's implementation
-    return QuaternionRotation<ToImpl>{rhs.value().toRotationMatrix()};
+    return QuaternionRotation<ToImpl>{rhs.value()};
 }
 
+template <typename ToImpl, typename FromImpl>
+auto evalCost(expr<Convert, QuaternionRotation<ToImpl>>,
+              const AngleAxisRotation<FromImpl> &) -> flops<45>;
+
 /** Converts from quaternion to angle-axis
  */
 template <typename ToImpl, typename FromImpl>
@@ -104,6 +104,70 @@ struct traits<CompactRigidTransform<ImplType>>
     using PlainType = CompactRigidTransform<typename ImplType::PlainObject>;
 };
 
+/** Implements inverse of a compact rigid transform
+ *
+ * The conjugate of the quaternion is its inverse, assuming it is normalized.
+ */
+template <typename Rhs>
+auto evalImpl(expr<Inverse>, const CompactRigidTransform<Rhs> &rhs)
+  -> plain_eval_t<CompactRigidTransform<Rhs>> {
+    const auto q_inv = rhs.rotation().value().conjugate();
+    plain_eval_t<CompactRigidTransform<Rhs>> out;
+    out.value().template head<4>() = q_inv.coeffs();
+    out.value().template tail<3>() = -(q_inv * rhs.translation().value());
+    return out;
+}
+
+template <typename Rhs>
+auto evalCost(expr<Inverse>, const CompactRigidTransform<Rhs> &) -> flops<21>;
+
+/** Implements composition of compact rigid transforms
+ *
+ * Eigen rotates a vector by a quaternion with two cross products, without forming the
+ * rotation matrix.
+ */
+template <typename Lhs, typename Rhs>
+auto evalImpl(expr<Compose>,
+              const CompactRigidTransform<Lhs> &lhs,
+              const CompactRigidTransform<Rhs> &rhs)
+  -> plain_eval_t<CompactRigidTransform<Lhs>> {
+    const auto q_lhs = lhs.rotation().value();
+    plain_eval_t<CompactRigidTransform<Lhs>> out;
+    out.value().template head<4>() = (q_lhs * rhs.rotation().value()).coeffs();
+    out.value().template tail<3>() =
+      q_lhs * rhs.translation().value() + lhs.translation().value();
+    return out;
+}
+
+template <typename Lhs, typename Rhs>
+auto evalCost(expr<Compose>,
+              const CompactRigidTransform<Lhs> &,
+              const CompactRigidTransform<Rhs> &) -> flops<46>;
+
+/** Implements transformation of a point by a compact rigid transform */
+template <typename Lhs, typename Rhs>
+auto evalImpl(expr<Transform>,
+              const CompactRigidTransform<Lhs> &lhs,
+              const Translation<Rhs> &rhs) -> plain_eval_t<Translation<Rhs>> {
+    return plain_eval_t<Translation<Rhs>>{lhs.rotation().value() * rhs.value() +
+                                          lhs.translation().value()};
+}
+
+template <typename Lhs, typename Rhs>
+auto evalCost(expr<Transform>,
+              const CompactRigidTransform<Lhs> &,
+              const Translation<Rhs> &) -> flops<18>;
+
+/** Jacobian of transformation of a point by a compact rigid transform, wrt the point */
+template <typename Val, typename Lhs, typename Rhs>
+auto rightJacobianImpl(expr<Transform>,
+                       const Translation<Val> &,
+                       const CompactRigidTransform<Lhs> &lhs,
+                       const Translation<Rhs> &)
+  -> jacobian_t<Translation<Val>, Translation<Rhs>> {
+    return lhs.rotation().value().toRotationMatrix();
+}
+
 /** Converts from compact to matrix rigid transform
  */
 template <typename ToImpl, typename FromImpl>
@@ -88,6 +88,15 @@ decltype(auto) evalImpl(expr<Compose>, const Identity<Lhs> &lhs, const Identity<
     return lhs;
 };
 
+/** Jacobian of Compose wrt the rhs, when the lhs is Identity */
+template <typename Val, typename Lhs, typename Rhs>
+auto rightJacobianImpl(expr<Compose>,
+                       const TransformBase<Val> &,
+                       const Identity<Lhs> &,
+                       const TransformBase<Rhs> &) {
+    return identity_t<Val>{};
+}
+
 template <typename Lhs, typename Rhs>
 decltype(auto) evalImpl(expr<Rotate>,
                         const Identity<Lhs> &,
@@ -8,18 +8,23 @@
 
 namespace wave {
 
-/** A proper rigid transformation in SE(3), stored as a 4x4 matrix
+/** A proper rigid transformation in SE(3), stored as a 4x4 or 3x4 matrix
  *
  * @tparam ImplType The type to use for storage (e.g. Eigen::Matrix4d or a Map)
  *
- * The alias RigidTransformMd is provided for the typical storage type, Eigen::Matrix4d.
+ * The last row of a 4x4 homogeneous matrix is constant. A 3x4 ImplType stores only the
+ * `[R|t]` block, using 25% less memory.
+ *
+ * The alias RigidTransformMd is provided for the typical storage type, Eigen::Matrix4d,
+ * and RigidTransformM34d for 3x4 storage, Eigen::Matrix<double, 3, 4>.
  */
 template <typename ImplType>
 class MatrixRigidTransform
     : public RigidTransformBase<MatrixRigidTransform<ImplType>>,
       public LeafStorage<MatrixRigidTransform<ImplType>, ImplType> {
-    static_assert(internal::is_eigen_matrix<4, ImplType>::value,
-                  "ImplType must be an Eigen 4x4 matrix type.");
+    static_assert(internal::is_eigen_matrix<4, ImplType>::value ||
+                    internal::is_eigen_matrix_of_size<3, 4, ImplType>::value,
+                  "ImplType must be an Eigen 4x4 or 3x4 matrix type.");
 
     using Storage = LeafStorage<MatrixRigidTransform<ImplType>, ImplType>;
     using Scalar = typename Eigen::internal::traits<ImplType>::Scalar;
@@ -30,14 +35,23 @@ class MatrixRigidTransform
     using TranslationBlock = Eigen::Block<ImplType, 3, 1>;
     using TranslationConstBlock = Eigen::Block<const ImplType, 3, 1>;
 
+    // Whether the storage has the constant last row
+    using HasLastRow = tmp::bool_constant<ImplType::RowsAtCompileTime == 4>;
+
+    void fillLastRow(std::true_type) {
+        this->value().row(3) << Scalar{0}, Scalar{0}, Scalar{0}, Scalar{1};
+    }
+
+    void fillLastRow(std::false_type) {}
+
  public:
     // Inherit constructors from LeafStorage
     using Storage::Storage;
     using Storage::operator=;
 
-    /** Construct an uninitialized RT, except fill the last row */
+    /** Construct an uninitialized RT, except fill the last row, if stored */
     MatrixRigidTransform() {
-        this->value().row(3) << Scalar{0}, Scalar{0}, Scalar{0}, Scalar{1};
+        fillLastRow(HasLastRow{});
     }
 
     WAVE_DEFAULT_COPY_AND_MOVE_FUNCTIONS(MatrixRigidTransform)
@@ -68,12 +82,13 @@ class MatrixRigidTransform
                          const Eigen::MatrixBase<TDerived> &t)
         : MatrixRigidTransform{q.toRotationMatrix(), t} {};
 
-    /** Construct from an Eigen 4x4 transformation matrix */
-    template <typename MDerived, TICK_REQUIRES(internal::is_eigen_matrix<4, MDerived>{})>
+    /** Construct from an Eigen transformation matrix of the same size as ImplType */
+    template <typename MDerived,
+              TICK_REQUIRES(internal::is_eigen_matrix_of_size<ImplType::RowsAtCompileTime,
+                                                              4,
+                                                              MDerived>{})>
     explicit MatrixRigidTransform(const Eigen::MatrixBase<MDerived> &m)
-        : Storage{typename Storage::init_storage{}, m} {
-        EIGEN_STATIC_ASSERT_MATRIX_SPECIFIC_SIZE(MDerived, 4, 4);
-    }
+        : Storage{typename Storage::init_storage{}, m.derived()} {}
 
     /** Returns a mutable expression referring to the translation portion of this
      * transform */
@@ -126,14 +141,78 @@ auto evalImpl(expr<Convert, Leaf>, const Identity<Leaf> &) {
 /** Implements "conversion" between MatrixRigidTransform types
  *
  * While this seems trivial, it is needed for the case the template params are not the
- * same.
+ * same. Only the `[R|t]` rows are copied, so it also converts between 4x4 and 3x4
+ * storage.
  */
 template <typename ToImpl, typename FromImpl>
 auto evalImpl(expr<Convert, MatrixRigidTransform<ToImpl>>,
               const MatrixRigidTransform<FromImpl> &rhs) {
-    return MatrixRigidTransform<ToImpl>{rhs.value()};
+    MatrixRigidTransform<ToImpl> out{};
+    out.value().template topRows<3>() = rhs.value().template topRows<3>();
+    return out;
+}
+
+/** Implements inverse of a matrix rigid transform
+ *
+ * The inverse of `[R|t]` is `[R^T|-R^T t]`. The last row, if stored, is not read.
+ */
+template <typename Rhs>
+auto evalImpl(expr<Inverse>, const MatrixRigidTransform<Rhs> &rhs)
+  -> plain_eval_t<MatrixRigidTransform<Rhs>> {
+    const auto &R = rhs.value().template topLeftCorner<3, 3>();
+    plain_eval_t<MatrixRigidTransform<Rhs>> out{};
+    out.value().template topLeftCorner<3, 3>() = R.transpose();
+    out.value().template topRightCorner<3, 1>().noalias() =
+      -(R.transpose() * rhs.value().template topRightCorner<3, 1>());
+    return out;
+}
+
+template <typename Rhs>
+auto evalCost(expr<Inverse>, const MatrixRigidTransform<Rhs> &) -> flops<18>;
+
+/** Implements composition of matrix rigid transforms
+ *
+ * The rotation of the lhs multiplies the `[R|t]` rows of the rhs in one coefficient-wise
+ * (lazy) 3x3 by 3x4 product, then the translation of the lhs is added. The constant last row of a 4x4
+ * matrix is neither read nor multiplied.
+ */
+template <typename Lhs, typename Rhs>
+auto evalImpl(expr<Compose>,
+              const MatrixRigidTransform<Lhs> &lhs,
+              const MatrixRigidTransform<Rhs> &rhs)
+  -> plain_eval_t<MatrixRigidTransform<Lhs>> {
+    plain_eval_t<MatrixRigidTransform<Lhs>> out{};
+    out.value().template topRows<3>() =
+      lhs.value().template topLeftCorner<3, 3>().lazyProduct(
+        rhs.value().template topRows<3>());
+    out.value().template topRightCorner<3, 1>() +=
+      lhs.value().template topRightCorner<3, 1>();
+    return out;
 }
 
+template <typename Lhs, typename Rhs>
+auto evalCost(expr<Compose>,
+              const MatrixRigidTransform<Lhs> &,
+              const MatrixRigidTransform<Rhs> &) -> flops<63>;
+
+/** Implements transformation of a point by a matrix rigid transform
+ *
+ * The point is multiplied in homogeneous form by the `[R|t]` rows, which Eigen evaluates
+ * as one vectorized 3x3 matrix-vector product plus the last column.
+ */
+template <typename Lhs, typename Rhs>
+auto evalImpl(expr<Transform>,
+              const MatrixRigidTransform<Lhs> &lhs,
+              const Translation<Rhs> &rhs) -> plain_eval_t<Translation<Rhs>> {
+    return plain_eval_t<Translation<Rhs>>{lhs.value().template topRows<3>() *
+                                          rhs.value().homogeneous()};
+}
+
+template <typename Lhs, typename Rhs>
+auto evalCost(expr<Transform>,
+              const MatrixRigidTransform<Lhs> &,
+              const Translation<Rhs> &) -> flops<18>;
+
 }  // namespace internal
 
 // Convenience typedefs
@@ -143,6 +222,11 @@ using RigidTransformMd = MatrixRigidTransform<Eigen::Matrix4d>;
 template <typename F1, typename F2>
 using RigidTransformMFd = Framed<RigidTransformMd, F1, F2>;
 
+using RigidTransformM34d = MatrixRigidTransform<Eigen::Matrix<double, 3, 4>>;
+
+template <typename F1, typename F2>
+using RigidTransformM34Fd = Framed<RigidTransformM34d, F1, F2>;
+
 }  // namespace wave
 
 #endif  // WAVE_GEOMETRY_MATRIXRIGIDTRANSFORM_HPP
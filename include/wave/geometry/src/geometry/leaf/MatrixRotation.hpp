@@ -60,6 +60,9 @@ auto evalImpl(expr<Inverse>, const MatrixRotation<Rhs> &m) {
     return makeLeaf<MatrixRotation>(m.derived().value().transpose());
 }
 
+template <typename Rhs>
+auto evalCost(expr<Inverse>, const MatrixRotation<Rhs> &) -> flops<0>;
+
 /** Jacobian of inverse of a rotation matrix */
 template <typename Val, typename Rhs>
 decltype(auto) jacobianImpl(expr<Inverse>,
@@ -88,6 +91,9 @@ auto evalImpl(expr<LogMap>, const MatrixRotation<ImplType> &rhs) ->
     }
 }
 
+template <typename ImplType>
+auto evalCost(expr<LogMap>, const MatrixRotation<ImplType> &) -> flops<60>;
+
 /** Implements composition of rotation matrices */
 template <typename Lhs, typename Rhs>
 auto evalImpl(expr<Compose>,
@@ -96,6 +102,10 @@ auto evalImpl(expr<Compose>,
     return plain_eval_t<MatrixRotation<Lhs>>{lhs.value() * rhs.value()};
 }
 
+template <typename Lhs, typename Rhs>
+auto evalCost(expr<Compose>, const MatrixRotation<Lhs> &, const MatrixRotation<Rhs> &)
+  -> flops<45>;
+
 /** Right jacobian of composition with a rotation matrix on the lhs
  *
  * Since we already have a matrix, we can return a reference. */
@@ -113,6 +123,10 @@ auto evalImpl(expr<Rotate>, const MatrixRotation<Lhs> &lhs, const Translation<Rh
     return plain_eval_t<Translation<Rhs>>{lhs.value() * rhs.value()};
 }
 
+template <typename Lhs, typename Rhs>
+auto evalCost(expr<Rotate>, const MatrixRotation<Lhs> &, const Translation<Rhs> &)
+  -> flops<15>;
+
 /** Jacobian of rotation wrt to the vector
  *
  * Since we already have a matrix, we can return a reference. */
@@ -137,6 +151,10 @@ auto evalImpl(expr<Convert, MatrixRotation<ToImpl>>,
     return MatrixRotation<ToImpl>{rhs.derived().value()};
 }
 
+template <typename ToImpl, typename FromImpl>
+auto evalCost(expr<Convert, MatrixRotation<ToImpl>>, const MatrixRotation<FromImpl> &)
+  -> flops<9>;
+
 }  // namespace internal
 
 // Convenience typedefs
@@ -67,6 +67,9 @@ auto evalImpl(expr<Inverse>, const QuaternionRotation<Rhs> &m) {
     return makeLeaf<QuaternionRotation>(m.derived().value().conjugate());
 }
 
+template <typename Rhs>
+auto evalCost(expr<Inverse>, const QuaternionRotation<Rhs> &) -> flops<3>;
+
 /** Jacobian of inverse of a quaternion */
 template <typename Val, typename Rhs>
 auto jacobianImpl(expr<Inverse>,
@@ -76,8 +79,34 @@ auto jacobianImpl(expr<Inverse>,
     return -q_inv.value().toRotationMatrix();
 }
 
-// No log map of quaternion. It will be automatically converted to rotation matrix
-// @todo maybe implement
+/** Implements log map of a quaternion
+ *
+ * Uses atan2 for the angle, which is accurate near both zero and pi.
+ */
+template <typename ImplType>
+auto evalImpl(expr<LogMap>, const QuaternionRotation<ImplType> &rhs) ->
+  typename traits<QuaternionRotation<ImplType>>::TangentType {
+    using Scalar = scalar_t<QuaternionRotation<ImplType>>;
+    using std::atan2;
+    using std::sqrt;
+    const auto &q = rhs.value();
+    // q and -q are the same rotation. Use the one with w >= 0, so the angle is in [0, pi]
+    const Scalar sign = q.w() < Scalar{0} ? Scalar{-1} : Scalar{1};
+    const Scalar w = sign * q.w();
+    const Eigen::Matrix<Scalar, 3, 1> v = sign * q.vec();
+    const auto n2 = v.squaredNorm();
+
+    if (n2 > Eigen::NumTraits<Scalar>::epsilon()) {
+        const auto n = sqrt(n2);
+        return (Scalar{2} * atan2(n, w) / n) * v;
+    } else {
+        // Very small angle: use Taylor expansion of atan
+        return (Scalar{2} / w * (Scalar{1} - n2 / (Scalar{3} * w * w))) * v;
+    }
+}
+
+template <typename ImplType>
+auto evalCost(expr<LogMap>, const QuaternionRotation<ImplType> &) -> flops<35>;
 
 /** Implements composition of quaternions */
 template <typename Lhs, typename Rhs>
@@ -88,6 +117,11 @@ auto evalImpl(expr<Compose>,
     return plain_eval_t<QuaternionRotation<Lhs>>{lhs.value() * rhs.value()};
 }
 
+template <typename Lhs, typename Rhs>
+auto evalCost(expr<Compose>,
+              const QuaternionRotation<Lhs> &,
+              const QuaternionRotation<Rhs> &) -> flops<28>;
+
 /** Right jacobian of composition with a quaternion on the lhs */
 template <typename Val, typename Lhs, typename Rhs>
 auto rightJacobianImpl(expr<Compose>,
@@ -106,6 +140,10 @@ auto evalImpl(expr<Rotate>,
     return plain_eval_t<Translation<Rhs>>{lhs.value() * rhs.value()};
 }
 
+template <typename Lhs, typename Rhs>
+auto evalCost(expr<Rotate>, const QuaternionRotation<Lhs> &, const Translation<Rhs> &)
+  -> flops<30>;
+
 /** Jacobian of rotation by quaternion, wrt to the vector */
 template <typename Val, typename Lhs, typename Rhs>
 auto rightJacobianImpl(expr<Rotate>,
@@ -128,6 +166,10 @@ auto evalImpl(expr<Convert, QuaternionRotation<ToImpl>>,
     return QuaternionRotation<ToImpl>{rhs.derived().value()};
 }
 
+template <typename ToImpl, typename FromImpl>
+auto evalCost(expr<Convert, QuaternionRotation<ToImpl>>,
+              const QuaternionRotation<FromImpl> &) -> flops<4>;
+
 /** Converts from quaternion to rotation matrix
  */
 template <typename ToImpl, typename FromImpl>
@@ -137,6 +179,10 @@ auto evalImpl(expr<Convert, MatrixRotation<ToImpl>>,
     return MatrixRotation<ToImpl>{rhs.value().toRotationMatrix()};
 }
 
+template <typename ToImpl, typename FromImpl>
+auto evalCost(expr<Convert, MatrixRotation<ToImpl>>, const QuaternionRotation<FromImpl> &)
+  -> flops<25>;
+
 /** Converts from rotation matrix to quaternion
  */
 template <typename ToImpl, typename FromImpl>
@@ -146,6 +192,10 @@ auto evalImpl(expr<Convert, QuaternionRotation<ToImpl>>,
     return QuaternionRotation<ToImpl>{rhs.value()};
 }
 
+template <typename ToImpl, typename FromImpl>
+auto evalCost(expr<Convert, QuaternionRotation<ToImpl>>, const MatrixRotation<FromImpl> &)
+  -> flops<30>;
+
 
 }  // namespace internal
 
@@ -88,6 +88,9 @@ template <typename ImplType>
 struct traits<RelativeRotation<ImplType>>
     : vector_leaf_traits_base<RelativeRotation<ImplType>> {
     using ExpType = MatrixRotation<Eigen::Matrix<typename ImplType::Scalar, 3, 3>>;
+    /** Types the exp map can also evaluate to directly (see ExpMapTo) */
+    using OtherExpTypes =
+      tmp::type_list<QuaternionRotation<Eigen::Quaternion<typename ImplType::Scalar>>>;
 };
 
 /** Implements exp map of a relative rotation into a rotation matrix */
@@ -114,6 +117,37 @@ auto evalImpl(expr<ExpMap>, const RelativeRotation<ImplType> &rhs) {
     }
 }
 
+template <typename ImplType>
+auto evalCost(expr<ExpMap>, const RelativeRotation<ImplType> &) -> flops<40>;
+
+/** Implements exp map of a relative rotation directly into a quaternion */
+template <typename ToImpl, typename ImplType>
+auto evalImpl(expr<ExpMap, QuaternionRotation<ToImpl>>,
+              const RelativeRotation<ImplType> &rhs) -> QuaternionRotation<ToImpl> {
+    using Scalar = typename ImplType::Scalar;
+    using std::cos;
+    using std::sin;
+    using std::sqrt;
+    const auto &r = rhs.value();
+    const auto angle2 = r.squaredNorm();
+    Scalar w;
+    Eigen::Matrix<Scalar, 3, 1> v;
+    if (angle2 > Eigen::NumTraits<Scalar>::epsilon()) {
+        const auto angle = sqrt(angle2);
+        w = cos(Scalar{0.5} * angle);
+        v = sin(Scalar{0.5} * angle) / angle * r;
+    } else {
+        // Small angle: use Taylor expansions
+        w = Scalar{1} - angle2 / Scalar{8};
+        v = (Scalar{0.5} - angle2 / Scalar{48}) * r;
+    }
+    return QuaternionRotation<ToImpl>{Eigen::Quaternion<Scalar>{w, v.x(), v.y(), v.z()}};
+}
+
+template <typename ToImpl, typename ImplType>
+auto evalCost(expr<ExpMap, QuaternionRotation<ToImpl>>, const RelativeRotation<ImplType> &)
+  -> flops<25>;
+
 /** Jacobian of exp map of a relative rotation */
 template <typename Val, typename ImplType>
 auto jacobianImpl(expr<ExpMap>,
@@ -135,6 +169,34 @@ auto jacobianImpl(expr<ExpMap>,
     }
 }
 
+/** Jacobian of exp map of a relative rotation into a quaternion
+ *
+ * The same as for a rotation matrix, written without the matrix of the output.
+ */
+template <typename ToImpl, typename Val, typename ImplType>
+auto jacobianImpl(expr<ExpMap, QuaternionRotation<ToImpl>>,
+                  const QuaternionRotation<Val> &,
+                  const RelativeRotation<ImplType> &rhs)
+  -> jacobian_t<QuaternionRotation<Val>, RelativeRotation<ImplType>> {
+    using Jacobian = jacobian_t<QuaternionRotation<Val>, RelativeRotation<ImplType>>;
+    using Scalar = typename ImplType::Scalar;
+    using std::cos;
+    using std::sin;
+    using std::sqrt;
+    const auto &phi = rhs.value();
+    const auto pcross = crossMatrix(phi);
+    const auto n2 = phi.squaredNorm();
+    // From http://ethaneade.com/lie.pdf, with Taylor expansions for the near-zero case
+    if (n2 > Eigen::NumTraits<Scalar>::epsilon()) {
+        const auto n = sqrt(n2);
+        return Jacobian::Identity() + (Scalar{1} - cos(n)) / n2 * pcross +
+               (n - sin(n)) / (n2 * n) * pcross * pcross;
+    } else {
+        return Jacobian::Identity() + Scalar{0.5} * pcross +
+               Scalar{1} / Scalar{6} * pcross * pcross;
+    }
+}
+
 }  // namespace internal
 
 // Convenience typedefs
@@ -83,50 +83,153 @@ namespace internal {
 template <typename ImplType>
 struct traits<Twist<ImplType>> : vector_leaf_traits_base<Twist<ImplType>> {
     using ExpType = MatrixRigidTransform<Eigen::Matrix<typename ImplType::Scalar, 4, 4>>;
+    /** Types the exp map can also evaluate to directly (see ExpMapTo) */
+    using OtherExpTypes = tmp::type_list<
+      CompactRigidTransform<Eigen::Matrix<typename ImplType::Scalar, 7, 1>>,
+      MatrixRigidTransform<Eigen::Matrix<typename ImplType::Scalar, 3, 4>>>;
 };
 
-/** Implements exp map of a twist into a MatrixRigidTransform
+/** Implements exp map of a twist into a MatrixRigidTransform, with 4x4 or 3x4 storage
  *
- * @todo - evaluate to either
+ * See below for the exp map into a CompactRigidTransform.
  */
-template <typename ImplType>
-auto evalImpl(expr<ExpMap>, const Twist<ImplType> &rhs) ->
-  typename traits<Twist<ImplType>>::ExpType {
+template <typename ToImpl, typename ImplType>
+auto evalImpl(expr<ExpMap, MatrixRigidTransform<ToImpl>>, const Twist<ImplType> &rhs)
+  -> MatrixRigidTransform<ToImpl> {
     using Scalar = typename ImplType::Scalar;
     using Mat3 = Eigen::Matrix<Scalar, 3, 3>;
 
-    // For now, calculate expmap in two parts
-    typename traits<Twist<ImplType>>::ExpType out{};
+    MatrixRigidTransform<ToImpl> out{};
 
     // Equations: see http://ethaneade.com/lie.pdf
-    // @todo optimize
     const auto &omega = rhs.rotation().value();  // the rotation part
+    const auto &u = rhs.translation().value();   // the translation part
     const auto theta2 = omega.squaredNorm();
-    const auto theta = std::sqrt(theta2);
+    Scalar A, B, C;
     if (theta2 > Eigen::NumTraits<Scalar>::epsilon()) {
-        const auto A = std::sin(theta) / theta;
-        const auto B = (Scalar{1.0} - std::cos(theta)) / theta2;
-        const auto C = (Scalar{1.0} - A) / theta2;
-        const Mat3 cross = crossMatrix(omega);
-        const Mat3 cross2 = cross * cross;
-        const Mat3 V = Mat3::Identity() + B * cross + C * cross2;
-        out.translation().value() = V * rhs.translation().value();
-        out.rotation().value() = Mat3::Identity() + A * cross + B * cross2;
+        const auto theta = std::sqrt(theta2);
+        A = std::sin(theta) / theta;
+        B = (Scalar{1.0} - std::cos(theta)) / theta2;
+        C = (Scalar{1.0} - A) / theta2;
     } else {
         // small theta2; use Taylor expansions
-        const auto A = Scalar{1.0};
-        const auto B = Scalar{0.0};
-        const auto C = Scalar{0.0};
-        const Mat3 cross = crossMatrix(omega);
-        const Mat3 cross2 = cross * cross;
-        const Mat3 V = Mat3::Identity() + B * cross + C * cross2;
-        out.translation().value() = V * rhs.translation().value();
-        out.rotation().value() = Mat3::Identity() + A * cross + B * cross2;
+        A = Scalar{1.0} - theta2 / Scalar{6};
+        B = Scalar{0.5} - theta2 / Scalar{24};
+        C = Scalar{1.0} / Scalar{6} - theta2 / Scalar{120};
+    }
+    const Mat3 cross = crossMatrix(omega);
+    const Mat3 cross2 = cross * cross;
+    out.rotation().value() = Mat3::Identity() + A * cross + B * cross2;
+    // Apply V = I + B * cross + C * cross2 to the translation without forming it
+    const Eigen::Matrix<Scalar, 3, 1> omega_u = omega.cross(u);
+    out.translation().value() = u + B * omega_u + C * omega.cross(omega_u);
+
+    return out;
+}
+
+template <typename ToImpl, typename ImplType>
+auto evalCost(expr<ExpMap, MatrixRigidTransform<ToImpl>>, const Twist<ImplType> &)
+  -> flops<110>;
+
+template <typename ImplType>
+auto evalImpl(expr<ExpMap>, const Twist<ImplType> &rhs) ->
+  typename traits<Twist<ImplType>>::ExpType {
+    using ExpType = typename traits<Twist<ImplType>>::ExpType;
+    return evalImpl(expr<ExpMap, ExpType>{}, rhs);
+}
+
+template <typename ImplType>
+auto evalCost(expr<ExpMap>, const Twist<ImplType> &) -> flops<110>;
+
+/** Implements exp map of a twist directly into a CompactRigidTransform
+ *
+ * The sine and cosine of the half angle give both the quaternion and the coefficients of
+ * the V matrix (see http://ethaneade.com/lie.pdf), which is applied to the translation
+ * with two cross products instead of forming any 3x3 matrix.
+ */
+template <typename ToImpl, typename ImplType>
+auto evalImpl(expr<ExpMap, CompactRigidTransform<ToImpl>>, const Twist<ImplType> &rhs)
+  -> CompactRigidTransform<ToImpl> {
+    using Scalar = typename ImplType::Scalar;
+    using Vec3 = Eigen::Matrix<Scalar, 3, 1>;
+    using std::cos;
+    using std::sin;
+    using std::sqrt;
+
+    const auto &omega = rhs.rotation().value();
+    const auto &u = rhs.translation().value();
+    const auto theta2 = omega.squaredNorm();
+    Scalar w, k, B, C;  // quaternion is (w, k * omega)
+    if (theta2 > Eigen::NumTraits<Scalar>::epsilon()) {
+        const auto theta = sqrt(theta2);
+        const auto half_sin = sin(Scalar{0.5} * theta);
+        const auto half_cos = cos(Scalar{0.5} * theta);
+        // sin(theta) = 2 sin(theta/2) cos(theta/2), 1 - cos(theta) = 2 sin^2(theta/2)
+        const auto A = Scalar{2} * half_sin * half_cos / theta;
+        w = half_cos;
+        k = half_sin / theta;
+        B = Scalar{2} * half_sin * half_sin / theta2;
+        C = (Scalar{1} - A) / theta2;
+    } else {
+        // Small angle: use Taylor expansions
+        w = Scalar{1} - theta2 / Scalar{8};
+        k = Scalar{0.5} - theta2 / Scalar{48};
+        B = Scalar{0.5} - theta2 / Scalar{24};
+        C = Scalar{1} / Scalar{6} - theta2 / Scalar{120};
     }
 
+    const Vec3 omega_u = omega.cross(u);
+    CompactRigidTransform<ToImpl> out{};
+    out.value() << k * omega, w, u + B * omega_u + C * omega.cross(omega_u);
     return out;
 }
 
+template <typename ToImpl, typename ImplType>
+auto evalCost(expr<ExpMap, CompactRigidTransform<ToImpl>>, const Twist<ImplType> &)
+  -> flops<50>;
+
+/** Calculates the lower-left block of the Jacobian of the SE(3) exp map
+ *
+ * This is Eade's "B" term (see http://ethaneade.org/exp_diff.pdf), for a twist with
+ * rotation omega and translation u. It is shared by the exp maps into each type.
+ */
+template <typename Omega, typename U>
+auto twistExpJacobianBlock(const Eigen::MatrixBase<Omega> &omega,
+                           const Eigen::MatrixBase<U> &u)
+  -> Eigen::Matrix<typename Omega::Scalar, 3, 3> {
+    using Scalar = typename Omega::Scalar;
+    using Mat3 = Eigen::Matrix<Scalar, 3, 3>;
+    using std::cos;
+    using std::sin;
+    using std::sqrt;
+
+    const auto theta2 = omega.squaredNorm();
+    Scalar b, c, w1, w2, w3;
+    if (theta2 > Eigen::NumTraits<Scalar>::epsilon()) {
+        const auto theta = sqrt(theta2);
+        const auto a = sin(theta) / theta;
+        b = (1 - cos(theta)) / theta2;
+        c = (1 - a) / theta2;
+        w1 = c - b;
+        w2 = (a - 2 * b) / theta2;
+        w3 = (b - 3 * c) / theta2;
+    } else {
+        // Small angle: the limits of the coefficients as theta -> 0
+        b = Scalar{0.5} - theta2 / Scalar{24};
+        c = Scalar{1} / Scalar{6} - theta2 / Scalar{120};
+        w1 = -Scalar{1} / Scalar{3};
+        w2 = -Scalar{1} / Scalar{12};
+        w3 = -Scalar{1} / Scalar{60};
+    }
+    // Calculate Eade's "W" term
+    const Mat3 W =
+      w1 * Mat3::Identity() + w2 * crossMatrix(omega) + w3 * omega * omega.transpose();
+
+    // Calculate Eade's "B" term
+    return b * crossMatrix(u) + c * (omega * u.transpose() + u * omega.transpose()) +
+           omega.dot(u) * W;
+}
+
 /** Jacobian of ExpMap for a twist */
 template <typename Val, typename Rhs>
 auto jacobianImpl(expr<ExpMap>, const TransformBase<Val> &val, const TwistBase<Rhs> &rhs)
@@ -136,32 +239,48 @@ auto jacobianImpl(expr<ExpMap>, const TransformBase<Val> &val, const TwistBase<R
 
     // From http://ethaneade.org/exp_diff.pdf - note we swap order of rotation and
     // translation
-    using std::cos;
-    using std::sin;
     // First get Jacobian of expmap of rotation part only
     const auto &Drot =
       jacobianImpl(expr<ExpMap>{}, val.derived().rotation(), rhs.derived().rotation());
+    const Mat3 B = twistExpJacobianBlock(rhs.derived().rotation().value(),
+                                         rhs.derived().translation().value());
 
-    const auto &omega = rhs.derived().rotation().value();
-    const auto &u = rhs.derived().translation().value();
-    const auto theta2 = omega.squaredNorm();
-    const auto theta = sqrt(theta2);
-    const auto a = sin(theta) / theta;
-    const auto b = (1 - cos(theta)) / theta2;
-    const auto c = (1 - a) / theta2;
-    // Calculate Eade's "W" term
-    const Mat3 W = (c - b) * Mat3::Identity() +
-                   (a - 2 * b) / theta2 * crossMatrix(omega) +
-                   (b - 3 * c) / theta2 * omega * omega.transpose();
+    Eigen::Matrix<Scalar, 6, 6> out{};
+    out.template topLeftCorner<3, 3>() = Drot;
+    out.template bottomLeftCorner<3, 3>() = B;
+    out.template topRightCorner<3, 3>().setZero();
+    out.template bottomRightCorner<3, 3>() = Drot;
+    return out;
+}
 
-    // Calculate Eade's "B" term
-    const Mat3 B = b * crossMatrix(u) +
-                   c * (omega * u.transpose() + u * omega.transpose()) + omega.dot(u) * W;
+/** Jacobian of ExpMap for a twist directly into a MatrixRigidTransform */
+template <typename ToImpl, typename Val, typename ImplType>
+auto jacobianImpl(expr<ExpMap, MatrixRigidTransform<ToImpl>>,
+                  const MatrixRigidTransform<Val> &val,
+                  const Twist<ImplType> &rhs)
+  -> jacobian_t<MatrixRigidTransform<Val>, Twist<ImplType>> {
+    return jacobianImpl(expr<ExpMap>{}, val, rhs);
+}
 
+/** Jacobian of ExpMap for a twist into a CompactRigidTransform
+ *
+ * The same as for a MatrixRigidTransform, with the rotation part taken from the exp map
+ * of a relative rotation into a quaternion.
+ */
+template <typename ToImpl, typename Val, typename ImplType>
+auto jacobianImpl(expr<ExpMap, CompactRigidTransform<ToImpl>>,
+                  const CompactRigidTransform<Val> &val,
+                  const Twist<ImplType> &rhs)
+  -> jacobian_t<CompactRigidTransform<Val>, Twist<ImplType>> {
+    using Scalar = typename ImplType::Scalar;
+    using Quaternion = QuaternionRotation<Eigen::Quaternion<Scalar>>;
 
-    Eigen::Matrix<Scalar, 6, 6> out{};
+    const auto &Drot =
+      jacobianImpl(expr<ExpMap, Quaternion>{}, val.rotation(), rhs.rotation());
+    jacobian_t<CompactRigidTransform<Val>, Twist<ImplType>> out{};
     out.template topLeftCorner<3, 3>() = Drot;
-    out.template bottomLeftCorner<3, 3>() = B;
+    out.template bottomLeftCorner<3, 3>() =
+      twistExpJacobianBlock(rhs.rotation().value(), rhs.translation().value());
     out.template topRightCorner<3, 3>().setZero();
     out.template bottomRightCorner<3, 3>() = Drot;
     return out;
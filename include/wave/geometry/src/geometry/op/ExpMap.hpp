@@ -23,11 +23,87 @@ struct ExpMap
     using Storage::Storage;
 };
 
+/** Expression representing the exponential map evaluated directly to a given type
+ *
+ * It is not created by the user, but by the Prepare step in place of
+ * `Convert<ToDerived, ExpMap<Rhs>>`, when the operand lists ToDerived in its
+ * `OtherExpTypes` (for example, a quaternion for a relative rotation).
+ *
+ * @tparam ToDerived The leaf type to evaluate to
+ * @tparam Rhs The expression in the Lie algebra
+ */
+template <typename ToDerived, typename Rhs>
+struct ExpMapTo : internal::base_tmpl_t<ToDerived, ExpMapTo<ToDerived, Rhs>>,
+                  internal::unary_storage_for<ExpMapTo<ToDerived, Rhs>> {
+ private:
+    using Storage = internal::unary_storage_for<ExpMapTo<ToDerived, Rhs>>;
+
+ public:
+    // Inherit constructors from UnaryStorage
+    using Storage::Storage;
+};
+
 namespace internal {
 
+/** The types, other than ExpType, a leaf's exp map can evaluate to directly */
+template <typename Leaf, typename = void>
+struct other_exp_types {
+    using type = tmp::type_list<>;
+};
+
+template <typename Leaf>
+struct other_exp_types<Leaf, tmp::void_t<typename traits<Leaf>::OtherExpTypes>> {
+    using type = typename traits<Leaf>::OtherExpTypes;
+};
+
+/** Rebinds ExpMapTo for a fixed destination type */
+template <typename ToDerived>
+struct exp_map_to {
+    template <typename Rhs>
+    using rebind = ExpMapTo<ToDerived, Rhs>;
+};
+
+/** The plans evaluating an exp map directly to each of the other exp types of the
+ * operand, as prepared by RhsPlan (see prepared_plans)
+ */
+template <typename RhsPlan,
+          typename ToList = typename other_exp_types<
+            tmp::remove_cr_t<typename RhsPlan::eval_type>>::type>
+struct exp_map_to_plans_for;
+
+template <typename RhsPlan, template <typename...> class List, typename... To>
+struct exp_map_to_plans_for<RhsPlan, List<To...>> {
+    using type = tmp::concat_t<
+      tmp::type_list<>,
+      typename unary_plan<expr<ExpMap, To>, exp_map_to<To>::template rebind, RhsPlan>::
+        type...>;
+};
+
+template <typename RhsPlans>
+struct exp_map_to_plans;
+
+template <typename... RhsPlans>
+struct exp_map_to_plans<tmp::type_list<RhsPlans...>> {
+    using type = typename cheapest_plan_per_eval<
+      tmp::concat_t<tmp::type_list<>,
+                    typename exp_map_to_plans_for<RhsPlans>::type...>>::type;
+};
+
 template <typename Rhs>
 struct traits<ExpMap<Rhs>> : unary_traits_base<ExpMap<Rhs>> {
     using OutputFunctor = WrapWithFrames<LeftFrameOf<Rhs>, LeftFrameOf<Rhs>>;
+
+    /** The usual plans, then plans evaluating straight to the operand's other exp types,
+     * which a parent expression may choose to avoid a conversion */
+    using PreparedPlans = tmp::concat_t<
+      typename unary_traits_base<ExpMap<Rhs>>::PreparedPlans,
+      typename exp_map_to_plans<prepared_plans_t<tmp::remove_cr_t<Rhs>>>::type>;
+};
+
+template <typename ToDerived, typename Rhs>
+struct traits<ExpMapTo<ToDerived, Rhs>>
+    : unary_traits_base_tag<ExpMapTo<ToDerived, Rhs>, expr<ExpMap, ToDerived>> {
+    using OutputFunctor = WrapWithFrames<LeftFrameOf<Rhs>, LeftFrameOf<Rhs>>;
 };
 
 }  // namespace internal
@@ -45,18 +45,20 @@ auto jacobianImpl(expr<LogMap>,
     // From http://ethaneade.org/exp_diff.pdf
     using std::cos;
     using std::sin;
+    using std::sqrt;
     const auto theta2 = phi.squaredNorm();
-    const auto theta = sqrt(theta2);
-    const auto A = sin(theta) / theta;
-    const auto B = (Scalar{1} - cos(theta)) / theta2;
-
-    //        if (theta2 > Eigen::NumTraits<Scalar>::epsilon()) {
-    return Jacobian::Identity() - Scalar{0.5} * crossMatrix(phi) +
-           ((B - Scalar{0.5} * A) / (Scalar{1} - cos(theta))) * crossMatrix(phi) *
-             crossMatrix(phi);
-    //        } else {
-    // @todo small input
-    //        }
+    if (theta2 > Eigen::NumTraits<Scalar>::epsilon()) {
+        const auto theta = sqrt(theta2);
+        const auto A = sin(theta) / theta;
+        const auto B = (Scalar{1} - cos(theta)) / theta2;
+        return Jacobian::Identity() - Scalar{0.5} * crossMatrix(phi) +
+               ((B - Scalar{0.5} * A) / (Scalar{1} - cos(theta))) * crossMatrix(phi) *
+                 crossMatrix(phi);
+    } else {
+        // Small angle: the last coefficient tends to 1/12
+        return Jacobian::Identity() - Scalar{0.5} * crossMatrix(phi) +
+               Scalar{1} / Scalar{12} * crossMatrix(phi) * crossMatrix(phi);
+    }
 }
 
 }  // namespace internal
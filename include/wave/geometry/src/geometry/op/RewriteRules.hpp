@@ -0,0 +1,146 @@
+/**
+ * @file
+ * Rules used by RewriteExpr to simplify geometric expressions before evaluation.
+ */
+
+#ifndef WAVE_GEOMETRY_REWRITERULES_HPP
+#define WAVE_GEOMETRY_REWRITERULES_HPP
+
+namespace wave {
+namespace internal {
+
+/** Returns the result of a rewrite rule, changed to the output type of the node it
+ * replaces.
+ *
+ * A Convert is added if the plain evaluated types differ, and a FrameCast if the frames
+ * differ. The result is returned by reference if it was given by reference.
+ *
+ * @tparam Original the node being replaced
+ */
+template <typename Original,
+          typename Result,
+          std::enable_if_t<std::is_same<plain_output_t<Original>,
+                                        plain_output_t<Result>>{},
+                           int> = 0>
+auto rewriteAs(Result &&result) -> Result {
+    return std::forward<Result>(result);
+}
+
+template <typename Original,
+          typename Result,
+          std::enable_if_t<!std::is_same<plain_eval_t<Original>, plain_eval_t<Result>>{},
+                           int> = 0>
+auto rewriteAs(Result &&result) {
+    using Converted = Convert<plain_eval_t<Original>, rewrite_arg_t<Result>>;
+    return rewriteAs<Original>(Converted{std::forward<Result>(result)});
+}
+
+template <typename Original,
+          typename Result,
+          std::enable_if_t<std::is_same<plain_eval_t<Original>, plain_eval_t<Result>>{} &&
+                             !std::is_same<plain_output_t<Original>,
+                                           plain_output_t<Result>>{} &&
+                             has_two_decorators<Original>{},
+                           int> = 0>
+auto rewriteAs(Result &&result)
+  -> FrameCast<LeftFrameOf<Original>, RightFrameOf<Original>, rewrite_arg_t<Result>> {
+    return FrameCast<LeftFrameOf<Original>,
+                     RightFrameOf<Original>,
+                     rewrite_arg_t<Result>>{std::forward<Result>(result)};
+}
+
+template <typename Original,
+          typename Result,
+          std::enable_if_t<std::is_same<plain_eval_t<Original>, plain_eval_t<Result>>{} &&
+                             !std::is_same<plain_output_t<Original>,
+                                           plain_output_t<Result>>{} &&
+                             has_three_decorators<Original>{},
+                           int> = 0>
+auto rewriteAs(Result &&result) -> FrameCast<LeftFrameOf<Original>,
+                                             MiddleFrameOf<Original>,
+                                             RightFrameOf<Original>,
+                                             rewrite_arg_t<Result>> {
+    return FrameCast<LeftFrameOf<Original>,
+                     MiddleFrameOf<Original>,
+                     RightFrameOf<Original>,
+                     rewrite_arg_t<Result>>{std::forward<Result>(result)};
+}
+
+/** Removes a double inverse: (A^-1)^-1 -> A */
+template <typename Rhs, typename Goal>
+decltype(auto) rewriteImpl(adl, const Inverse<Inverse<Rhs>> &node, Goal) {
+    return rewriteAs<Inverse<Inverse<Rhs>>>(node.rhs().rhs());
+}
+
+/** Folds the inverses of a composition: A^-1 * B^-1 -> (B * A)^-1
+ *
+ * This saves one inverse. It is only done if A and B evaluate to the same type, so no
+ * conversion is added.
+ */
+template <typename Lhs,
+          typename Rhs,
+          typename Goal,
+          std::enable_if_t<std::is_same<plain_eval_t<Lhs>, plain_eval_t<Rhs>>{}, int> = 0>
+auto rewriteImpl(adl, const Compose<Inverse<Lhs>, Inverse<Rhs>> &node, Goal) {
+    using Composed = Compose<rewrite_arg_t<Rhs>, rewrite_arg_t<Lhs>>;
+    return rewriteAs<Compose<Inverse<Lhs>, Inverse<Rhs>>>(
+      Inverse<Composed>{Composed{node.rhs().rhs(), node.lhs().rhs()}});
+}
+
+/** Cancels an exponential map of a logarithmic map: exp(log(A)) -> A */
+template <typename ExtraFrame, typename Rhs, typename Goal>
+decltype(auto) rewriteImpl(adl, const ExpMap<LogMap<ExtraFrame, Rhs>> &node, Goal) {
+    return rewriteAs<ExpMap<LogMap<ExtraFrame, Rhs>>>(node.rhs().rhs());
+}
+
+/** Evaluates a converted exponential map directly to the destination type:
+ * Convert<To, ExpMap<A>> -> ExpMapTo<To, A>
+ *
+ * The rule applies only if the operand lists `To` in its OtherExpTypes. Within a tree,
+ * the Prepare step finds such plans by cost; this rule covers a conversion at the root,
+ * such as when assigning `exp(phi)` to a quaternion.
+ */
+template <
+  typename To,
+  typename Rhs,
+  typename Goal,
+  std::enable_if_t<is_directly_evaluable_unary<expr<ExpMap, To>, eval_t<Rhs>>{}, int> = 0>
+auto rewriteImpl(adl, const Convert<To, ExpMap<Rhs>> &node, Goal) {
+    return rewriteAs<Convert<To, ExpMap<Rhs>>>(
+      ExpMapTo<To, rewrite_arg_t<Rhs>>{node.rhs().rhs()});
+}
+
+/** The rotation of a vector by each operand of a composition, applied right to left */
+template <typename A, typename B, typename Rhs>
+using rotate_each_t =
+  Rotate<rewrite_arg_t<A>, Rotate<rewrite_arg_t<B>, rewrite_arg_t<Rhs>>>;
+
+/** Reassociates rotation of a vector by a composition: (A * B) * v -> A * (B * v)
+ *
+ * The rule applies only if the estimated cost of the prepared result (see evalCost()) is
+ * lower. With rotation matrices, two matrix-vector products are cheaper than one
+ * matrix-matrix and one matrix-vector product. With quaternions, composing first is
+ * cheaper. Since the result is rewritten again, a chain `R1 * R2 * ... * RN * v` of
+ * rotation matrices becomes a sequence of matrix-vector products, applied right to left.
+ *
+ * The rule applies only when the value alone is evaluated. The Jacobians of a chain of
+ * compositions are the partial products already evaluated, while each Rotate in the
+ * reassociated chain multiplies the Jacobian of its rhs by another 3x3 matrix.
+ */
+template <typename A,
+          typename B,
+          typename Rhs,
+          std::enable_if_t<(prepared_cost<rotate_each_t<A, B, Rhs>>{} <
+                            prepared_cost<Rotate<Compose<A, B>, Rhs>>{}),
+                           int> = 0>
+auto rewriteImpl(adl, const Rotate<Compose<A, B>, Rhs> &node, rewrite_for_value) {
+    using Inner = Rotate<rewrite_arg_t<B>, rewrite_arg_t<Rhs>>;
+    using Outer = Rotate<rewrite_arg_t<A>, Inner>;
+    return rewriteAs<Rotate<Compose<A, B>, Rhs>>(
+      Outer{node.lhs().lhs(), Inner{node.lhs().rhs(), node.rhs()}});
+}
+
+}  // namespace internal
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_REWRITERULES_HPP
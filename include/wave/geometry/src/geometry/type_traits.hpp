@@ -63,11 +63,15 @@ TICK_TRAIT(is_transform_leaf, is_leaf_expression<_>) {
 
 // Traits for checking for Eigen expressions
 
+/** Aliases true_type if the T is an Eigen Rows x Cols matrix expression */
+template <int Rows, int Cols, typename T>
+using is_eigen_matrix_of_size =
+  tmp::bool_constant<std::is_base_of<Eigen::MatrixBase<T>, T>::value &&
+                     T::RowsAtCompileTime == Rows && T::ColsAtCompileTime == Cols>;
+
 /** Aliases true_type if the T is an Eigen NxN matrix expression */
 template <int N, typename T>
-using is_eigen_matrix =
-  tmp::bool_constant<std::is_base_of<Eigen::MatrixBase<T>, T>::value &&
-                     T::RowsAtCompileTime == N && T::ColsAtCompileTime == N>;
+using is_eigen_matrix = is_eigen_matrix_of_size<N, N, T>;
 
 /** Aliases true_type if the T is an Eigen quaternion expression */
 template <typename T>
@@ -0,0 +1,154 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_PARALLELEVALUATOR_HPP
+#define WAVE_GEOMETRY_PARALLELEVALUATOR_HPP
+
+namespace wave {
+
+/** Holds the values and reverse-mode Jacobians of many independent expressions
+ *
+ * Element i holds the value of the i-th expression, and a map of leaf address to its
+ * Jacobians, as returned by evaluateWithDynamicReverseJacobians().
+ *
+ * @tparam ValueType the plain output type of the expressions
+ * @tparam Scalar the scalar type of the Jacobians
+ */
+template <typename ValueType, typename Scalar>
+class DynamicBatchJacobians {
+ public:
+    using JacobianMap = internal::DynamicReverseResult<Scalar>;
+
+    /** Constructs an empty batch */
+    DynamicBatchJacobians() = default;
+
+    /** Returns the number of elements */
+    std::size_t size() const noexcept {
+        return this->values.size();
+    }
+
+    /** Resizes storage for n elements */
+    void resize(std::size_t n) {
+        this->values.resize(n);
+        this->jacobian_maps.resize(n);
+    }
+
+    /** Returns the value of element i */
+    ValueType &value(std::size_t i) {
+        return this->values[i];
+    }
+
+    /** Returns the value of element i */
+    const ValueType &value(std::size_t i) const {
+        return this->values[i];
+    }
+
+    /** Returns the map of leaf Jacobians of element i */
+    JacobianMap &jacobians(std::size_t i) {
+        return this->jacobian_maps[i];
+    }
+
+    /** Returns the map of leaf Jacobians of element i */
+    const JacobianMap &jacobians(std::size_t i) const {
+        return this->jacobian_maps[i];
+    }
+
+ private:
+    std::vector<ValueType, Eigen::aligned_allocator<ValueType>> values;
+    std::vector<JacobianMap> jacobian_maps;
+};
+
+namespace internal {
+
+/** The element type of a range of expressions */
+template <typename Range>
+using range_expr_t =
+  tmp::remove_cr_t<decltype(*std::begin(std::declval<const Range &>()))>;
+
+/** The DynamicBatchJacobians type produced by evaluateParallelWithJacobians() */
+template <typename Range>
+using parallel_jacobians_t = DynamicBatchJacobians<plain_output_t<range_expr_t<Range>>,
+                                                   scalar_t<range_expr_t<Range>>>;
+
+/** Writes the value and Jacobians of one Proxy, evaluating its graph in the context */
+template <typename Leaf, typename Out>
+void evaluateParallelElement(EvaluationContext<scalar_t<Leaf>> &context,
+                             const Proxy<Leaf> &proxy,
+                             Out &out,
+                             std::size_t i) {
+    const auto &root = proxy.follow();
+    out.value(i) = prepareLeafForOutput<Proxy<Leaf>>(context.valueOf(root));
+    context.reverseTo(out.jacobians(i), root);
+}
+
+/** Writes the value and Jacobians of one static expression. Any proxies in it are
+ * evaluated in the current context.
+ */
+template <typename Derived, typename Out>
+void evaluateParallelElement(EvaluationContext<scalar_t<Derived>> &,
+                             const ExpressionBase<Derived> &expr,
+                             Out &out,
+                             std::size_t i) {
+    out.value(i) = evaluateWithDynamicReverseJacobiansTo(out.jacobians(i), expr.derived());
+}
+
+}  // namespace internal
+
+/** Evaluates many independent expressions, and their Jacobians, on a thread pool
+ *
+ * Each element of the range is a Proxy, or a static expression which may contain
+ * proxies, and is evaluated as by evaluateWithDynamicReverseJacobians(). Elements may
+ * share Proxy nodes and leaves: each thread evaluates in its own EvaluationContext, which
+ * also holds its scratch storage for adjoints, so the shared nodes are only read.
+ *
+ * Each element is evaluated entirely on one thread and written to its own position in
+ * the output, so the results do not depend on the number of threads or the order in
+ * which elements finish.
+ *
+ * @warning The leaves, and the structure of the graphs, must not change during the call.
+ *
+ * @param out the output, resized if necessary
+ * @param pool the threads to use
+ * @param exprs a random-access range of expressions of the same type
+ */
+template <typename Range>
+void evaluateParallelWithJacobiansTo(internal::parallel_jacobians_t<Range> &out,
+                                     ThreadPool &pool,
+                                     const Range &exprs) {
+    using Scalar = internal::scalar_t<internal::range_expr_t<Range>>;
+    using Context = internal::EvaluationContext<Scalar>;
+    const auto begin = std::begin(exprs);
+    const auto n = static_cast<std::size_t>(std::distance(begin, std::end(exprs)));
+    out.resize(n);
+
+    // One context for each worker, and one for the waiting thread
+    auto contexts = std::vector<std::unique_ptr<Context>>{};
+    for (std::size_t k = 0; k <= pool.size(); ++k) {
+        contexts.emplace_back(new Context{});
+    }
+
+    pool.parallelFor(n, [&](std::size_t i) {
+        auto &context = *contexts[pool.workerIndex()];
+        const typename Context::Scope scope{context};
+        context.clear();
+        internal::evaluateParallelElement(context, begin[i], out, i);
+    });
+}
+
+/** Evaluates many independent expressions, and their Jacobians, on a thread pool
+ *
+ * @see evaluateParallelWithJacobiansTo()
+ * @returns a DynamicBatchJacobians object holding the values and Jacobians
+ */
+template <typename Range>
+auto evaluateParallelWithJacobians(ThreadPool &pool, const Range &exprs)
+  -> internal::parallel_jacobians_t<Range> {
+    internal::parallel_jacobians_t<Range> out;
+    evaluateParallelWithJacobiansTo(out, pool, exprs);
+    return out;
+}
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_PARALLELEVALUATOR_HPP
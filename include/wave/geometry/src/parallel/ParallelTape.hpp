@@ -0,0 +1,342 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_PARALLELTAPE_HPP
+#define WAVE_GEOMETRY_PARALLELTAPE_HPP
+
+namespace wave {
+
+/** A Tape whose independent subtrees are evaluated in parallel on a thread pool
+ *
+ * A Tape runs the nodes of one graph strictly in sequence. For a large graph, such as a
+ * balanced tree of many poses, ParallelTape instead walks the graph from the root, and
+ * forks each subtree of at least a given number of nodes onto the pool as a separate
+ * task. The forward pass runs a node once the tasks of its children are done; the
+ * reverse pass propagates a node's adjoint, then forks its children's subtrees.
+ *
+ *     ThreadPool pool;
+ *     auto tape = compileParallel(pool, proxy);
+ *     for (...) {
+ *         r1.value() = ...;  // Update leaves referenced by the graph
+ *         const auto &value_and_jac = tape.evaluateWithJacobians();
+ *     }
+ *
+ * Only a subtree which is closed, sharing no node with the rest of the graph, is forked.
+ * Its nodes are then written by one task only. Nodes used by several subtrees are run
+ * in sequence by the task which reaches them through all their parents, as in a Tape.
+ *
+ * Leaves may be shared freely. Each thread accumulates leaf Jacobians into a map of its
+ * own, and the maps are summed after the reverse pass. The Jacobians of a leaf
+ * referenced from several forked subtrees may therefore differ between runs in the
+ * last bits, depending on which threads ran the subtrees.
+ *
+ * @warning As for a Tape, the graph must be compiled again if any Proxy in it is
+ * rebound, and its nodes must not be evaluated on other threads while the tape runs.
+ *
+ * @tparam Leaf The leaf type the graph evaluates to
+ */
+template <typename Leaf>
+class ParallelTape {
+    using Scalar = internal::scalar_t<Leaf>;
+    using OutputType = internal::plain_output_t<Proxy<Leaf>>;
+    using JacobianMap = internal::DynamicReverseResult<Scalar>;
+    using Instruction = internal::TapeInstruction<Scalar>;
+    enum : int { TangentSize = internal::traits<Leaf>::TangentSize };
+
+ public:
+    /** Compiles the graph, and decides which of its subtrees to fork
+     *
+     * @param pool the threads to use. It must outlive the tape.
+     * @param proxy the root of the graph
+     * @param threshold the smallest number of nodes in a subtree forked as a task
+     */
+    ParallelTape(ThreadPool &pool,
+                 const Proxy<Leaf> &proxy,
+                 std::size_t threshold = defaultThreshold())
+        : pool{pool},
+          tape{proxy},
+          nodes(tape.size()),
+          scratch(pool.size() + 1, tape.jac_map),
+          used(pool.size() + 1) {
+        this->schedule(std::max<std::size_t>(threshold, 1));
+    }
+
+    /** Evaluates the graph with the current values of its leaves */
+    auto evaluate() -> OutputType {
+        this->forward(this->root());
+        const auto out = this->tape.rootValue();
+        this->tape.unbind();
+        return out;
+    }
+
+    /** Evaluates the graph and its Jacobians with respect to all leaves, in reverse mode
+     *
+     * @return result and map of leaf address to Jacobians, as from a Tape. The map is
+     * owned by the tape, and is overwritten by the next run.
+     */
+    auto evaluateWithJacobians() -> std::pair<OutputType, const JacobianMap &> {
+        this->forward(this->root());
+        const auto out = this->tape.rootValue();
+
+        // The root is the last instruction; its adjoint is the identity
+        auto &tape = this->tape;
+        tape.adjoints.setZero();
+        tape.adjoints.template rightCols<TangentSize>().setIdentity();
+        tape.jac_map.setZero();
+        this->caller = this->pool.workerIndex();
+        std::fill(this->used.begin(), this->used.end(), 0);
+        this->reverse(this->root(), tape.jac_map);
+
+        // Sum the Jacobians accumulated by other threads into the calling thread's map
+        for (std::size_t w = 0; w < this->used.size(); ++w) {
+            if (this->used[w]) {
+                tape.jac_map += this->scratch[w];
+            }
+        }
+        tape.unbind();
+        return {out, tape.jac_map};
+    }
+
+    /** Returns the number of instructions: one for each distinct node in the graph */
+    std::size_t size() const noexcept {
+        return this->tape.size();
+    }
+
+    /** Returns the number of subtrees which are forked as separate tasks */
+    std::size_t numTasks() const noexcept {
+        return std::count_if(this->nodes.begin(),
+                             this->nodes.end(),
+                             [](const Node &node) { return node.forked; });
+    }
+
+    /** Returns the default for the smallest number of nodes in a forked subtree */
+    static std::size_t defaultThreshold() noexcept {
+        return 256;
+    }
+
+ private:
+    /** What the tape knows about each node's subtree: the instructions from its first
+     * up to the node's own
+     */
+    struct Node {
+        /** Index of the first instruction of the subtree */
+        std::size_t first;
+
+        /** Range of the children first reached through this node, in increasing order,
+         * in owned
+         */
+        std::size_t children_begin;
+        std::size_t children_end;
+
+        /** Position of the node's leaf visits in the order expected by the tape's
+         * Jacobian map
+         */
+        std::size_t visits;
+
+        /** Whether the subtree is run as a separate task */
+        bool forked;
+
+        /** Whether any subtree below this node is run as a separate task */
+        bool forks;
+    };
+
+    std::size_t root() const noexcept {
+        return this->nodes.size() - 1;
+    }
+
+    /** Finds the subtree of each node, and which subtrees can be forked
+     *
+     * A node's subtree holds the nodes first reached through it, which TapeBuilder adds
+     * consecutively. The subtree is closed if no edge crosses its boundary, except the
+     * edge from the node's single parent.
+     */
+    void schedule(std::size_t threshold) {
+        const auto &instructions = this->tape.instructions;
+        const auto &edges = this->tape.edges;
+        const auto n = instructions.size();
+
+        // Count the distinct parents of each node, and find the last one
+        constexpr auto none = std::numeric_limits<std::size_t>::max();
+        auto num_parents = std::vector<std::size_t>(n, 0);
+        auto last_parent = std::vector<std::size_t>(n, none);
+        for (std::size_t k = 0; k < n; ++k) {
+            const auto &instruction = instructions[k];
+            for (auto i = instruction.children_begin; i < instruction.children_end; ++i) {
+                const auto c = edges[i];
+                if (last_parent[c] != k) {
+                    last_parent[c] = k;
+                    ++num_parents[c];
+                }
+            }
+        }
+
+        // Over each subtree, the lowest child and highest parent of any of its nodes.
+        // Instructions are in topological order, so each subtree is done before the
+        // parent which contains it.
+        auto lowest_child = std::vector<std::size_t>(n);
+        auto highest_parent = std::vector<std::size_t>(n);
+        this->owned.clear();
+        for (std::size_t k = 0; k < n; ++k) {
+            const auto &instruction = instructions[k];
+            auto &node = this->nodes[k];
+            node.first = instruction.first;
+            lowest_child[k] = k;
+            highest_parent[k] = k;
+            for (auto i = instruction.children_begin; i < instruction.children_end; ++i) {
+                lowest_child[k] = std::min(lowest_child[k], edges[i]);
+            }
+
+            // The subtrees of the children first reached through this node partition
+            // the rest of its subtree. Walk them from the last.
+            node.children_begin = this->owned.size();
+            node.forks = false;
+            for (auto c = k; c > node.first;) {
+                // The child is the last node of its subtree
+                --c;
+                const auto &child = this->nodes[c];
+                this->owned.push_back(c);
+                lowest_child[k] = std::min(lowest_child[k], lowest_child[c]);
+                highest_parent[k] =
+                  std::max({highest_parent[k], highest_parent[c], last_parent[c]});
+                node.forks = node.forks || child.forked || child.forks;
+                c = child.first;
+            }
+            node.children_end = this->owned.size();
+            std::reverse(this->owned.begin() + node.children_begin, this->owned.end());
+
+            const auto closed = lowest_child[k] >= node.first && highest_parent[k] <= k &&
+                                num_parents[k] == 1;
+            node.forked = closed && k + 1 - node.first >= threshold && k + 1 < n;
+        }
+
+        // Tapes expect leaf visits from nodes which don't just wrap a leaf, with the
+        // instructions run backwards. A subtree's visits are consecutive.
+        auto visits = std::size_t{0};
+        for (auto k = n; k-- > 0;) {
+            const auto &instruction = instructions[k];
+            this->nodes[k].visits = visits;
+            if (!instruction.leaf) {
+                visits += instruction.leaves_end - instruction.leaves_begin;
+            }
+        }
+    }
+
+    /** Runs the forward pass of a node's subtree, forking subtrees below it */
+    void forward(std::size_t k) {
+        const auto &node = this->nodes[k];
+        auto &instructions = this->tape.instructions;
+        if (!node.forks) {
+            for (auto j = node.first; j <= k; ++j) {
+                this->tape.run(instructions[j]);
+            }
+            return;
+        }
+
+        // Start the forked children first, then run the rest in topological order
+        ThreadPool::TaskGroup group{this->pool};
+        for (auto i = node.children_begin; i < node.children_end; ++i) {
+            const auto c = this->owned[i];
+            if (this->nodes[c].forked) {
+                group.run([this, c] { this->forward(c); });
+            }
+        }
+        for (auto i = node.children_begin; i < node.children_end; ++i) {
+            const auto c = this->owned[i];
+            if (!this->nodes[c].forked) {
+                this->forward(c);
+            }
+        }
+        group.wait();
+        this->tape.run(instructions[k]);
+    }
+
+    /** Runs the reverse pass of a node's subtree, once the adjoint of the node is
+     * complete, accumulating leaf Jacobians into the given map
+     */
+    void reverse(std::size_t k, JacobianMap &jac_map) {
+        const auto &node = this->nodes[k];
+        jac_map.seekVisits(node.visits);
+        if (!node.forks) {
+            for (auto j = k + 1; j-- > node.first;) {
+                this->reverseStep(this->tape.instructions[j], jac_map);
+            }
+            return;
+        }
+
+        // Propagate this node's adjoint, then its children's, the last first
+        this->reverseStep(this->tape.instructions[k], jac_map);
+        ThreadPool::TaskGroup group{this->pool};
+        for (auto i = node.children_end; i-- > node.children_begin;) {
+            const auto c = this->owned[i];
+            if (this->nodes[c].forked) {
+                group.run([this, c] { this->reverse(c, this->threadMap()); });
+            }
+        }
+        for (auto i = node.children_end; i-- > node.children_begin;) {
+            const auto c = this->owned[i];
+            if (!this->nodes[c].forked) {
+                this->reverse(c, jac_map);
+            }
+        }
+        group.wait();
+    }
+
+    void reverseStep(const Instruction &instruction, JacobianMap &jac_map) {
+        const auto adjoint = this->tape.adjointSlot(instruction);
+        if (instruction.leaf_jacobian) {
+            // The block's position in this thread's map is the same as in the tape's
+            const auto offset = instruction.leaf_jacobian - this->tape.jac_map.data();
+            const auto cols = instruction.tangent_size;
+            using Block = Eigen::Matrix<Scalar, TangentSize, Eigen::Dynamic>;
+            Eigen::Map<Block>{jac_map.data() + offset, TangentSize, cols} +=
+              Eigen::Map<const Block>{adjoint, TangentSize, cols};
+        } else {
+            instruction.reverse(instruction.node, jac_map, adjoint, TangentSize);
+        }
+    }
+
+    /** Returns the Jacobian map of the calling thread, cleared on its first use in a run
+     */
+    JacobianMap &threadMap() {
+        const auto w = this->pool.workerIndex();
+        if (w == this->caller) {
+            return this->tape.jac_map;
+        }
+        if (!this->used[w]) {
+            this->scratch[w].setZero();
+            this->used[w] = 1;
+        }
+        return this->scratch[w];
+    }
+
+    ThreadPool &pool;
+    Tape<Leaf> tape;
+    std::vector<Node> nodes;
+
+    // Children first reached through each node, in the ranges given by each Node
+    std::vector<std::size_t> owned;
+
+    // Jacobian maps of the threads other than the caller, indexed by worker index, and
+    // whether each was used in this run
+    std::vector<JacobianMap> scratch;
+    std::vector<char> used;
+    std::size_t caller = 0;
+};
+
+/** Flattens the graph of a Proxy into a ParallelTape, which can be evaluated repeatedly
+ * on a thread pool
+ *
+ * @see ParallelTape
+ */
+template <typename Leaf>
+auto compileParallel(ThreadPool &pool,
+                     const Proxy<Leaf> &proxy,
+                     std::size_t threshold = ParallelTape<Leaf>::defaultThreshold())
+  -> ParallelTape<Leaf> {
+    return ParallelTape<Leaf>{pool, proxy, threshold};
+}
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_PARALLELTAPE_HPP
@@ -0,0 +1,264 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_THREADPOOL_HPP
+#define WAVE_GEOMETRY_THREADPOOL_HPP
+
+namespace wave {
+
+/** A fixed set of worker threads which run tasks, stealing work from each other
+ *
+ * Each worker has its own queue. A task submitted from a worker goes to the back of that
+ * worker's queue, and the worker takes its next task from the back too, so work split
+ * recursively stays local. A worker with an empty queue steals from the front of another
+ * worker's queue, taking the oldest, and usually largest, pending task.
+ *
+ * Tasks are submitted and waited for through a TaskGroup. A thread waiting for a group
+ * runs pending tasks meanwhile, so tasks may themselves wait for nested groups without
+ * deadlock, and the thread which created the pool also does useful work.
+ *
+ *     ThreadPool pool;
+ *     pool.parallelFor(n, [&](std::size_t i) { results[i] = f(inputs[i]); });
+ */
+class ThreadPool {
+ public:
+    /** Starts the worker threads
+     *
+     * @param num_threads number of workers. With 0, all tasks run on the thread which
+     * waits for them.
+     */
+    explicit ThreadPool(std::size_t num_threads = defaultSize()) {
+        this->queues.reserve(num_threads);
+        for (std::size_t i = 0; i < num_threads; ++i) {
+            this->queues.emplace_back(new Queue{});
+        }
+        this->threads.reserve(num_threads);
+        for (std::size_t i = 0; i < num_threads; ++i) {
+            this->threads.emplace_back([this, i] { this->workerLoop(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /** Stops the workers once their queues are empty, and joins them */
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock{this->sleep_mutex};
+            this->stopping = true;
+        }
+        this->wake.notify_all();
+        for (auto &thread : this->threads) {
+            thread.join();
+        }
+    }
+
+    /** Returns the number of worker threads */
+    std::size_t size() const noexcept {
+        return this->threads.size();
+    }
+
+    /** Returns the index of the calling thread among this pool's workers, or size() if
+     * it is not one of them
+     *
+     * Workers, plus one waiting thread, can use the index to pick per-thread scratch
+     * storage.
+     */
+    std::size_t workerIndex() const noexcept {
+        const auto &worker = currentWorker();
+        return worker.pool == this ? worker.index : this->size();
+    }
+
+    /** A set of tasks which can be waited for together */
+    class TaskGroup {
+     public:
+        explicit TaskGroup(ThreadPool &pool) noexcept : pool{pool} {}
+
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        /** Waits for any tasks still running. Their exceptions are discarded. */
+        ~TaskGroup() {
+            this->help();
+        }
+
+        /** Submits a task to the pool. It may run on any thread. */
+        template <typename F>
+        void run(F &&task) {
+            this->remaining.fetch_add(1);
+            this->pool.push([this, task = std::forward<F>(task)]() mutable {
+                try {
+                    task();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock{this->error_mutex};
+                    if (!this->error) {
+                        this->error = std::current_exception();
+                    }
+                }
+                this->remaining.fetch_sub(1);
+            });
+        }
+
+        /** Runs pending tasks until all tasks of this group are done
+         *
+         * @throws the first exception thrown by a task of this group
+         */
+        void wait() {
+            this->help();
+            if (this->error) {
+                std::rethrow_exception(std::exchange(this->error, nullptr));
+            }
+        }
+
+     private:
+        void help() {
+            while (this->remaining.load() > 0) {
+                if (!this->pool.runOne()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        ThreadPool &pool;
+        std::atomic<std::size_t> remaining{0};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+    /** Calls f(i) for each i in [0, n), in parallel, and waits for all calls
+     *
+     * The range is split into a few chunks per worker, so idle workers can steal some.
+     *
+     * @throws the first exception thrown by f
+     */
+    template <typename F>
+    void parallelFor(std::size_t n, const F &f) {
+        const auto chunks = std::min(n, 4 * (this->size() + 1));
+        TaskGroup group{*this};
+        for (std::size_t c = 0; c < chunks; ++c) {
+            const auto begin = n * c / chunks;
+            const auto end = n * (c + 1) / chunks;
+            group.run([&f, begin, end] {
+                for (auto i = begin; i < end; ++i) {
+                    f(i);
+                }
+            });
+        }
+        group.wait();
+    }
+
+    /** Returns the number of hardware threads, or 1 if unknown */
+    static std::size_t defaultSize() noexcept {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+ private:
+    using Task = std::function<void()>;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /** Identifies the pool and worker index of the calling thread */
+    struct Worker {
+        const ThreadPool *pool = nullptr;
+        std::size_t index = 0;
+    };
+
+    static Worker &currentWorker() noexcept {
+        static thread_local Worker worker;
+        return worker;
+    }
+
+    /** Queues a task on the calling worker, or spreads tasks from other threads */
+    void push(Task task) {
+        if (this->queues.empty()) {
+            // No workers: the waiting thread runs the task itself
+            task();
+            return;
+        }
+        auto index = this->workerIndex();
+        if (index == this->size()) {
+            index = this->next_queue.fetch_add(1) % this->queues.size();
+        }
+        {
+            auto &queue = *this->queues[index];
+            std::lock_guard<std::mutex> lock{queue.mutex};
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            // Counted under the sleep mutex, so a worker about to sleep sees it
+            std::lock_guard<std::mutex> lock{this->sleep_mutex};
+            ++this->queued;
+        }
+        this->wake.notify_one();
+    }
+
+    /** Runs one task: the newest of the calling worker's own, or the oldest of another
+     * queue's
+     *
+     * @return false if no task was found
+     */
+    bool runOne() {
+        const auto own = this->workerIndex();
+        const auto n = this->queues.size();
+        auto task = Task{};
+        for (std::size_t k = 0; k < n && !task; ++k) {
+            // Start with the worker's own queue, then try the others in turn
+            const auto index = (own + k) % n;
+            auto &queue = *this->queues[index];
+            std::lock_guard<std::mutex> lock{queue.mutex};
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            if (index == own) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+        }
+        if (!task) {
+            return false;
+        }
+        this->queued.fetch_sub(1);
+        task();
+        return true;
+    }
+
+    void workerLoop(std::size_t index) {
+        currentWorker() = Worker{this, index};
+        for (;;) {
+            if (this->runOne()) {
+                continue;
+            }
+            // Sleep until a task is pushed or the pool stops, checking again periodically
+            std::unique_lock<std::mutex> lock{this->sleep_mutex};
+            this->wake.wait_for(lock, std::chrono::milliseconds{10}, [this] {
+                return this->stopping || this->queued.load() > 0;
+            });
+            if (this->stopping && this->queued.load() == 0) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+
+    // Number of tasks in all queues, and the means for idle workers to wait for one
+    std::atomic<std::size_t> queued{0};
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    // Queue for the next task pushed from outside the pool
+    std::atomic<std::size_t> next_queue{0};
+};
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_THREADPOOL_HPP
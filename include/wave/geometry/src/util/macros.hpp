@@ -20,6 +20,38 @@
 #define WAVE_STRONG_INLINE inline
 #endif
 
+#ifndef WAVE_GEOMETRY_MAX_TANGENT_SIZE
+/** Largest tangent size of a Jacobian found in forward mode with dynamic dispatch
+ *
+ * Such Jacobians are stored inline up to this size, so they are found without
+ * allocating. To use larger tangent spaces, define this macro before including any
+ * header of the library.
+ */
+#define WAVE_GEOMETRY_MAX_TANGENT_SIZE 6
+#endif
+
+// Values of WAVE_GEOMETRY_AD_MODE
+#define WAVE_GEOMETRY_AD_AUTO 0
+#define WAVE_GEOMETRY_AD_FORWARD 1
+#define WAVE_GEOMETRY_AD_REVERSE 2
+
+#ifndef WAVE_GEOMETRY_AD_MODE
+/** Mode of automatic differentiation used by evalWithJacobians() with targets
+ *
+ * By default (WAVE_GEOMETRY_AD_AUTO), the mode is chosen for each expression from
+ * compile-time estimates of its cost. Defining this macro as WAVE_GEOMETRY_AD_FORWARD or
+ * WAVE_GEOMETRY_AD_REVERSE, before including any header of the library, forces that mode.
+ * Reverse mode is only used where it applies, for trees with unique types.
+ */
+#define WAVE_GEOMETRY_AD_MODE WAVE_GEOMETRY_AD_AUTO
+#endif
+
+#if WAVE_GEOMETRY_AD_MODE != WAVE_GEOMETRY_AD_AUTO &&    \
+  WAVE_GEOMETRY_AD_MODE != WAVE_GEOMETRY_AD_FORWARD && \
+  WAVE_GEOMETRY_AD_MODE != WAVE_GEOMETRY_AD_REVERSE
+#error "WAVE_GEOMETRY_AD_MODE must be WAVE_GEOMETRY_AD_AUTO, _FORWARD or _REVERSE"
+#endif
+
 
 /** We sometimes need to explicitly declare special member functions (copy constructors
  * and operator=) even when they should already be defaulted, to avoid a GCC bug
@@ -41,13 +73,13 @@
   FuncName, ExprName, LhsBase, RhsBase, ...)                                \
     template <__VA_ARGS__>                                                  \
     auto FuncName(LhsBase<L> &&lhs, const RhsBase<R> &rhs) {                \
-        return ExprName<internal::arg_t<L>, R &>{std::move(lhs).derived(),  \
-                                                 rhs.derived()};            \
+        return ExprName<internal::arg_t<L>, internal::arg_t<R &>>{          \
+          std::move(lhs).derived(), rhs.derived()};                         \
     }                                                                       \
     template <__VA_ARGS__>                                                  \
     auto FuncName(const LhsBase<L> &lhs, RhsBase<R> &&rhs) {                \
-        return ExprName<L &, internal::arg_t<R>>{lhs.derived(),             \
-                                                 std::move(rhs).derived()}; \
+        return ExprName<internal::arg_t<L &>, internal::arg_t<R>>{          \
+          lhs.derived(), std::move(rhs).derived()};                         \
     }                                                                       \
     template <__VA_ARGS__>                                                  \
     auto FuncName(LhsBase<L> &&lhs, RhsBase<R> &&rhs) {                     \
@@ -0,0 +1,130 @@
+/**
+ * @file
+ * Defines a structured 6x6 matrix for the adjoint of a rigid transform in SE(3)
+ */
+
+#ifndef WAVE_GEOMETRY_ADJOINTMATRIX_HPP
+#define WAVE_GEOMETRY_ADJOINTMATRIX_HPP
+
+#include <Eigen/Geometry>
+
+namespace wave {
+
+/**
+ * The adjoint of a rigid transform in SE(3), with rotation R and translation t:
+ *
+ * @f[ \text{Ad}_T = \begin{bmatrix} R & 0 \\ t^{\times} R & R \end{bmatrix} @f]
+ *
+ * (with the rotation part of the tangent first). It is the Jacobian of composition with
+ * respect to the rhs, and, negated, of the inverse.
+ *
+ * The dense 6x6 matrix is filled, so an AdjointMatrix can be used as any other Jacobian.
+ * In addition, a fixed-size matrix multiplied by it on the left, such as an adjoint in
+ * reverse mode, uses the block structure: the zero top-right block is skipped, and the
+ * right half of the product needs only one R block. That takes 27 instead of 36
+ * multiplications per row of the other matrix, and gives a plain matrix rather than a
+ * product expression.
+ *
+ * The rotation block need not be a rotation, so the negative of an adjoint keeps the
+ * same structure with -R.
+ *
+ * @tparam Scalar the scalar type
+ */
+template <typename Scalar>
+class AdjointMatrix : public Eigen::Matrix<Scalar, 6, 6> {
+ public:
+    using MatrixType = Eigen::Matrix<Scalar, 6, 6>;
+
+    /** Constructs from the rotation block R and translation t */
+    template <typename RDerived, typename TDerived>
+    AdjointMatrix(const Eigen::MatrixBase<RDerived> &R,
+                  const Eigen::MatrixBase<TDerived> &t) {
+        EIGEN_STATIC_ASSERT_MATRIX_SPECIFIC_SIZE(RDerived, 3, 3);
+        EIGEN_STATIC_ASSERT_VECTOR_SPECIFIC_SIZE(TDerived, 3);
+        this->template topLeftCorner<3, 3>() = R;
+        // The lower-left block, t^x R, is found column by column as cross products
+        for (int i = 0; i < 3; ++i) {
+            this->template block<3, 1>(3, i) = t.cross(this->template block<3, 1>(0, i));
+        }
+        this->template topRightCorner<3, 3>().setZero();
+        this->template bottomRightCorner<3, 3>() = this->template topLeftCorner<3, 3>();
+    }
+
+    /** Returns the rotation block R */
+    auto rotationBlock() const -> Eigen::Block<const MatrixType, 3, 3> {
+        return this->template topLeftCorner<3, 3>();
+    }
+
+    /** Returns the negative adjoint, with the same structure */
+    AdjointMatrix operator-() const {
+        return AdjointMatrix{negate_tag{}, *this};
+    }
+
+ private:
+    struct negate_tag {};
+
+    AdjointMatrix(negate_tag, const AdjointMatrix &other)
+        : MatrixType{-static_cast<const MatrixType &>(other)} {}
+};
+
+// Forward declaration
+template <typename Scalar, int N>
+class IdentityMatrix;
+
+}  // namespace wave
+
+namespace Eigen {
+
+/**
+ * Right-multiply a fixed-size k*6 matrix, such as a reverse-mode adjoint, by an SE(3)
+ * adjoint
+ *
+ * @f[ [W_1 \; W_2] \text{Ad}_T = [W_1 R + W_2 t^{\times} R \;\; W_2 R] @f]
+ */
+template <typename OtherType,
+          typename Scalar,
+          std::enable_if_t<OtherType::ColsAtCompileTime == 6 &&
+                             OtherType::RowsAtCompileTime != Eigen::Dynamic,
+                           int> = 0>
+EIGEN_DEVICE_FUNC inline auto operator*(const Eigen::MatrixBase<OtherType> &lhs,
+                                        const wave::AdjointMatrix<Scalar> &adj)
+  -> Eigen::Matrix<Scalar, OtherType::RowsAtCompileTime, 6> {
+    const auto &w = lhs.derived().eval();
+    const auto &dense = static_cast<const Eigen::Matrix<Scalar, 6, 6> &>(adj);
+
+    Eigen::Matrix<Scalar, OtherType::RowsAtCompileTime, 6> out;
+    out.template leftCols<3>().noalias() = w * dense.template leftCols<3>();
+    out.template rightCols<3>().noalias() = w.template rightCols<3>() * adj.rotationBlock();
+    return out;
+}
+
+/**
+ * Multiply an Identity expression by an SE(3) adjoint
+ * (Provided to break tie between the other specializations)
+ */
+template <typename Scalar>
+EIGEN_DEVICE_FUNC inline const wave::AdjointMatrix<Scalar> &operator*(
+  const wave::IdentityMatrix<Scalar, 6> &, const wave::AdjointMatrix<Scalar> &adj) {
+    return adj;
+}
+
+/**
+ * Multiply an SE(3) adjoint by an Identity expression
+ * (Provided to break tie between the other specializations)
+ */
+template <typename Scalar>
+EIGEN_DEVICE_FUNC inline const wave::AdjointMatrix<Scalar> &operator*(
+  const wave::AdjointMatrix<Scalar> &adj, const wave::IdentityMatrix<Scalar, 6> &) {
+    return adj;
+}
+
+namespace internal {
+
+// Static attributes of our AdjointMatrix: those of the dense 6x6 matrix it extends
+template <typename Scalar>
+struct traits<::wave::AdjointMatrix<Scalar>> : traits<Eigen::Matrix<Scalar, 6, 6>> {};
+
+}  // namespace internal
+}  // namespace Eigen
+
+#endif  // WAVE_GEOMETRY_ADJOINTMATRIX_HPP
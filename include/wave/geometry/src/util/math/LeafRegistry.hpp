@@ -0,0 +1,153 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_LEAFREGISTRY_HPP
+#define WAVE_GEOMETRY_LEAFREGISTRY_HPP
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace wave {
+
+/**
+ * Assigns dense integer IDs, and column ranges, to a set of keys.
+ *
+ * The keys (e.g. leaf addresses) are registered once, at construction, each with a
+ * column width. IDs are assigned in the order of the keys, from 0, and each key's
+ * columns follow those of the key before it. Code which knows a key's ID can then find
+ * its columns by indexing, instead of searching for the key.
+ *
+ * @tparam Key the key type, which must be less-than comparable
+ */
+template <typename Key>
+class LeafRegistry {
+ public:
+    /** A key and its column range */
+    struct Block {
+        Key key;
+        int col_index;
+        int col_width;
+    };
+
+    /** Constructs an empty registry */
+    LeafRegistry() = default;
+
+    /** Registers all keys in a sequence
+     *
+     * @param begin, end a pair of iterators to a sequence of type <Key, int> holding
+     * the {key, column width} for each key, in any order; duplicates allowed.
+     * @param[out] element_ids if not null, filled with the ID of each element of the
+     * sequence, in order, so the caller can skip looking them up.
+     */
+    template <typename It>
+    LeafRegistry(const It &begin,
+                 const It &end,
+                 std::vector<int> *element_ids = nullptr) {
+        const auto n = std::distance(begin, end);
+        this->blocks.reserve(n);
+        if (element_ids) {
+            element_ids->clear();
+            element_ids->reserve(n);
+        }
+
+        const auto by_key = [](const auto &a, const auto &b) {
+            return a.first < b.first;
+        };
+        if (std::is_sorted(begin, end, by_key)) {
+            // Already in key order, as from getLeavesMap(): register in one pass
+            for (auto it = begin; it != end; ++it) {
+                const auto id = this->addSorted(it->first, it->second);
+                if (element_ids) {
+                    element_ids->push_back(id);
+                }
+            }
+            return;
+        }
+
+        // Sort {key, {position, width}}, so each element can be given its key's ID
+        auto order = std::vector<std::pair<Key, std::pair<int, int>>>{};
+        order.reserve(n);
+        for (auto it = begin; it != end; ++it) {
+            const auto position = static_cast<int>(order.size());
+            order.emplace_back(it->first, std::make_pair(position, int{it->second}));
+        }
+        std::sort(order.begin(), order.end());
+        if (element_ids) {
+            element_ids->resize(n);
+        }
+        for (const auto &element : order) {
+            const auto id = this->addSorted(element.first, element.second.second);
+            if (element_ids) {
+                (*element_ids)[element.second.first] = id;
+            }
+        }
+    }
+
+    /** Returns the ID of a key, or -1 if it is not registered */
+    int find(const Key &key) const {
+        const auto by_key = [](const Block &block, const Key &k) {
+            return block.key < k;
+        };
+        const auto it =
+          std::lower_bound(this->blocks.begin(), this->blocks.end(), key, by_key);
+        if (it != this->blocks.end() && it->key == key) {
+            return static_cast<int>(it - this->blocks.begin());
+        }
+        return -1;
+    }
+
+    /** Returns the ID of a key
+     * @throws out_of_range if key is not present
+     */
+    int id(const Key &key) const {
+        const auto id = this->find(key);
+        if (id < 0) {
+            throw std::out_of_range{"LeafRegistry: key not found"};
+        }
+        return id;
+    }
+
+    /** Returns the key with the given ID */
+    const Key &key(int id) const {
+        return this->blocks[id].key;
+    }
+
+    /** Returns the column range of the key with the given ID */
+    const Block &block(int id) const {
+        return this->blocks[id];
+    }
+
+    /** Returns the number of keys */
+    int size() const noexcept {
+        return static_cast<int>(this->blocks.size());
+    }
+
+    /** Returns the total width of all keys' columns */
+    int cols() const noexcept {
+        return this->total_cols;
+    }
+
+ private:
+    /** Registers a key no less than all registered keys, unless it is already the last,
+     * and returns its ID
+     */
+    int addSorted(const Key &key, int width) {
+        if (this->blocks.empty() || this->blocks.back().key != key) {
+            // The first occurrence of a key decides its width
+            this->blocks.push_back({key, this->total_cols, width});
+            this->total_cols += width;
+        }
+        return this->size() - 1;
+    }
+
+    // Blocks of the keys in sorted order, indexed by ID
+    std::vector<Block> blocks;
+    int total_cols = 0;
+};
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_LEAFREGISTRY_HPP
@@ -7,7 +7,7 @@
 #define WAVE_GEOMETRY_MATRIXMAP_HPP
 
 #include <Eigen/Core>
-#include <boost/container/flat_map.hpp>
+#include "LeafRegistry.hpp"
 
 namespace wave {
 
@@ -17,7 +17,8 @@ namespace wave {
  * Stores matrices of size n*m_1, n*m_2, ... n*m_p,  where n and
  * all m_i are known at construct time.
  *
- * Indexing is done through a corresponding set of keys k_1, k_2, ... k_p.
+ * Indexing is done through a corresponding set of keys k_1, k_2, ... k_p, or directly by
+ * the dense integer ID a LeafRegistry assigns to each key.
  *
  * MatrixMap is constructed with a map of keys k_i to widths m_i, and its size cannot not
  * change later. The matrix is initially resized but not initialized (holds garbage).
@@ -27,67 +28,131 @@ namespace wave {
  */
 template <typename Key, typename Scalar>
 class MatrixMap {
-    struct IndexPair {
-        int col_index;
-        int col_width;
-    };
-
-    using IndexMap = boost::container::flat_map<Key, IndexPair>;
-
  public:
+    /** Constructs an empty map */
+    MatrixMap() = default;
+
     /** Constructs and resizes the matrix. (Doesn't initialize. It holds garbage).
      *
      * Variant for dynamic-height MatrixMap.
      *
      * @param begin, end a pair of iterators to a sequence of type <Key, int> holding
-     * the {key, column width} for each matrix. For best performance it should be sorted;
-     * duplicates allowed.
+     * the {key, column width} for each matrix, in any order; duplicates allowed.
+     * @param number of rows
+     */
+    template <typename MapIt>
+    MatrixMap(const MapIt &begin, const MapIt &end, Eigen::Index rows)
+        : MatrixMap{LeafRegistry<Key>{begin, end}, rows} {}
+
+    /** Constructs and resizes the matrix, with a block for each key in the registry.
+     * (Doesn't initialize. It holds garbage).
+     */
+    MatrixMap(LeafRegistry<Key> registry, Eigen::Index rows)
+        : leaf_registry{std::move(registry)}, storage{rows, leaf_registry.cols()} {}
+
+    /** Makes the map hold a block for each key in a sequence, as if constructed from it,
+     * sets all blocks to zero, and expects visits in the order of the sequence.
+     *
+     * If the sequence has the same keys and widths, in the same order, as in the last
+     * call, the registry and storage are kept. Thus reusing a map for the same leaves
+     * neither sorts nor allocates.
+     *
+     * @param begin, end a pair of iterators to a sequence of type <Key, int> holding
+     * the {key, column width} for each matrix, in any order; duplicates allowed.
      * @param number of rows
      */
     template <typename MapIt>
-    MatrixMap(const MapIt &begin, const MapIt &end, Eigen::Index rows) {
-        int col = 0;
-        index_map.reserve(std::distance(begin, end));
-        for (auto it = begin; it != end; ++it) {
-            const auto &key = it->first;
-            const auto &width = it->second;
-            index_map.emplace_hint(index_map.end(), key, IndexPair{col, width});
-            col += width;
+    void assign(const MapIt &begin, const MapIt &end, Eigen::Index rows) {
+        if (!this->isAssigned(begin, end)) {
+            this->leaf_registry = LeafRegistry<Key>{begin, end, &this->element_ids};
         }
-        storage.resize(rows, col);
+        // Does not reallocate if the size is unchanged
+        this->storage.resize(rows, this->leaf_registry.cols());
+        this->storage.setZero();
+        this->expected_visits = this->element_ids;
+        this->next_visit = 0;
     }
 
-    /** Returns a block representing the matrix for the given key */
-    auto operator[](const Key &key) {
-        const auto &v = this->index_map[key];
+    /** Returns the ID of each element of the sequence last given to assign(), in order */
+    const std::vector<int> &elementIds() const noexcept {
+        return this->element_ids;
+    }
+
+    /** Returns a block representing the matrix for the given ID */
+    auto block(int id) {
+        const auto &v = this->leaf_registry.block(id);
         return this->storage.block(0, v.col_index, storage.rows(), v.col_width);
     }
 
-    /** Returns a const block representing the matrix for the given key */
-    auto operator[](const Key &key) const {
-        const auto &v = this->index_map[key];
+    /** Returns a const block representing the matrix for the given ID */
+    auto block(int id) const {
+        const auto &v = this->leaf_registry.block(id);
         return this->storage.block(0, v.col_index, storage.rows(), v.col_width);
     }
 
+    /** Returns a block representing the matrix for the given key
+     *
+     * If the key is not present, the block is empty.
+     */
+    auto operator[](const Key &key) {
+        const auto id = this->leaf_registry.find(key);
+        return id < 0 ? this->storage.block(0, 0, storage.rows(), 0) : this->block(id);
+    }
+
+    /** Returns a const block representing the matrix for the given key
+     *
+     * If the key is not present, the block is empty.
+     */
+    auto operator[](const Key &key) const {
+        const auto id = this->leaf_registry.find(key);
+        return id < 0 ? this->storage.block(0, 0, storage.rows(), 0) : this->block(id);
+    }
+
     /** Returns a block representing the matrix for the given key
      * @throws out_of_range if key is not present
      */
     auto at(const Key &key) {
-        const auto &v = this->index_map.at(key);
-        return this->storage.block(0, v.col_index, storage.rows(), v.col_width);
+        return this->block(this->leaf_registry.id(key));
     }
 
     /** Returns a const block representing the matrix for the given key
      * @throws out_of_range if key is not present
      */
     auto at(const Key &key) const {
-        const auto &v = this->index_map.at(key);
-        return this->storage.block(0, v.col_index, storage.rows(), v.col_width);
+        return this->block(this->leaf_registry.id(key));
     }
 
     /** Returns 1 if the key is present, 0 otherwise */
-    auto count(const Key &key) const {
-        return this->index_map.count(key);
+    std::size_t count(const Key &key) const {
+        return this->leaf_registry.find(key) < 0 ? 0 : 1;
+    }
+
+    /** Returns the height of every block */
+    Eigen::Index rows() const noexcept {
+        return this->storage.rows();
+    }
+
+    /** Returns the registry giving the ID of each key */
+    const LeafRegistry<Key> &registry() const noexcept {
+        return this->leaf_registry;
+    }
+
+    /** Returns the storage of all blocks, contiguous in column-major order */
+    Scalar *data() noexcept {
+        return this->storage.data();
+    }
+
+    /** Returns the storage of all blocks, contiguous in column-major order */
+    const Scalar *data() const noexcept {
+        return this->storage.data();
+    }
+
+    /** Adds the blocks of another map with the same keys and height */
+    MatrixMap &operator+=(const MatrixMap &other) {
+        assert(other.storage.rows() == this->storage.rows());
+        assert(other.storage.cols() == this->storage.cols());
+        this->storage += other.storage;
+        return *this;
     }
 
     /** Set all blocks to zero */
@@ -95,11 +160,72 @@ class MatrixMap {
         this->storage.setZero();
     }
 
+    /** Sets the order in which keys are expected to be passed to visit()
+     *
+     * @param ids key IDs, in the expected order; ID -1 never matches
+     */
+    void expectVisits(std::vector<int> ids) {
+        this->expected_visits = std::move(ids);
+        this->next_visit = 0;
+    }
+
+    /** Restarts the expected order of visits from the beginning */
+    void rewindVisits() noexcept {
+        this->next_visit = 0;
+    }
+
+    /** Moves the expected order of visits to the given position, for a traversal which
+     * starts partway through
+     */
+    void seekVisits(std::size_t position) noexcept {
+        this->next_visit = position;
+    }
+
+    /** Returns the ID of the given key, which is being visited in a traversal
+     *
+     * If the key is the next one in the order given to expectVisits(), its ID is taken
+     * from there, and the order advances. Otherwise, the key is looked up.
+     *
+     * @throws out_of_range if key is not present
+     */
+    int visit(const Key &key) {
+        if (this->next_visit < this->expected_visits.size()) {
+            const auto id = this->expected_visits[this->next_visit];
+            if (id >= 0 && this->leaf_registry.key(id) == key) {
+                ++this->next_visit;
+                return id;
+            }
+        }
+        return this->leaf_registry.id(key);
+    }
 
  private:
+    /** Checks if a sequence matches, element by element, the one last given to assign() */
+    template <typename MapIt>
+    bool isAssigned(const MapIt &begin, const MapIt &end) const {
+        if (std::distance(begin, end) !=
+            static_cast<std::ptrdiff_t>(this->element_ids.size())) {
+            return false;
+        }
+        auto id = this->element_ids.begin();
+        for (auto it = begin; it != end; ++it, ++id) {
+            const auto &block = this->leaf_registry.block(*id);
+            if (block.key != it->first || block.col_width != it->second) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    LeafRegistry<Key> leaf_registry;
     Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> storage;
-    // Map of key -> (column index, column width) index
-    IndexMap index_map;
+
+    // Expected order of visit() calls, and the position of the next
+    std::vector<int> expected_visits;
+    std::size_t next_visit = 0;
+
+    // ID of each element of the sequence last given to assign()
+    std::vector<int> element_ids;
 };
 
 }  // namespace wave
@@ -166,6 +166,18 @@ struct apply_cartesian<C, List<As...>, List<Bs...>> {
                           apply_each_t<C, As, List<Bs...>>...>;
 };
 
+/** Gives the first type in a non-empty type list */
+template <typename List>
+struct front;
+
+template <template <typename...> class List, typename Head, typename... Tail>
+struct front<List<Head, Tail...>> {
+    using type = Head;
+};
+
+template <typename List>
+using front_t = typename front<List>::type;
+
 /** `value` is the first index of Target in a type list, or -1 if not found */
 template <typename List, typename Target, int = 0>
 struct find;
@@ -0,0 +1,123 @@
+#include "wave/geometry/batch.hpp"
+#include "test.hpp"
+
+/** Test operations on structure-of-arrays batches against the same operations on each
+ * element
+ */
+class BatchTest : public testing::Test {
+ protected:
+    // Not a multiple of internal::BatchChunkSize, to test the remainder
+    const int N = 300;
+
+    template <typename Batch>
+    Batch randomBatch() const {
+        Batch batch{N};
+        for (int i = 0; i < N; ++i) {
+            batch.set(i, Batch::ElementType::Random());
+        }
+        return batch;
+    }
+};
+
+TEST_F(BatchTest, setAndGet) {
+    const auto R = wave::RotationMd::Random();
+    const auto q = wave::RotationQd::Random();
+    const auto t = wave::Translationd::Random();
+    const auto T = wave::RigidTransformQd::Random();
+
+    wave::RotationBatchd Rb{N};
+    wave::QuaternionBatchd qb{N};
+    wave::TranslationBatchd tb{N};
+    wave::RigidTransformQBatchd Tb{N};
+    Rb.set(3, R);
+    qb.set(3, q);
+    tb.set(3, t);
+    Tb.set(3, T);
+
+    EXPECT_EQ(N, Rb.size());
+    EXPECT_APPROX(R, Rb.get(3));
+    EXPECT_APPROX(q, qb.get(3));
+    EXPECT_APPROX(t, tb.get(3));
+    EXPECT_APPROX(T, Tb.get(3));
+
+    // A quaternion can be set from a rotation matrix
+    qb.set(4, R);
+    EXPECT_APPROX(R, qb.get(4));
+}
+
+TEST_F(BatchTest, rotationMatrix) {
+    const auto R1 = randomBatch<wave::RotationBatchd>();
+    const auto R2 = randomBatch<wave::RotationBatchd>();
+    const auto t = randomBatch<wave::TranslationBatchd>();
+
+    const wave::RotationBatchd composed = R1 * R2;
+    const wave::RotationBatchd inverted = inverse(R1);
+    const wave::TranslationBatchd rotated = R1 * t;
+
+    for (int i = 0; i < N; ++i) {
+        EXPECT_APPROX(R1.get(i) * R2.get(i), composed.get(i));
+        EXPECT_APPROX(inverse(R1.get(i)), inverted.get(i));
+        EXPECT_APPROX(R1.get(i) * t.get(i), rotated.get(i));
+    }
+}
+
+TEST_F(BatchTest, quaternion) {
+    const auto q1 = randomBatch<wave::QuaternionBatchd>();
+    const auto q2 = randomBatch<wave::QuaternionBatchd>();
+    const auto t = randomBatch<wave::TranslationBatchd>();
+
+    const wave::QuaternionBatchd composed = q1 * q2;
+    const wave::QuaternionBatchd inverted = inverse(q1);
+    const wave::TranslationBatchd rotated = q1 * t;
+
+    for (int i = 0; i < N; ++i) {
+        EXPECT_APPROX(q1.get(i) * q2.get(i), composed.get(i));
+        EXPECT_APPROX(inverse(q1.get(i)), inverted.get(i));
+        EXPECT_APPROX(q1.get(i) * t.get(i), rotated.get(i));
+    }
+}
+
+TEST_F(BatchTest, compactRigidTransform) {
+    const auto T1 = randomBatch<wave::RigidTransformQBatchd>();
+    const auto T2 = randomBatch<wave::RigidTransformQBatchd>();
+    const auto t = randomBatch<wave::TranslationBatchd>();
+
+    const wave::RigidTransformQBatchd composed = T1 * T2;
+    const wave::RigidTransformQBatchd inverted = inverse(T1);
+    const wave::TranslationBatchd transformed = T1 * t;
+
+    for (int i = 0; i < N; ++i) {
+        EXPECT_APPROX(T1.get(i) * T2.get(i), composed.get(i));
+        EXPECT_APPROX(inverse(T1.get(i)), inverted.get(i));
+        EXPECT_APPROX(T1.get(i) * t.get(i), transformed.get(i));
+    }
+}
+
+TEST_F(BatchTest, translationSum) {
+    const auto t1 = randomBatch<wave::TranslationBatchd>();
+    const auto t2 = randomBatch<wave::TranslationBatchd>();
+
+    const wave::TranslationBatchd sum = t1 + t2;
+
+    for (int i = 0; i < N; ++i) {
+        EXPECT_APPROX(t1.get(i) + t2.get(i), sum.get(i));
+    }
+}
+
+TEST_F(BatchTest, chainReusesTemporaries) {
+    const auto R1 = randomBatch<wave::RotationBatchd>();
+    const auto R2 = randomBatch<wave::RotationBatchd>();
+    const auto q1 = randomBatch<wave::QuaternionBatchd>();
+    const auto q2 = randomBatch<wave::QuaternionBatchd>();
+    const auto t = randomBatch<wave::TranslationBatchd>();
+
+    const wave::TranslationBatchd result_m = R1 * R2 * R1 * (R2 * t);
+    const wave::TranslationBatchd result_q = q1 * q2 * q1 * (q2 * t);
+
+    for (int i = 0; i < N; ++i) {
+        EXPECT_APPROX(R1.get(i) * R2.get(i) * R1.get(i) * R2.get(i) * t.get(i),
+                      result_m.get(i));
+        EXPECT_APPROX(q1.get(i) * q2.get(i) * q1.get(i) * q2.get(i) * t.get(i),
+                      result_q.get(i));
+    }
+}
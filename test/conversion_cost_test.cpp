@@ -0,0 +1,87 @@
+#include "wave/geometry/geometry.hpp"
+#include "test.hpp"
+
+/** Test that the prepare step chooses the cheapest conversions for the whole expression
+ * tree, according to the evalCost() estimates, and that values and Jacobians are
+ * unchanged.
+ */
+struct FrameA;
+struct FrameB;
+struct FrameC;
+
+using namespace wave;
+
+template <typename Expr>
+using prepared_t = typename internal::traits<tmp::remove_cr_t<Expr>>::PreparedType;
+
+template <typename Expr>
+using eval_t = internal::eval_t<tmp::remove_cr_t<Expr>>;
+
+template <typename Expr>
+using prepared_cost = internal::prepared_cost<tmp::remove_cr_t<Expr>>;
+
+TEST(ConversionCostTest, noConversionNeeded) {
+    const auto q1 = RotationQFd<FrameA, FrameB>::Random();
+    const auto q2 = RotationQFd<FrameB, FrameC>::Random();
+    const auto &expr = q1 * q2;
+
+    // An expression which can be evaluated as-is is not converted, since no conversion
+    // would be cheaper
+    using Expected =
+      Compose<RotationQFd<FrameA, FrameB> &, RotationQFd<FrameB, FrameC> &> &&;
+    static_assert(std::is_same<Expected, prepared_t<decltype(expr)>>{}, "");
+    EXPECT_APPROX((q1.value() * q2.value()).toRotationMatrix(),
+                  expr.eval().value().toRotationMatrix());
+}
+
+TEST(ConversionCostTest, preparedIsFixedPoint) {
+    const auto a = RotationAd::Random();
+    const auto v = Translationd::Random();
+    const auto &expr = a * v;
+
+    // Preparing an already-prepared expression changes nothing
+    using Prepared = prepared_t<decltype(expr)>;
+    static_assert(std::is_same<Prepared, prepared_t<Prepared>>{}, "");
+    static_assert(prepared_cost<decltype(expr)>{} == prepared_cost<Prepared>{}, "");
+}
+
+TEST(ConversionCostTest, angleAxisRotateViaQuaternion) {
+    const auto a = RotationAd::Random();
+    const auto v = Translationd::Random();
+    const auto &expr = a * v;
+
+    // Converting to a quaternion is cheaper than converting to a matrix
+    using Expected = Rotate<Convert<RotationQd, RotationAd &> &&, Translationd &> &&;
+    static_assert(std::is_same<Expected, prepared_t<decltype(expr)>>{}, "");
+    EXPECT_APPROX(a.value() * v.value(), expr.eval().value());
+    CHECK_JACOBIANS(true, expr, a, v);
+}
+
+TEST(ConversionCostTest, angleAxisComposeViaQuaternion) {
+    const auto a1 = RotationAFd<FrameA, FrameB>::Random();
+    const auto a2 = RotationAFd<FrameB, FrameC>::Random();
+    const auto &expr = a1 * a2;
+
+    static_assert(std::is_same<RotationQd, eval_t<decltype(expr)>>{}, "");
+    EXPECT_APPROX((a1.value() * a2.value()).toRotationMatrix(),
+                  expr.eval().value().toRotationMatrix());
+    CHECK_JACOBIANS(true, expr, a1, a2);
+}
+
+TEST(ConversionCostTest, wholeTreeConvertsOnce) {
+    const auto a1 = RotationAFd<FrameA, FrameB>::Random();
+    const auto a2 = RotationAFd<FrameB, FrameC>::Random();
+    const auto R = RotationMFd<FrameC, FrameA>::Random();
+    const auto &expr = a1 * a2 * R;
+
+    // The angle-axis product is evaluated as a quaternion and converted to a matrix once,
+    // rather than converting each angle-axis to a matrix
+    using Product = prepared_t<decltype(a1 * a2)>;
+    using Expected =
+      Compose<Convert<RotationMd, Product> &&, RotationMFd<FrameC, FrameA> &> &&;
+    static_assert(std::is_same<Expected, prepared_t<decltype(expr)>>{}, "");
+
+    const Eigen::Matrix3d m = (a1.value() * a2.value()).toRotationMatrix() * R.value();
+    EXPECT_APPROX(m, expr.eval().value());
+    CHECK_JACOBIANS(true, expr, a1, a2, R);
+}
@@ -0,0 +1,136 @@
+// This test replaces the global operator new, and makes Eigen check each of its own heap
+// allocations, so it must be its own executable
+namespace {
+void countFailedEigenCheck();
+}  // namespace
+
+#define EIGEN_RUNTIME_NO_MALLOC
+#define eigen_assert(x) (static_cast<bool>(x) ? void() : countFailedEigenCheck())
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "test.hpp"
+#include "wave/geometry/dynamic.hpp"
+#include "wave/geometry/geometry.hpp"
+
+namespace {
+std::atomic<bool> counting{false};
+std::atomic<int> allocations{0};
+
+// Eigen allocates with malloc, bypassing operator new. While allocations are counted,
+// Eigen is told malloc is not allowed, and its check for that fails.
+void countFailedEigenCheck() {
+    if (counting) {
+        ++allocations;
+    }
+}
+
+/** Counts heap allocations made while it is in scope */
+class AllocationCounter {
+ public:
+    AllocationCounter() {
+        allocations = 0;
+        counting = true;
+        Eigen::internal::set_is_malloc_allowed(false);
+    }
+
+    ~AllocationCounter() {
+        Eigen::internal::set_is_malloc_allowed(true);
+        counting = false;
+    }
+
+    int count() const {
+        return allocations;
+    }
+};
+}  // namespace
+
+void *operator new(std::size_t size) {
+    if (counting) {
+        ++allocations;
+    }
+    if (auto *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+// A chain of rotations of a translation, with one rotation used twice
+struct ProxyChain {
+    wave::RotationQd r1 = wave::RotationQd::Random();
+    wave::RotationQd r2 = wave::RotationQd::Random();
+    wave::Translationd t = wave::Translationd::Random();
+    wave::Proxy<wave::RotationQd> shared = makeProxy(r1 * r2);
+    wave::Proxy<wave::Translationd> expr =
+      makeProxy(shared * makeProxy(makeProxy(shared * t) - t));
+};
+}  // namespace
+
+TEST(DynamicAllocationTest, forwardJacobians) {
+    const ProxyChain chain{};
+    const auto expected = chain.expr.evalWithJacobians(chain.r1, chain.r2, chain.t);
+
+    // Warm up, filling the pool of evaluation contexts
+    wave::internal::evaluateWithDynamicJacobians(chain.expr, chain.r1, chain.r2, chain.t);
+
+    const auto counter = AllocationCounter{};
+    for (int i = 0; i < 10; ++i) {
+        const auto result = wave::internal::evaluateWithDynamicJacobians(
+          chain.expr, chain.r1, chain.r2, chain.t);
+        EXPECT_APPROX(std::get<1>(expected), std::get<1>(result));
+        EXPECT_APPROX(std::get<3>(expected), std::get<3>(result));
+    }
+    EXPECT_EQ(0, counter.count());
+}
+
+TEST(DynamicAllocationTest, reverseJacobians) {
+    const ProxyChain chain{};
+    const auto expected = chain.expr.evalWithJacobians(chain.r1, chain.r2, chain.t);
+    auto jac_map = wave::internal::DynamicReverseResult<double>{};
+
+    // Warm up, filling the pool of evaluation contexts and building the map
+    wave::internal::evaluateWithDynamicReverseJacobiansTo(jac_map, chain.expr);
+
+    const auto counter = AllocationCounter{};
+    for (int i = 0; i < 10; ++i) {
+        const auto value =
+          wave::internal::evaluateWithDynamicReverseJacobiansTo(jac_map, chain.expr);
+        EXPECT_APPROX(std::get<0>(expected), value);
+    }
+    EXPECT_EQ(0, counter.count());
+    EXPECT_APPROX(std::get<1>(expected), Eigen::Matrix3d{jac_map.at(&chain.r1)});
+    EXPECT_APPROX(std::get<3>(expected), Eigen::Matrix3d{jac_map.at(&chain.t)});
+}
+
+TEST(DynamicAllocationTest, reverseJacobiansOfStaticExpression) {
+    const ProxyChain chain{};
+    const auto expr = chain.shared * (chain.expr + chain.t);
+    const auto expected = wave::internal::evaluateWithDynamicReverseJacobians(expr);
+    auto jac_map = wave::internal::DynamicReverseResult<double>{};
+
+    // Warm up, filling the pool of evaluation contexts and building the map
+    wave::internal::evaluateWithDynamicReverseJacobiansTo(jac_map, expr);
+
+    const auto counter = AllocationCounter{};
+    for (int i = 0; i < 10; ++i) {
+        wave::internal::evaluateWithDynamicReverseJacobiansTo(jac_map, expr);
+    }
+    EXPECT_EQ(0, counter.count());
+    for (const void *leaf : {static_cast<const void *>(&chain.r1),
+                             static_cast<const void *>(&chain.r2),
+                             static_cast<const void *>(&chain.t)}) {
+        EXPECT_APPROX(Eigen::Matrix3d{expected.second.at(leaf)},
+                      Eigen::Matrix3d{jac_map.at(leaf)});
+    }
+}
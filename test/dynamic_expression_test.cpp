@@ -154,6 +154,224 @@ TYPED_TEST(ProxyTest, constructDeepProxyExpr) {
     CHECK_JACOBIANS(false, expr, t0, rotations[3], rotations[2], rotations[1]);
 }
 
+TYPED_TEST(ProxyTest, compileTape) {
+    auto r1 = TestFixture::LeafAA::Random();
+    auto r2 = TestFixture::LeafAA::Random();
+    auto r3 = TestFixture::LeafAA::Random();
+    auto t = TestFixture::TranslationAAB::Random();
+    const auto p1 = makeProxy(r1 * r2);
+    const auto p2 = makeProxy(inverse(p1) * r3);
+    const auto p3 = makeProxy(p2 * t);
+
+    auto tape = wave::compile(p3);
+    EXPECT_EQ(3u, tape.size());
+
+    // The tape picks up new leaf values on each run
+    for (auto i = 0; i < 3; ++i) {
+        const auto expected = wave::internal::evaluateWithDynamicReverseJacobians(p3);
+        const auto value_and_jac = tape.evaluateWithJacobians();
+        const auto &jac_map = value_and_jac.second;
+
+        EXPECT_APPROX(expected.first, value_and_jac.first);
+        EXPECT_APPROX(expected.first, tape.evaluate());
+        EXPECT_APPROX(p3.jacobian(r1), Eigen::Matrix3d{jac_map.at(&r1)});
+        EXPECT_APPROX(p3.jacobian(r2), Eigen::Matrix3d{jac_map.at(&r2)});
+        EXPECT_APPROX(p3.jacobian(r3), Eigen::Matrix3d{jac_map.at(&r3)});
+        EXPECT_APPROX(p3.jacobian(t), Eigen::Matrix3d{jac_map.at(&t)});
+
+        r1 = TestFixture::LeafAA::Random();
+        r3 = TestFixture::LeafAA::Random();
+        t = TestFixture::TranslationAAB::Random();
+    }
+
+    // The graph is still usable without the tape
+    CHECK_JACOBIANS(false, p3, r1, r2, r3, t);
+}
+
+TYPED_TEST(ProxyTest, compileTapeShared) {
+    const auto r1 = TestFixture::LeafAA::Random();
+    const auto r2 = TestFixture::LeafAA::Random();
+    const auto r3 = TestFixture::LeafAA::Random();
+    const auto shared = makeProxy(r1 * r2);
+    const auto p = makeProxy(shared * r3 * shared);
+
+    // The shared node appears once
+    auto tape = wave::compile(p);
+    EXPECT_EQ(2u, tape.size());
+
+    const auto value_and_jac = tape.evaluateWithJacobians();
+    const auto &jac_map = value_and_jac.second;
+    EXPECT_APPROX(p.eval(), value_and_jac.first);
+    EXPECT_APPROX(p.jacobian(r1), Eigen::Matrix3d{jac_map.at(&r1)});
+    EXPECT_APPROX(p.jacobian(r2), Eigen::Matrix3d{jac_map.at(&r2)});
+    EXPECT_APPROX(p.jacobian(r3), Eigen::Matrix3d{jac_map.at(&r3)});
+}
+
+TYPED_TEST(ProxyTest, sharedNodes) {
+    const auto r = TestFixture::LeafAA::Random();
+    const auto t = TestFixture::TranslationAAB::Random();
+
+    // Each node uses the one below it twice
+    auto shared = makeProxy(r * r);
+    for (auto i = 0; i < 2; ++i) {
+        shared = makeProxy(shared * shared);
+    }
+    const auto p = makeProxy(shared * t);
+    CHECK_JACOBIANS(false, p, r, t);
+
+    const auto value_and_jac = wave::internal::evaluateWithDynamicReverseJacobians(p);
+    const auto &jac_map = value_and_jac.second;
+    EXPECT_APPROX(p.eval(), value_and_jac.first);
+    EXPECT_APPROX(p.jacobian(r), Eigen::Matrix3d{jac_map.at(&r)});
+    EXPECT_APPROX(p.jacobian(t), Eigen::Matrix3d{jac_map.at(&t)});
+
+    // Each node is visited once per pass: visiting each use would take 2^30 steps
+    for (auto i = 0; i < 30; ++i) {
+        shared = makeProxy(inverse(shared) * shared);
+    }
+    const auto deep = makeProxy(shared * t);
+    EXPECT_APPROX(t, deep.eval());
+    const auto deep_jac = wave::internal::evaluateWithDynamicReverseJacobians(deep);
+    EXPECT_APPROX(t, deep_jac.first);
+    EXPECT_TRUE(deep_jac.second.at(&r).allFinite());
+}
+
+namespace {
+// Propagates an adjoint of several stacked rows through a Proxy, and checks the result
+// against that of the Proxy's own reverse-mode Jacobians
+template <int Rows, typename Leaf, typename... Targets>
+void checkStackedAdjoint(const wave::Proxy<Leaf> &p, const Targets &... targets) {
+    enum : int { TangentSize = wave::internal::traits<Leaf>::TangentSize };
+    using Adjoint = Eigen::Matrix<double, Rows, TangentSize>;
+    const auto leaves = wave::internal::getLeavesMap(p);
+    auto jac_map =
+      wave::MatrixMap<const void *, double>{leaves.begin(), leaves.end(), Rows};
+    jac_map.setZero();
+    const Adjoint adjoint = Adjoint::Random();
+    const wave::internal::Evaluator<wave::Proxy<Leaf>> v_eval{p};
+    wave::internal::evaluateDynamicReverseJacobiansImpl(jac_map, v_eval, adjoint);
+
+    const auto expected = wave::internal::evaluateWithDynamicReverseJacobians(p);
+    for (const void *target : {static_cast<const void *>(&targets)...}) {
+        using Jacobian = Eigen::Matrix<double, Rows, Eigen::Dynamic>;
+        EXPECT_APPROX(Jacobian{adjoint * expected.second.at(target)},
+                      Jacobian{jac_map.at(target)});
+    }
+}
+}  // namespace
+
+TYPED_TEST(ProxyTest, stackedAdjoint) {
+    const auto r1 = TestFixture::LeafAA::Random();
+    const auto r2 = TestFixture::LeafAA::Random();
+    const auto t = TestFixture::TranslationAAB::Random();
+    const auto shared = makeProxy(r1 * r2);
+    const auto p = makeProxy(shared * makeProxy(shared * t));
+
+    // Heights in WAVE_GEOMETRY_REVERSE_ROWS are propagated as fixed-size matrices, and
+    // others as dynamic-size matrices
+    checkStackedAdjoint<3>(p, r1, r2, t);
+    checkStackedAdjoint<9>(p, r1, r2, t);
+    checkStackedAdjoint<15>(p, r1, r2, t);
+    checkStackedAdjoint<5>(p, r1, r2, t);
+}
+
+TYPED_TEST(ProxyTest, adjointJacobians) {
+    const auto r1 = TestFixture::LeafAA::Random();
+    const auto r2 = TestFixture::LeafAA::Random();
+    const auto t = TestFixture::TranslationAAB::Random();
+    const auto shared = makeProxy(r1 * r2);
+    const auto p = makeProxy(shared * makeProxy(shared * t));
+    const auto expected = wave::internal::evaluateWithDynamicReverseJacobians(p);
+
+    // Seeding the reverse pass with an adjoint gives its products with the Jacobians,
+    // for Proxy roots and for static expressions holding proxies
+    const Eigen::Matrix<double, 2, 3> w = Eigen::Matrix<double, 2, 3>::Random();
+    const auto weighted = wave::internal::evaluateWithDynamicReverseJacobians(p, w);
+    const auto weighted_static =
+      wave::internal::evaluateWithDynamicReverseJacobians(shared * p, w);
+    const auto expected_static =
+      wave::internal::evaluateWithDynamicReverseJacobians(shared * p);
+    EXPECT_APPROX(expected.first, weighted.first);
+    for (const void *leaf : {static_cast<const void *>(&r1),
+                             static_cast<const void *>(&r2),
+                             static_cast<const void *>(&t)}) {
+        using Jacobian = Eigen::Matrix<double, 2, 3>;
+        EXPECT_APPROX(Jacobian{w * expected.second.at(leaf)},
+                      Jacobian{weighted.second.at(leaf)});
+        EXPECT_APPROX(Jacobian{w * expected_static.second.at(leaf)},
+                      Jacobian{weighted_static.second.at(leaf)});
+    }
+}
+
+TYPED_TEST(ProxyTest, updateTape) {
+    auto r1 = TestFixture::LeafAA::Random();
+    auto r2 = TestFixture::LeafAA::Random();
+    auto r3 = TestFixture::LeafAA::Random();
+    auto t = TestFixture::TranslationAAB::Random();
+    const auto p1 = makeProxy(r1 * r2);
+    const auto p2 = makeProxy(r3 * t);
+    const auto p3 = makeProxy(p1 * p2);
+
+    auto tape = wave::compile(p3);
+    EXPECT_APPROX(p3.eval(), tape.update());
+
+    // Only the path from a marked leaf to the root is evaluated again
+    for (auto i = 0; i < 3; ++i) {
+        r3 = TestFixture::LeafAA::Random();
+        tape.markChanged(r3);
+
+        // Run the tape first, since evaluating p3 directly would refresh every node
+        const auto value_and_jac = tape.updateWithJacobians();
+        const auto &jac_map = value_and_jac.second;
+        const auto expected = wave::internal::evaluateWithDynamicReverseJacobians(p3);
+
+        EXPECT_APPROX(expected.first, value_and_jac.first);
+        EXPECT_APPROX(p3.jacobian(r1), Eigen::Matrix3d{jac_map.at(&r1)});
+        EXPECT_APPROX(p3.jacobian(r2), Eigen::Matrix3d{jac_map.at(&r2)});
+        EXPECT_APPROX(p3.jacobian(r3), Eigen::Matrix3d{jac_map.at(&r3)});
+        EXPECT_APPROX(p3.jacobian(t), Eigen::Matrix3d{jac_map.at(&t)});
+    }
+
+    // An unmarked change is not noticed by update(), but is by evaluate()
+    const auto before = tape.update();
+    r1 = TestFixture::LeafAA::Random();
+    EXPECT_APPROX(before, tape.update());
+    EXPECT_APPROX(p3.eval(), tape.evaluate());
+    EXPECT_APPROX(p3.eval(), tape.update());
+}
+
+TYPED_TEST(ProxyTest, arenaProxy) {
+    const auto r1 = TestFixture::LeafAA::Random();
+    const auto r2 = TestFixture::LeafAA::Random();
+    const auto t = TestFixture::TranslationAAB::Random();
+    const auto heap = makeProxy(makeProxy(r1 * r2) * t);
+
+    wave::ProxyArena arena{128};
+    {
+        const auto r = makeProxy(arena, r1 * r2);
+        const auto p = makeProxy(arena, r * t);
+        EXPECT_EQ(2u, arena.size());
+        EXPECT_APPROX(heap.eval(), p.eval());
+        CHECK_JACOBIANS(false, p, r1, r2, t);
+
+        // Arena nodes can be shared and compiled like any other
+        const auto shared = makeProxy(arena, r * p);
+        auto tape = wave::compile(shared);
+        EXPECT_EQ(3u, tape.size());
+        EXPECT_APPROX(shared.eval(), tape.evaluate());
+    }
+
+    // Clearing destroys all nodes, and the arena can be reused
+    arena.clear();
+    EXPECT_EQ(0u, arena.size());
+    auto p = makeProxy(arena, r1 * t);
+    for (auto i = 0; i < 10; ++i) {
+        p = makeProxy(arena, makeProxy(arena, r1 * r2) * p);
+    }
+    EXPECT_EQ(21u, arena.size());
+    CHECK_JACOBIANS(false, p, r1, r2, t);
+}
+
 TYPED_TEST(RefProxyTest, assign) {
     const auto q1 = TestFixture::TranslationAAB::Random();
     const auto q2 = TestFixture::TranslationAAB::Random();
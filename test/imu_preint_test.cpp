@@ -18,6 +18,79 @@ TEST(Imu, exprJacobians) {
     CHECK_JACOBIANS(true, expr, delta_R_ij, wg, R_i, R_j);
 }
 
+TEST(Imu, jacobianModeSelection) {
+    const auto delta_R_ij = RotationMFd<FrameI, FrameJ>::Random();
+    const auto wg = RelativeRotationFd<FrameJ, FrameJ, FrameJ>::Random();
+    const auto R_i = RotationMFd<FrameW, FrameI>::Random();
+    const auto R_j = RotationMFd<FrameW, FrameJ>::Random();
+    const auto expr = log(inverse(delta_R_ij * exp(wg)) * inverse(R_i) * R_j);
+    using Expr = std::decay_t<decltype(expr)>;
+    using wave::internal::JacobianMode;
+    using wave::internal::select_jacobian_mode;
+
+    // One target near the root: forward mode only visits the path to it
+    EXPECT_EQ(JacobianMode::Forward,
+              (select_jacobian_mode<Expr, std::decay_t<decltype(R_j)>>::value));
+    // All leaves: reverse mode visits each node once, for a 3-dimensional output
+    EXPECT_EQ(JacobianMode::Reverse,
+              (select_jacobian_mode<Expr,
+                                    std::decay_t<decltype(delta_R_ij)>,
+                                    std::decay_t<decltype(wg)>,
+                                    std::decay_t<decltype(R_i)>,
+                                    std::decay_t<decltype(R_j)>>::value));
+
+    // Every mode gives the same value and Jacobians
+    using wave::internal::evaluateWithJacobiansInMode;
+    const auto forward_all = evaluateWithJacobiansInMode<JacobianMode::Forward>(
+      expr, delta_R_ij, wg, R_i, R_j);
+    const auto typed_all =
+      evaluateWithJacobiansInMode<JacobianMode::Typed>(expr, delta_R_ij, wg, R_i, R_j);
+    const auto reverse_all = evaluateWithJacobiansInMode<JacobianMode::Reverse>(
+      expr, delta_R_ij, wg, R_i, R_j);
+    const auto auto_all = expr.evalWithJacobians(delta_R_ij, wg, R_i, R_j);
+    EXPECT_APPROX(std::get<0>(forward_all), std::get<0>(typed_all));
+    EXPECT_APPROX(std::get<0>(forward_all), std::get<0>(reverse_all));
+    EXPECT_APPROX(std::get<0>(forward_all), std::get<0>(auto_all));
+    EXPECT_APPROX(std::get<1>(forward_all), std::get<1>(typed_all));
+    EXPECT_APPROX(std::get<1>(forward_all), std::get<1>(reverse_all));
+    EXPECT_APPROX(std::get<1>(forward_all), std::get<1>(auto_all));
+    EXPECT_APPROX(std::get<2>(forward_all), std::get<2>(typed_all));
+    EXPECT_APPROX(std::get<2>(forward_all), std::get<2>(reverse_all));
+    EXPECT_APPROX(std::get<2>(forward_all), std::get<2>(auto_all));
+    EXPECT_APPROX(std::get<3>(forward_all), std::get<3>(typed_all));
+    EXPECT_APPROX(std::get<3>(forward_all), std::get<3>(reverse_all));
+    EXPECT_APPROX(std::get<3>(forward_all), std::get<3>(auto_all));
+    EXPECT_APPROX(std::get<4>(forward_all), std::get<4>(typed_all));
+    EXPECT_APPROX(std::get<4>(forward_all), std::get<4>(reverse_all));
+    EXPECT_APPROX(std::get<4>(forward_all), std::get<4>(auto_all));
+
+    const auto forward_one = evaluateWithJacobiansInMode<JacobianMode::Forward>(expr, R_j);
+    const auto typed_one = evaluateWithJacobiansInMode<JacobianMode::Typed>(expr, R_j);
+    const auto reverse_one = evaluateWithJacobiansInMode<JacobianMode::Reverse>(expr, R_j);
+    EXPECT_APPROX(std::get<0>(forward_one), std::get<0>(typed_one));
+    EXPECT_APPROX(std::get<0>(forward_one), std::get<0>(reverse_one));
+    EXPECT_APPROX(std::get<1>(forward_one), std::get<1>(typed_one));
+    EXPECT_APPROX(std::get<1>(forward_one), std::get<1>(reverse_one));
+
+    // A subexpression target is matched by structure, which the typed evaluator does at
+    // compile time
+    const auto sub = exp(wg);
+    EXPECT_EQ(JacobianMode::Typed,
+              (select_jacobian_mode<Expr, std::decay_t<decltype(sub)>>::value));
+    const auto forward_sub = evaluateWithJacobiansInMode<JacobianMode::Forward>(expr, sub);
+    const auto auto_sub = expr.evalWithJacobians(sub);
+    EXPECT_APPROX(std::get<1>(forward_sub), std::get<1>(auto_sub));
+
+    // In reverse mode, a target of a leaf's type which is not in the expression has a
+    // zero Jacobian
+    const auto other_R_j = RotationMFd<FrameW, FrameJ>::Random();
+    const auto result =
+      wave::internal::evaluateWithJacobiansInMode<JacobianMode::Reverse>(
+        expr, R_j, other_R_j);
+    EXPECT_APPROX(std::get<1>(expr.evalWithJacobians(R_j)), std::get<1>(result));
+    EXPECT_TRUE(std::get<2>(result).isZero());
+}
+
 Eigen::Matrix3d expMap(const Eigen::Vector3d &phi) {
     return evalImpl(wave::internal::expr<ExpMap>{}, wave::RelativeRotationd{phi}).value();
 }
@@ -91,3 +164,62 @@ TEST(Imu, compareToHand) {
     EXPECT_APPROX(J_phi_i, res3);
     EXPECT_APPROX(J_phi_j, res4);
 }
+
+TEST(Imu, batchJacobians) {
+    const int N = 5;
+    std::vector<RotationMFd<FrameI, FrameJ>> delta_R_ij;
+    std::vector<RelativeRotationFd<FrameJ, FrameJ, FrameJ>> wg;
+    std::vector<RotationMFd<FrameW, FrameI>> R_i;
+    std::vector<RotationMFd<FrameW, FrameJ>> R_j;
+    for (int i = 0; i < N; ++i) {
+        delta_R_ij.push_back(RotationMFd<FrameI, FrameJ>::Random());
+        wg.push_back(RelativeRotationFd<FrameJ, FrameJ, FrameJ>::Random());
+        R_i.push_back(RotationMFd<FrameW, FrameI>::Random());
+        R_j.push_back(RotationMFd<FrameW, FrameJ>::Random());
+    }
+
+    const auto factory = [](const auto &delta_R_ij,
+                            const auto &wg,
+                            const auto &R_i,
+                            const auto &R_j) {
+        return log(inverse(delta_R_ij * exp(wg)) * inverse(R_i) * R_j);
+    };
+    const auto result = evaluateBatchWithJacobians(factory, delta_R_ij, wg, R_i, R_j);
+
+    ASSERT_EQ(N, result.size());
+    for (int i = 0; i < N; ++i) {
+        const auto &expr = factory(delta_R_ij[i], wg[i], R_i[i], R_j[i]);
+        wave::RelativeRotationFd<FrameJ, FrameJ, FrameJ> res;
+        Eigen::Matrix3d res1, res2, res3, res4;
+        std::tie(res, res1, res2, res3, res4) =
+          expr.evalWithJacobians(delta_R_ij[i], wg[i], R_i[i], R_j[i]);
+
+        EXPECT_APPROX(res, result.value(i));
+        EXPECT_APPROX(res1, result.jacobian<0>(i));
+        EXPECT_APPROX(res2, result.jacobian<1>(i));
+        EXPECT_APPROX(res3, result.jacobian<2>(i));
+        EXPECT_APPROX(res4, result.jacobian<3>(i));
+    }
+
+    // Arguments not in leaf order use forward mode
+    const auto factory_flipped = [](const auto &R_j, const auto &R_i) {
+        return log(inverse(R_i) * R_j);
+    };
+    const auto result_flipped = evaluateBatchWithJacobians(factory_flipped, R_j, R_i);
+    for (int i = 0; i < N; ++i) {
+        Eigen::Matrix3d J_i, J_j;
+        std::tie(std::ignore, J_j, J_i) =
+          log(inverse(R_i[i]) * R_j[i]).evalWithJacobians(R_j[i], R_i[i]);
+        EXPECT_APPROX(J_j, result_flipped.jacobian<0>(i));
+        EXPECT_APPROX(J_i, result_flipped.jacobian<1>(i));
+    }
+
+    // Expression with repeated leaf types uses the untyped evaluator
+    const auto factory2 = [](const auto &R_i, const auto &R_j) {
+        return log(inverse(R_j) * R_i * inverse(R_i) * R_j);
+    };
+    const auto result2 = evaluateBatchWithJacobians(factory2, R_j, R_j);
+    for (int i = 0; i < N; ++i) {
+        EXPECT_PRED1(IsZero, result2.value(i).value());
+    }
+}
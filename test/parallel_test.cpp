@@ -0,0 +1,228 @@
+#include "wave/geometry/geometry.hpp"
+#include "wave/geometry/parallel.hpp"
+#include "test.hpp"
+
+TEST(ThreadPoolTest, parallelForVisitsEachIndexOnce) {
+    for (const auto threads : {0u, 1u, 4u}) {
+        wave::ThreadPool pool{threads};
+        auto counts = std::vector<std::atomic<int>>(1000);
+        pool.parallelFor(counts.size(), [&](std::size_t i) { ++counts[i]; });
+        for (const auto &count : counts) {
+            EXPECT_EQ(1, count.load());
+        }
+    }
+}
+
+TEST(ThreadPoolTest, nestedGroups) {
+    wave::ThreadPool pool{4};
+    std::atomic<int> total{0};
+    // Tasks wait for groups of their own; waiting threads run pending tasks meanwhile
+    pool.parallelFor(8, [&](std::size_t) {
+        wave::ThreadPool::TaskGroup group{pool};
+        for (int k = 0; k < 8; ++k) {
+            group.run([&] { ++total; });
+        }
+        group.wait();
+    });
+    EXPECT_EQ(64, total.load());
+}
+
+TEST(ThreadPoolTest, rethrowsTaskException) {
+    wave::ThreadPool pool{2};
+    EXPECT_THROW(pool.parallelFor(100,
+                                  [](std::size_t i) {
+                                      if (i == 42) {
+                                          throw std::runtime_error{"task failed"};
+                                      }
+                                  }),
+                 std::runtime_error);
+}
+
+namespace {
+using RotationVector =
+  std::vector<wave::RotationMd, Eigen::aligned_allocator<wave::RotationMd>>;
+}
+
+TEST(ParallelEvaluatorTest, proxiesSharingNodes) {
+    // Many residuals sharing pose nodes, as in a factor graph
+    const auto offset = wave::RotationMd::Random();
+    auto poses = RotationVector(20);
+    auto pose_proxies = std::vector<wave::Proxy<wave::RotationMd>>{};
+    for (auto &pose : poses) {
+        pose = wave::RotationMd::Random();
+        pose_proxies.push_back(makeProxy(pose * offset));
+    }
+    const auto t = wave::Translationd::Random();
+    auto residuals = std::vector<wave::Proxy<wave::Translationd>>{};
+    for (std::size_t i = 0; i < 500; ++i) {
+        const auto &a = pose_proxies[i % poses.size()];
+        const auto &b = pose_proxies[(i * 7 + 3) % poses.size()];
+        const auto relative = makeProxy(inverse(a) * b);
+        residuals.push_back(makeProxy(relative * (relative * t)));
+    }
+
+    wave::ThreadPool pool{4};
+    const auto out = wave::evaluateParallelWithJacobians(pool, residuals);
+    ASSERT_EQ(residuals.size(), out.size());
+    for (std::size_t i = 0; i < residuals.size(); ++i) {
+        const auto expected = wave::internal::evaluateWithDynamicReverseJacobians(
+          residuals[i]);
+        EXPECT_APPROX(expected.first, out.value(i));
+        for (const auto &pose : {&poses[i % poses.size()], &poses[(i * 7 + 3) % 20]}) {
+            EXPECT_APPROX(Eigen::Matrix3d{expected.second.at(pose)},
+                          Eigen::Matrix3d{out.jacobians(i).at(pose)});
+        }
+        EXPECT_APPROX(Eigen::Matrix3d{expected.second.at(&t)},
+                      Eigen::Matrix3d{out.jacobians(i).at(&t)});
+        EXPECT_APPROX(Eigen::Matrix3d{expected.second.at(&offset)},
+                      Eigen::Matrix3d{out.jacobians(i).at(&offset)});
+    }
+}
+
+TEST(ParallelEvaluatorTest, staticExpressions) {
+    const auto t = wave::Translationd::Random();
+    const auto shared =
+      makeProxy(wave::RotationMd::Random() * wave::RotationMd::Random());
+    auto rotations = RotationVector(200);
+    using Expr = decltype(rotations[0] * (shared * t));
+    auto exprs = std::vector<Expr>{};
+    for (auto &r : rotations) {
+        r = wave::RotationMd::Random();
+        exprs.push_back(r * (shared * t));
+    }
+
+    wave::ThreadPool pool{3};
+    const auto out = wave::evaluateParallelWithJacobians(pool, exprs);
+    ASSERT_EQ(exprs.size(), out.size());
+    for (std::size_t i = 0; i < exprs.size(); ++i) {
+        const auto expected =
+          wave::internal::evaluateWithDynamicReverseJacobians(exprs[i]);
+        EXPECT_APPROX(expected.first, out.value(i));
+        EXPECT_APPROX(Eigen::Matrix3d{expected.second.at(&rotations[i])},
+                      Eigen::Matrix3d{out.jacobians(i).at(&rotations[i])});
+        EXPECT_APPROX(Eigen::Matrix3d{expected.second.at(&t)},
+                      Eigen::Matrix3d{out.jacobians(i).at(&t)});
+    }
+}
+
+// Build with -fsanitize=thread to check this test for data races
+TEST(ConcurrentEvaluationTest, sharedGraphFromManyThreads) {
+    // A graph in which every node below the root is shared
+    const auto R1 = wave::RotationMd::Random();
+    const auto R2 = wave::RotationMd::Random();
+    const auto t = wave::Translationd::Random();
+    const auto shared = makeProxy(R1 * R2);
+    const auto doubled = makeProxy(shared * shared);
+    const auto expr = makeProxy(doubled * (shared * t));
+
+    // Evaluate once on this thread for reference
+    const auto expected = (R1 * R2 * R1 * R2 * R1 * R2 * t).eval();
+    const auto expected_jac = (R1 * R2 * R1 * R2 * R1 * R2 * t).jacobian(R1);
+
+    std::atomic<int> failures{0};
+    const auto check = [&](bool ok) {
+        if (!ok) {
+            ++failures;
+        }
+    };
+    auto threads = std::vector<std::thread>{};
+    for (int k = 0; k < 8; ++k) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 100; ++i) {
+                check(expected.isApprox(expr.eval()));
+                check(expected_jac.isApprox(expr.jacobian(R1)));
+                check(expected_jac.isApprox(
+                  wave::evaluateNumericalJacobian(expr, R1), 1e-6));
+
+                const auto reverse =
+                  wave::internal::evaluateWithDynamicReverseJacobians(expr);
+                check(expected.isApprox(reverse.first));
+                check(expected_jac.isApprox(Eigen::Matrix3d{reverse.second.at(&R1)}));
+
+                // A static expression over the shared nodes
+                const auto mixed = wave::internal::evaluateWithDynamicReverseJacobians(
+                  doubled * (shared * t));
+                check(expected.isApprox(mixed.first));
+                check(expected_jac.isApprox(Eigen::Matrix3d{mixed.second.at(&R1)}));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(0, failures.load());
+}
+
+namespace {
+// Builds a balanced tree of products over rotations [begin, end). Each bottom node also
+// uses another rotation, so leaves are shared between subtrees.
+wave::Proxy<wave::RotationMd> balancedProduct(const RotationVector &rotations,
+                                              std::size_t begin,
+                                              std::size_t end) {
+    if (end - begin == 1) {
+        const auto &other = rotations[(begin * 7 + 3) % rotations.size()];
+        return makeProxy(rotations[begin] * other);
+    }
+    const auto mid = (begin + end) / 2;
+    return makeProxy(balancedProduct(rotations, begin, mid) *
+                     balancedProduct(rotations, mid, end));
+}
+
+// Checks a parallel tape's value and Jacobians against those of the Proxy
+void checkParallelTape(wave::ParallelTape<wave::Translationd> &tape,
+                       const wave::Proxy<wave::Translationd> &expr,
+                       const RotationVector &rotations,
+                       const wave::Translationd &t) {
+    const auto expected = wave::internal::evaluateWithDynamicReverseJacobians(expr);
+    EXPECT_APPROX(expected.first, tape.evaluate());
+    const auto out = tape.evaluateWithJacobians();
+    EXPECT_APPROX(expected.first, out.first);
+    for (const auto &r : rotations) {
+        EXPECT_APPROX(Eigen::Matrix3d{expected.second.at(&r)},
+                      Eigen::Matrix3d{out.second.at(&r)});
+    }
+    EXPECT_APPROX(Eigen::Matrix3d{expected.second.at(&t)},
+                  Eigen::Matrix3d{out.second.at(&t)});
+}
+}  // namespace
+
+TEST(ParallelTapeTest, balancedTree) {
+    auto rotations = RotationVector(64);
+    for (auto &r : rotations) {
+        r = wave::RotationMd::Random();
+    }
+    const auto t = wave::Translationd::Random();
+    const auto expr = makeProxy(balancedProduct(rotations, 0, 64) * t);
+
+    for (const auto threads : {0u, 3u}) {
+        wave::ThreadPool pool{threads};
+        for (const auto threshold : {1u, 8u, 1000u}) {
+            auto tape = wave::compileParallel(pool, expr, threshold);
+            EXPECT_EQ(wave::compile(expr).size(), tape.size());
+            EXPECT_EQ(threshold < tape.size(), tape.numTasks() > 0);
+            checkParallelTape(tape, expr, rotations, t);
+
+            // Run again with new leaf values
+            rotations[5] = wave::RotationMd::Random();
+            checkParallelTape(tape, expr, rotations, t);
+        }
+    }
+}
+
+TEST(ParallelTapeTest, sharedSubtree) {
+    auto rotations = RotationVector(64);
+    for (auto &r : rotations) {
+        r = wave::RotationMd::Random();
+    }
+    const auto t = wave::Translationd::Random();
+    // The subtrees containing the shared node are not closed, but those inside it are
+    const auto shared = balancedProduct(rotations, 0, 16);
+    const auto left = makeProxy(balancedProduct(rotations, 16, 40) * shared);
+    const auto right = makeProxy(shared * balancedProduct(rotations, 40, 64));
+    const auto expr = makeProxy(makeProxy(left * right) * t);
+
+    wave::ThreadPool pool{3};
+    auto tape = wave::compileParallel(pool, expr, 4);
+    EXPECT_LT(0u, tape.numTasks());
+    checkParallelTape(tape, expr, rotations, t);
+}
@@ -0,0 +1,160 @@
+#include "wave/geometry/geometry.hpp"
+#include "test.hpp"
+
+/** Test that expressions are rewritten to the expected types before evaluation, and that
+ * values and Jacobians are unchanged by the rewrite.
+ */
+struct FrameA;
+struct FrameB;
+struct FrameC;
+struct FrameD;
+
+using namespace wave;
+
+template <typename Expr, typename Goal = internal::rewrite_for_value>
+using rewrite_t = internal::rewrite_t<Expr, Goal>;
+
+template <typename Expr>
+using rewrite_for_jacobians_t = rewrite_t<Expr, internal::rewrite_for_jacobians>;
+
+TEST(RewriteTest, doubleInverse) {
+    const auto q = RotationQFd<FrameA, FrameB>::Random();
+    const auto &expr = inverse(inverse(q));
+
+    static_assert(std::is_same<RotationQFd<FrameA, FrameB>, rewrite_t<decltype(expr)>>{},
+                  "");
+    EXPECT_APPROX(q, expr.eval());
+    CHECK_JACOBIANS(true, expr, q);
+}
+
+TEST(RewriteTest, inverseOfCompose) {
+    const auto q1 = RotationQFd<FrameB, FrameA>::Random();
+    const auto q2 = RotationQFd<FrameC, FrameB>::Random();
+    const auto &expr = inverse(q1) * inverse(q2);
+
+    using Leaf1 = RotationQFd<FrameB, FrameA>;
+    using Leaf2 = RotationQFd<FrameC, FrameB>;
+    static_assert(std::is_same<Inverse<Compose<Leaf2 &, Leaf1 &>>,
+                               rewrite_t<decltype(expr)>>{},
+                  "");
+    EXPECT_APPROX(inverse(q2 * q1).eval(), expr.eval());
+    CHECK_JACOBIANS(true, expr, q1, q2);
+}
+
+TEST(RewriteTest, inverseOfComposeMixed) {
+    // No rule applies if the two sides are of different types
+    const auto q = RotationQd::Random();
+    const auto R = RotationMd::Random();
+    const auto &expr = inverse(q) * inverse(R);
+
+    static_assert(std::is_same<tmp::remove_cr_t<decltype(expr)>,
+                               rewrite_t<decltype(expr)>>{},
+                  "");
+    CHECK_JACOBIANS(true, expr, q, R);
+}
+
+TEST(RewriteTest, expOfLog) {
+    const auto R = RotationMFd<FrameA, FrameB>::Random();
+    const auto &expr = exp(log(R));
+
+    // The frames of the original expression are kept
+    using Expected = FrameCast<FrameA, FrameA, RotationMFd<FrameA, FrameB> &>;
+    static_assert(std::is_same<Expected, rewrite_t<decltype(expr)>>{}, "");
+    static_assert(std::is_same<RotationMFd<FrameA, FrameA>,
+                               internal::plain_output_t<decltype(expr)>>{},
+                  "");
+    EXPECT_APPROX(R.value(), expr.eval().value());
+    CHECK_JACOBIANS(true, expr, R);
+}
+
+TEST(RewriteTest, rotateReassociateMatrix) {
+    const auto R1 = RotationMFd<FrameA, FrameB>::Random();
+    const auto R2 = RotationMFd<FrameB, FrameC>::Random();
+    const auto v = TranslationFd<FrameC, FrameC, FrameC>::Random();
+    const auto &expr = R1 * R2 * v;
+
+    using Leaf1 = RotationMFd<FrameA, FrameB>;
+    using Leaf2 = RotationMFd<FrameB, FrameC>;
+    using Leaf3 = TranslationFd<FrameC, FrameC, FrameC>;
+    static_assert(std::is_same<Rotate<Leaf1 &, Rotate<Leaf2 &, Leaf3 &>>,
+                               rewrite_t<decltype(expr)>>{},
+                  "");
+    // The composition is kept when Jacobians are needed
+    static_assert(std::is_same<tmp::remove_cr_t<decltype(expr)>,
+                               rewrite_for_jacobians_t<decltype(expr)>>{},
+                  "");
+    EXPECT_APPROX((R1 * (R2 * v)).eval(), expr.eval());
+    CHECK_JACOBIANS(true, expr, R1, R2, v);
+}
+
+TEST(RewriteTest, rotateNoReassociateQuaternion) {
+    // Composing quaternions is cheaper than rotating a vector, so no rule applies
+    const auto q1 = RotationQd::Random();
+    const auto q2 = RotationQd::Random();
+    const auto v = Translationd::Random();
+    const auto &expr = q1 * q2 * v;
+
+    static_assert(std::is_same<tmp::remove_cr_t<decltype(expr)>,
+                               rewrite_t<decltype(expr)>>{},
+                  "");
+}
+
+TEST(RewriteTest, rotateReassociateMixed) {
+    // Rotating by each is cheaper than converting the quaternion to compose with a matrix
+    const auto q = RotationQFd<FrameA, FrameB>::Random();
+    const auto R = RotationMFd<FrameB, FrameC>::Random();
+    const auto v = TranslationFd<FrameC, FrameC, FrameC>::Random();
+    const auto &expr = q * R * v;
+
+    using Leaf1 = RotationQFd<FrameA, FrameB>;
+    using Leaf2 = RotationMFd<FrameB, FrameC>;
+    using Leaf3 = TranslationFd<FrameC, FrameC, FrameC>;
+    static_assert(std::is_same<Rotate<Leaf1 &, Rotate<Leaf2 &, Leaf3 &>>,
+                               rewrite_t<decltype(expr)>>{},
+                  "");
+    EXPECT_APPROX((q * (R * v)).eval(), expr.eval());
+    CHECK_JACOBIANS(true, expr, q, R, v);
+}
+
+TEST(RewriteTest, rotateChainRightToLeft) {
+    const auto R1 = RotationMFd<FrameA, FrameB>::Random();
+    const auto R2 = RotationMFd<FrameB, FrameC>::Random();
+    const auto R3 = RotationMFd<FrameC, FrameD>::Random();
+    const auto v = TranslationFd<FrameD, FrameD, FrameD>::Random();
+    const auto &expr = R1 * R2 * R3 * v;
+
+    using Leaf1 = RotationMFd<FrameA, FrameB>;
+    using Leaf2 = RotationMFd<FrameB, FrameC>;
+    using Leaf3 = RotationMFd<FrameC, FrameD>;
+    using Leaf4 = TranslationFd<FrameD, FrameD, FrameD>;
+    using Expected = Rotate<Leaf1 &, Rotate<Leaf2 &, Rotate<Leaf3 &, Leaf4 &>>>;
+    static_assert(std::is_same<Expected, rewrite_t<decltype(expr)>>{}, "");
+    static_assert(std::is_same<tmp::remove_cr_t<decltype(expr)>,
+                               rewrite_for_jacobians_t<decltype(expr)>>{},
+                  "");
+    EXPECT_APPROX((R1 * (R2 * (R3 * v))).eval(), expr.eval());
+    CHECK_JACOBIANS(true, expr, R1, R2, R3, v);
+}
+
+TEST(RewriteTest, nestedRules) {
+    // Rules apply to the result of other rules
+    const auto q1 = RotationQFd<FrameB, FrameA>::Random();
+    const auto q2 = RotationQFd<FrameC, FrameB>::Random();
+    const auto &expr = inverse(inverse(q1) * inverse(q2));
+
+    using Leaf1 = RotationQFd<FrameB, FrameA>;
+    using Leaf2 = RotationQFd<FrameC, FrameB>;
+    static_assert(std::is_same<Compose<Leaf2 &, Leaf1 &>,
+                               rewrite_t<decltype(expr)>>{},
+                  "");
+    EXPECT_APPROX((q2 * q1).eval(), expr.eval());
+    CHECK_JACOBIANS(true, expr, q1, q2);
+}
+
+TEST(RewriteTest, jacobianOfRewritten) {
+    // Single-Jacobian evaluation also works on the rewritten expression
+    const auto q = RotationQd::Random();
+    const auto &expr = inverse(inverse(q));
+
+    EXPECT_PRED1(IsIdentity, expr.jacobian(q));
+}
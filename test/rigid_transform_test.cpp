@@ -56,7 +56,9 @@ class RigidTransformTest : public testing::Test {
 };
 
 // The list of implementation types to run each test case on
-using LeafTypes = test_types_list<wave::RigidTransformMd, wave::RigidTransformQd>;
+using LeafTypes = test_types_list<wave::RigidTransformMd,
+                                  wave::RigidTransformM34d,
+                                  wave::RigidTransformQd>;
 
 // The following tests will be built for each type in LeafTypes
 TYPED_TEST_CASE(RigidTransformTest, LeafTypes);
@@ -171,3 +173,120 @@ TYPED_TEST(RigidTransformTest, transformVector) {
 
     CHECK_JACOBIANS(true, rt * p1, rt, p1);
 }
+
+// Exp map of a twist evaluated directly to a CompactRigidTransform
+
+TEST(RigidTransformMiscTest, expMapToCompact) {
+    // Converting an exp map to a compact transform is rewritten to evaluate it directly
+    using Converted = wave::Convert<wave::RigidTransformQd, wave::ExpMap<wave::Twistd &>>;
+    using Rewritten = wave::internal::rewrite_t<Converted, wave::internal::rewrite_for_value>;
+    static_assert(
+      std::is_same<wave::ExpMapTo<wave::RigidTransformQd, wave::Twistd &>, Rewritten>{}, "");
+
+    const Eigen::Vector3d axis = Eigen::Vector3d::Random().normalized();
+    const Eigen::Vector3d u = Eigen::Vector3d::Random();
+    for (const auto angle : {1e-10, 1e-5, 0.5, 3.0}) {
+        SCOPED_TRACE(angle);
+        const auto xi = wave::Twistd{angle * axis, u};
+        const wave::RigidTransformQd result{exp(xi)};
+        const wave::RigidTransformMd expected{exp(xi)};
+        EXPECT_APPROX(expected.rotation().value(),
+                      result.rotation().value().toRotationMatrix());
+        EXPECT_APPROX(expected.translation().value(), result.translation().value());
+
+        const auto &expr = wave::ExpMapTo<wave::RigidTransformQd, const wave::Twistd &>{xi};
+        EXPECT_APPROX(result.value(), expr.eval().value());
+        CHECK_JACOBIANS(true, expr, xi);
+        // The numerical Jacobian through a rotation matrix is not reliable near zero
+        if (angle > 0.1) {
+            CHECK_JACOBIANS(true, exp(xi), xi);
+        }
+    }
+}
+
+TEST(RigidTransformMiscTest, boxPlusCompact) {
+    // The planner evaluates the exp map straight to the type it is composed with
+    const auto T = wave::RigidTransformQd::Random();
+    const auto xi = wave::Twistd::Random();
+    const auto &expr = T + xi;
+    using Prepared = typename wave::internal::traits<
+      wave::tmp::remove_cr_t<decltype(expr)>>::PreparedType;
+    using Exp = wave::ExpMapTo<wave::RigidTransformQd, wave::Twistd &>;
+    static_assert(
+      std::is_same<wave::ComposeFlipped<wave::RigidTransformQd &, Exp &&> &&, Prepared>{},
+      "");
+
+    const wave::RigidTransformMd expected{wave::RigidTransformMd{exp(xi)} * T};
+    const wave::RigidTransformQd result{expr};
+    EXPECT_APPROX(expected.rotation().value(),
+                  result.rotation().value().toRotationMatrix());
+    EXPECT_APPROX(expected.translation().value(), result.translation().value());
+    CHECK_JACOBIANS(true, expr, T, xi);
+}
+
+TEST(RigidTransformMiscTest, compactKernels) {
+    // Compose, inverse and transform of compact transforms, including mapped storage,
+    // agree with matrix transforms
+    Eigen::Matrix<double, 7, 1> storage = wave::RigidTransformQd::Random().value();
+    const wave::CompactRigidTransform<Eigen::Map<Eigen::Matrix<double, 7, 1>>> T1{
+      Eigen::Map<Eigen::Matrix<double, 7, 1>>{storage.data()}};
+    const auto T2 = wave::RigidTransformQd::Random();
+    const auto p = wave::Translationd::Random();
+    const auto M1 = wave::RigidTransformMd{T1.rotation(), T1.translation()};
+    const auto M2 = wave::RigidTransformMd{T2.rotation(), T2.translation()};
+
+    const auto &expr = inverse(T1) * T2 * p;
+    static_assert(std::is_same<wave::Translationd, wave::internal::eval_t<decltype(expr)>>{},
+                  "");
+    EXPECT_APPROX((inverse(M1) * M2 * p).eval(), expr.eval());
+    const wave::RigidTransformMd composed{T1 * inverse(T2)};
+    EXPECT_APPROX((M1 * inverse(M2)).eval(), composed);
+    CHECK_JACOBIANS(true, expr, T1, T2, p);
+    CHECK_JACOBIANS(true, T1 * inverse(T2), T1, T2);
+}
+
+TEST(RigidTransformMiscTest, matrix34Kernels) {
+    // Transforms with 3x4 storage, including mapped storage, agree with 4x4 transforms
+    static_assert(sizeof(wave::RigidTransformM34d) == 12 * sizeof(double), "");
+    Eigen::Matrix<double, 3, 4> storage = wave::RigidTransformM34d::Random().value();
+    const wave::MatrixRigidTransform<Eigen::Map<Eigen::Matrix<double, 3, 4>>> T1{
+      Eigen::Map<Eigen::Matrix<double, 3, 4>>{storage.data()}};
+    const auto T2 = wave::RigidTransformM34d::Random();
+    const auto p = wave::Translationd::Random();
+    const auto M1 = wave::RigidTransformMd{T1.rotation(), T1.translation()};
+    const auto M2 = wave::RigidTransformMd{T2.rotation(), T2.translation()};
+
+    const auto &expr = inverse(T1) * T2 * p;
+    EXPECT_APPROX((inverse(M1) * M2 * p).eval(), expr.eval());
+    const wave::RigidTransformM34d composed{T1 * inverse(T2)};
+    EXPECT_APPROX((M1 * inverse(M2)).eval().value().topRows<3>(), composed.value());
+    CHECK_JACOBIANS(true, expr, T1, T2, p);
+    CHECK_JACOBIANS(true, T1 * inverse(T2), T1, T2);
+
+    // Conversions to and from 4x4 and compact storage
+    const wave::RigidTransformMd M{T2};
+    EXPECT_APPROX(M2, M);
+    EXPECT_APPROX(T2, wave::RigidTransformM34d{M});
+    EXPECT_APPROX(T2, wave::RigidTransformM34d{wave::RigidTransformQd{T2}});
+    const wave::RigidTransformMd mixed{M1 * T2};
+    EXPECT_APPROX((M1 * M2).eval(), mixed);
+}
+
+TEST(RigidTransformMiscTest, expMapToMatrix34) {
+    // Converting an exp map to 3x4 storage is rewritten to evaluate it directly
+    using Converted = wave::Convert<wave::RigidTransformM34d, wave::ExpMap<wave::Twistd &>>;
+    using Rewritten = wave::internal::rewrite_t<Converted, wave::internal::rewrite_for_value>;
+    static_assert(
+      std::is_same<wave::ExpMapTo<wave::RigidTransformM34d, wave::Twistd &>, Rewritten>{},
+      "");
+
+    const auto xi = wave::Twistd::Random();
+    const wave::RigidTransformM34d result{exp(xi)};
+    const wave::RigidTransformMd expected{exp(xi)};
+    EXPECT_APPROX(expected.value().topRows<3>(), result.value());
+    EXPECT_APPROX(xi, log(result));
+
+    const auto &expr = wave::ExpMapTo<wave::RigidTransformM34d, const wave::Twistd &>{xi};
+    EXPECT_APPROX(result, expr.eval());
+    CHECK_JACOBIANS(true, expr, xi);
+}
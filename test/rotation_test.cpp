@@ -122,6 +122,45 @@ TYPED_TEST(RotationTest, rotateVector) {
     CHECK_JACOBIANS(true, r1 * p1, r1, p1);
 }
 
+TYPED_TEST(RotationTest, adjointJacobians) {
+    const auto r1 = TestFixture::LeafBA::Random();
+    const auto p1 = TestFixture::PointAAB::Random();
+    const auto expected = (r1 * p1).evalWithJacobians();
+
+    // The reverse pass seeded with an adjoint gives its products with the Jacobians
+    using Weight = Eigen::Matrix<typename TestFixture::Scalar, 2, 3>;
+    const Weight w = Weight::Random();
+    const auto weighted = (r1 * p1).evalWithAdjointJacobians(w);
+    EXPECT_APPROX(std::get<0>(expected), std::get<0>(weighted));
+    EXPECT_APPROX(w * std::get<1>(expected), std::get<1>(weighted));
+    EXPECT_APPROX(w * std::get<2>(expected), std::get<2>(weighted));
+
+    // The adjoint's height may be dynamic
+    using DynamicAdjoint = Eigen::Matrix<typename TestFixture::Scalar, Eigen::Dynamic, 3>;
+    const DynamicAdjoint v = DynamicAdjoint::Random(4, 3);
+    const auto dynamic = wave::internal::evaluateWithReverseJacobians(r1 * p1, v);
+    EXPECT_APPROX(v * std::get<1>(expected), std::get<1>(dynamic));
+    EXPECT_APPROX(v * std::get<2>(expected), std::get<2>(dynamic));
+}
+
+TYPED_TEST(RotationTest, stackedJacobians) {
+    const auto r1 = TestFixture::LeafBA::Random();
+    const auto r2 = TestFixture::LeafBA::Random();
+    const auto r3 = TestFixture::LeafBA::Random();
+    const auto p1 = TestFixture::PointAAB::Random();
+    // Two leaves of the same type, so they are told apart by address
+    const auto expr = inverse(r2) * (r1 * p1);
+
+    // Targets may repeat, or not be in the expression at all
+    const auto result = wave::internal::evaluateWithStackedJacobians(expr, r1, p1, r1, r2, r3);
+    EXPECT_APPROX(expr.eval(), std::get<0>(result));
+    EXPECT_APPROX(wave::internal::evaluateJacobian(expr, r1), std::get<1>(result));
+    EXPECT_APPROX(wave::internal::evaluateJacobian(expr, p1), std::get<2>(result));
+    EXPECT_APPROX(std::get<1>(result), std::get<3>(result));
+    EXPECT_APPROX(wave::internal::evaluateJacobian(expr, r2), std::get<4>(result));
+    EXPECT_TRUE(std::get<5>(result).isZero());
+}
+
 TYPED_TEST(RotationTest, inverse) {
     const auto r1 = TestFixture::LeafAB::Random();
     const auto r2 = typename TestFixture::LeafBA{inverse(r1)};
@@ -219,3 +258,74 @@ TEST(RotationMiscTest, constructRotationMMap) {
     EXPECT_APPROX(m, r.value());
     EXPECT_EQ(m.data(), r.value().data());
 }
+
+// Log and exp maps evaluated directly on quaternions, without a rotation matrix
+
+/** Quaternions of angles near zero, moderate and near pi about a random axis */
+std::vector<std::pair<double, Eigen::Vector3d>> quaternionTestAngles() {
+    const Eigen::Vector3d axis = Eigen::Vector3d::Random().normalized();
+    return {{1e-10, axis}, {1e-5, axis}, {0.5, axis}, {M_PI - 1e-7, axis}};
+}
+
+TEST(RotationMiscTest, logMapQuaternion) {
+    // The log map is evaluated on the quaternion, not converted to a matrix
+    using Prepared =
+      typename wave::internal::traits<decltype(log(wave::RotationQd{}))>::PreparedType;
+    static_assert(
+      std::is_same<wave::LogMap<wave::NoFrame, wave::RotationQd &> &&, Prepared>{}, "");
+
+    for (const auto &angle_axis : quaternionTestAngles()) {
+        const auto angle = angle_axis.first;
+        const Eigen::Quaterniond q{Eigen::AngleAxisd{angle, angle_axis.second}};
+        const auto r = wave::RotationQd{q};
+        const Eigen::Vector3d expected = angle * angle_axis.second;
+        EXPECT_APPROX(expected, log(r).eval().value());
+
+        // q and -q are the same rotation. The one with w < 0 gives the same log
+        const auto r_neg = wave::RotationQd{Eigen::Quaterniond{-q.coeffs()}};
+        ASSERT_LT(r_neg.value().w(), 0.0);
+        EXPECT_APPROX(expected, log(r_neg).eval().value());
+
+        // Numerical Jacobians are not reliable where the log wraps around at pi
+        if (angle < 1.0) {
+            CHECK_JACOBIANS(true, log(r), r);
+            CHECK_JACOBIANS(true, log(r_neg), r_neg);
+        }
+    }
+}
+
+TEST(RotationMiscTest, expMapToQuaternion) {
+    // Converting an exp map to a quaternion is rewritten to evaluate it directly
+    using Rel = wave::RelativeRotationd;
+    using Converted = wave::Convert<wave::RotationQd, wave::ExpMap<Rel &>>;
+    using Rewritten = wave::internal::rewrite_t<Converted, wave::internal::rewrite_for_value>;
+    static_assert(std::is_same<wave::ExpMapTo<wave::RotationQd, Rel &>, Rewritten>{}, "");
+
+    for (const auto &angle_axis : quaternionTestAngles()) {
+        const auto phi = Rel{angle_axis.first * angle_axis.second};
+        const wave::RotationQd r{exp(phi)};
+        const Eigen::Matrix3d expected =
+          Eigen::AngleAxisd{angle_axis.first, angle_axis.second}.toRotationMatrix();
+        EXPECT_APPROX(expected, r.value().toRotationMatrix());
+
+        const auto &expr = wave::ExpMapTo<wave::RotationQd, const Rel &>{phi};
+        EXPECT_APPROX(expected, expr.eval().value().toRotationMatrix());
+        CHECK_JACOBIANS(true, expr, phi);
+    }
+}
+
+TEST(RotationMiscTest, expMapInQuaternionExpression) {
+    // Within a quaternion expression, the exp map is evaluated straight to a quaternion
+    const auto q = wave::RotationQd::Random();
+    const auto phi = wave::RelativeRotationd::Random();
+    const auto &expr = q * exp(phi);
+    using Prepared = typename wave::internal::traits<
+      wave::tmp::remove_cr_t<decltype(expr)>>::PreparedType;
+    using Exp = wave::ExpMapTo<wave::RotationQd, wave::RelativeRotationd &>;
+    static_assert(std::is_same<wave::Compose<wave::RotationQd &, Exp &&> &&, Prepared>{},
+                  "");
+
+    const Eigen::Matrix3d expected = q.value().toRotationMatrix() * exp(phi).eval().value();
+    EXPECT_APPROX(expected, expr.eval().value().toRotationMatrix());
+    CHECK_JACOBIANS(true, expr, q, phi);
+}
@@ -198,6 +198,19 @@ void checkValueAndJacobiansUntyped(const std::tuple<Value, Jacobians...> &ref,
     (void) foreach;
 }
 
+/** Compares the value and Jacobians from one more evaluator to the reference */
+template <typename Value, typename... Jacobians, int... I>
+void checkValueAndJacobiansOf(const std::tuple<Value, Jacobians...> &ref,
+                              const std::tuple<Value, Jacobians...> &result,
+                              const std::string &name,
+                              wave::tmp::index_sequence<I...>) {
+    EXPECT_APPROX(std::get<0>(ref), std::get<0>(result));
+    int foreach[] = {
+      (checkJacobian(std::get<I>(ref), std::get<I>(result), name + std::to_string(I)),
+       0)...};
+    (void) foreach;
+}
+
 template <typename... T>
 void printTupleTypes(const std::string &msg, const std::tuple<T...> &, int n_jacobians) {
     ASSERT_EQ(n_jacobians, sizeof...(T)) << "In " << msg << " results";
@@ -228,6 +241,50 @@ void checkValueAndJacobians(const Ref &ref,
     FAIL();
 }
 
+/** Checks the directional derivative along fixed tangents of all targets against the
+ * product of the reference Jacobians and the same tangents
+ *
+ * The tangents are not random, so the values drawn by later checks do not change. They
+ * differ in scale, so terms for different targets do not cancel out.
+ *
+ * @tparam I the indices of the Jacobians in the reference tuple
+ */
+template <typename Expr, typename Ref, int... I, typename... Wrt>
+void checkDirectionalDerivative(const Expr &expr,
+                                const Ref &ref,
+                                wave::tmp::index_sequence<I...>,
+                                const Wrt &... wrt) {
+    const auto perturbations = std::make_tuple(wave::perturb(
+      wrt, wave::Perturbation<Wrt>::Tangent::LinSpaced(I, 2 * I).eval())...);
+    const auto result = expr.evalWithDirectionalDerivative(std::get<I - 1>(perturbations)...);
+
+    auto expected = decltype(result.second)::Zero().eval();
+    int foreach[] = {
+      (expected += std::get<I>(ref) * std::get<I - 1>(perturbations).delta, 0)...};
+    (void) foreach;
+    EXPECT_APPROX(std::get<0>(ref), result.first);
+    checkJacobian(expected, result.second, "Directional derivative");
+}
+
+/** Checks the directional derivative along each target separately
+ *
+ * Use this version when one target may be part of another (e.g., nested proxies), and
+ * perturbing both at once is not the sum of the separate derivatives.
+ */
+template <typename Expr, typename Ref, int... I, typename... Wrt>
+void checkEachDirectionalDerivative(const Expr &expr,
+                                    const Ref &ref,
+                                    wave::tmp::index_sequence<I...>,
+                                    const Wrt &... wrt) {
+    int foreach[] = {(checkDirectionalDerivative(expr,
+                                                 std::make_tuple(std::get<0>(ref),
+                                                                 std::get<I>(ref)),
+                                                 wave::tmp::index_sequence<1>{},
+                                                 wrt),
+                      0)...};
+    (void) foreach;
+}
+
 /** Evaluate multiple Jacobians of wave expression in forward and reverse mode and (todo)
  * compare them to numerical.
  *
@@ -237,6 +294,7 @@ void checkValueAndJacobians(const Ref &ref,
  * 2. Forward untyped
  * 3. Forward typed
  * 4. Reverse (if the expression tree has unique types)
+ * 5. Reverse for the given Wrt..., and the mode evalWithJacobians(wrt...) selects
  *
  * Since Reverse evaluator currently returns Jacobian wrt *all* leaves with no way of
  * disabling any, for the purposes of this test function the arguments Wrt... must be
@@ -265,10 +323,14 @@ std::enable_if_t<UniqueExpr> checkJacobians(const Expr &expr, const Wrt &... wrt
     const auto &forward_untyped = wave::internal::evaluateWithJacobians(expr, wrt...);
     const auto &forward_typed = wave::internal::evaluateWithTypedJacobians(expr, wrt...);
     const auto &reverse = expr.evalWithJacobians();
+    const auto &reverse_wrt = wave::internal::evaluateWithJacobiansInMode<
+      wave::internal::JacobianMode::Reverse>(expr, wrt...);
+    const auto &automatic = expr.evalWithJacobians(wrt...);
     const auto &reverse_dynamic =
       wave::internal::evaluateWithDynamicReverseJacobians(expr);
     const auto wrt_addresses = std::array<const void *, sizeof...(Wrt)>{{&wrt...}};
     const auto &jac_indices = wave::tmp::make_index_sequence<sizeof...(Wrt), 1>{};
+    checkDirectionalDerivative(expr, value_and_numerical, jac_indices, wrt...);
     checkValueAndJacobians(value_and_numerical,
                            forward_dynamic,
                            forward_untyped,
@@ -277,6 +339,8 @@ std::enable_if_t<UniqueExpr> checkJacobians(const Expr &expr, const Wrt &... wrt
                            reverse_dynamic,
                            wrt_addresses,
                            jac_indices);
+    checkValueAndJacobiansOf(value_and_numerical, reverse_wrt, "Reverse Wrt ", jac_indices);
+    checkValueAndJacobiansOf(value_and_numerical, automatic, "Automatic ", jac_indices);
 }
 
 // Version for non-unique expressions
@@ -291,6 +355,7 @@ std::enable_if_t<not UniqueExpr> checkJacobians(const Expr &expr, const Wrt &...
       wave::internal::evaluateWithDynamicJacobians(expr, wrt...);
     const auto &forward_untyped = expr.evalWithJacobians(wrt...);
     const auto &jac_indices = wave::tmp::make_index_sequence<sizeof...(Wrt), 1>{};
+    checkEachDirectionalDerivative(expr, value_and_numerical, jac_indices, wrt...);
     checkValueAndJacobiansUntyped(
       value_and_numerical, forward_dynamic, forward_untyped, jac_indices);
 }
@@ -0,0 +1,84 @@
+#include "wave/geometry/src/util/math/IdentityMatrix.hpp"
+#include "wave/geometry/src/util/math/AdjointMatrix.hpp"
+#include "../test.hpp"
+
+namespace {
+/** Returns the dense adjoint of a rigid transform with rotation R and translation t */
+Eigen::Matrix<double, 6, 6> manualAdjoint(const Eigen::Matrix3d &R,
+                                          const Eigen::Vector3d &t) {
+    Eigen::Matrix3d t_cross;
+    t_cross << 0, -t.z(), t.y(),  //
+      t.z(), 0, -t.x(),           //
+      -t.y(), t.x(), 0;
+    Eigen::Matrix<double, 6, 6> m;
+    m << R, Eigen::Matrix3d::Zero(), t_cross * R, R;
+    return m;
+}
+}  // namespace
+
+using Matrix6d = Eigen::Matrix<double, 6, 6>;
+
+class AdjointMatrixTest : public testing::Test {
+ protected:
+    const Eigen::Matrix3d R = Eigen::Quaterniond::UnitRandom().toRotationMatrix();
+    const Eigen::Vector3d t = Eigen::Vector3d::Random();
+    const wave::AdjointMatrix<double> adj{R, t};
+    const Matrix6d dense = manualAdjoint(R, t);
+};
+
+TEST_F(AdjointMatrixTest, evaluate) {
+    EXPECT_APPROX(dense, static_cast<const Matrix6d &>(adj));
+    EXPECT_APPROX(R, adj.rotationBlock());
+}
+
+TEST_F(AdjointMatrixTest, negate) {
+    const wave::AdjointMatrix<double> neg = -adj;
+    const Matrix6d expected = -dense;
+    EXPECT_APPROX(expected, static_cast<const Matrix6d &>(neg));
+
+    // The negative keeps its structure in products
+    const Eigen::Matrix<double, 2, 6> w = Eigen::Matrix<double, 2, 6>::Random();
+    const Eigen::Matrix<double, 2, 6> expected_product = w * expected;
+    EXPECT_APPROX(expected_product, w * neg);
+}
+
+TEST_F(AdjointMatrixTest, multiplyLeft) {
+    const Eigen::Matrix<double, 3, 6> w = Eigen::Matrix<double, 3, 6>::Random();
+    const Eigen::Matrix<double, 3, 6> expected = w * dense;
+    const auto &result = w * adj;
+    static_assert(
+      std::is_same<const Eigen::Matrix<double, 3, 6> &, decltype(result)>{}, "");
+    EXPECT_APPROX(expected, result);
+
+    // A row vector, and an expression
+    const Eigen::Matrix<double, 1, 6> v = w.row(0);
+    EXPECT_APPROX((v * dense).eval(), v * adj);
+    EXPECT_APPROX(((2 * w) * dense).eval(), (2 * w) * adj);
+}
+
+TEST_F(AdjointMatrixTest, multiplyRight) {
+    // Products on the right use the dense matrix
+    const Eigen::Matrix<double, 6, 4> x = Eigen::Matrix<double, 6, 4>::Random();
+    const Eigen::Matrix<double, 6, 4> expected = dense * x;
+    EXPECT_APPROX(expected, adj * x);
+
+    const Eigen::Matrix<double, 6, 1> v = x.col(0);
+    EXPECT_APPROX((dense * v).eval(), adj * v);
+}
+
+TEST_F(AdjointMatrixTest, multiplyDynamic) {
+    // Dynamic-size operands use the dense product
+    const Eigen::MatrixXd w = Eigen::MatrixXd::Random(2, 6);
+    EXPECT_APPROX((w * dense).eval(), (w * adj).eval());
+    EXPECT_APPROX((dense * w.transpose()).eval(), (adj * w.transpose()).eval());
+}
+
+TEST_F(AdjointMatrixTest, multiplyAdjointOrIdentity) {
+    const wave::AdjointMatrix<double> other{R.transpose(), -t};
+    const Matrix6d expected = dense * manualAdjoint(R.transpose(), -t);
+    EXPECT_APPROX(expected, adj * other);
+
+    const wave::IdentityMatrix<double, 6> eye{};
+    EXPECT_EQ(&adj, &(eye * adj));
+    EXPECT_EQ(&adj, &(adj * eye));
+}
@@ -0,0 +1,88 @@
+#include "wave/geometry/src/util/math/MatrixMap.hpp"
+#include "../test.hpp"
+
+namespace {
+using Leaves = std::vector<std::pair<int, int>>;
+}
+
+TEST(LeafRegistryTest, assignsIdsInKeyOrder) {
+    // Unsorted, with a duplicate
+    const auto leaves = Leaves{{30, 3}, {10, 1}, {20, 2}, {10, 1}};
+    auto ids = std::vector<int>{};
+    const auto registry = wave::LeafRegistry<int>{leaves.begin(), leaves.end(), &ids};
+
+    ASSERT_EQ(3, registry.size());
+    EXPECT_EQ(6, registry.cols());
+    EXPECT_EQ((std::vector<int>{2, 0, 1, 0}), ids);
+    EXPECT_EQ(10, registry.key(0));
+    EXPECT_EQ(30, registry.key(2));
+    EXPECT_EQ(1, registry.find(20));
+    EXPECT_EQ(-1, registry.find(25));
+    EXPECT_THROW(registry.id(25), std::out_of_range);
+
+    // Columns follow the order of the keys
+    EXPECT_EQ(0, registry.block(0).col_index);
+    EXPECT_EQ(1, registry.block(1).col_index);
+    EXPECT_EQ(3, registry.block(2).col_index);
+    EXPECT_EQ(3, registry.block(2).col_width);
+}
+
+TEST(MatrixMapTest, indexByKeyOrId) {
+    const auto leaves = Leaves{{30, 3}, {10, 1}, {20, 2}};
+    auto map = wave::MatrixMap<int, double>{leaves.begin(), leaves.end(), 2};
+    map.setZero();
+    map.at(30).setOnes();
+    map.block(map.registry().id(10)).setConstant(2.0);
+
+    EXPECT_EQ(1u, map.count(20));
+    EXPECT_EQ(0u, map.count(25));
+    EXPECT_APPROX(Eigen::MatrixXd::Ones(2, 3), Eigen::MatrixXd{map[30]});
+    EXPECT_APPROX(Eigen::Vector2d::Constant(2.0), Eigen::MatrixXd{map.block(0)});
+    EXPECT_EQ(0, map[25].cols());
+    EXPECT_THROW(map.at(25), std::out_of_range);
+}
+
+TEST(MatrixMapTest, visitInExpectedOrder) {
+    const auto leaves = Leaves{{30, 1}, {10, 1}, {20, 1}};
+    auto ids = std::vector<int>{};
+    auto map = wave::MatrixMap<int, double>{
+      wave::LeafRegistry<int>{leaves.begin(), leaves.end(), &ids}, 1};
+    map.expectVisits(ids);
+
+    EXPECT_EQ(2, map.visit(30));
+    EXPECT_EQ(0, map.visit(10));
+    // Out of order: looked up instead, without advancing
+    EXPECT_EQ(2, map.visit(30));
+    EXPECT_EQ(1, map.visit(20));
+    EXPECT_THROW(map.visit(25), std::out_of_range);
+
+    map.rewindVisits();
+    EXPECT_EQ(2, map.visit(30));
+}
+
+TEST(MatrixMapTest, assignReusesRegistry) {
+    const auto leaves = Leaves{{30, 3}, {10, 1}, {20, 2}, {10, 1}};
+    auto map = wave::MatrixMap<int, double>{};
+    map.assign(leaves.begin(), leaves.end(), 2);
+    EXPECT_EQ((std::vector<int>{2, 0, 1, 0}), map.elementIds());
+    EXPECT_TRUE(IsZero(Eigen::MatrixXd{map.at(30)}));
+    EXPECT_EQ(0, map.visit(10));
+
+    // The same leaves: storage is kept, zeroed, and visits start over
+    map.at(20).setOnes();
+    const auto *data = map.data();
+    map.assign(leaves.begin(), leaves.end(), 2);
+    EXPECT_EQ(data, map.data());
+    EXPECT_TRUE(IsZero(Eigen::MatrixXd{map.at(20)}));
+    EXPECT_EQ(2, map.visit(30));
+    EXPECT_EQ(0, map.visit(10));
+
+    // Other leaves: the registry is rebuilt
+    const auto other = Leaves{{10, 1}, {40, 3}};
+    map.assign(other.begin(), other.end(), 2);
+    EXPECT_EQ(2, map.registry().size());
+    EXPECT_EQ(0u, map.count(30));
+    EXPECT_EQ(2, map.at(10).rows());
+    EXPECT_EQ(3, map.at(40).cols());
+    EXPECT_TRUE(IsZero(Eigen::MatrixXd{map.at(40)}));
+}